@@ -26,6 +26,7 @@
 #include <core/dbus/announcer.h>
 #include <core/dbus/asio/executor.h>
 
+#include <future>
 #include <thread>
 
 namespace cul = com::ubuntu::location;
@@ -104,6 +105,8 @@ int main(int argc, char** argv)
     auto settings = std::make_shared<cul::BoostPtreeSettings>(options.value_for_key<std::string>("config-file"));
     auto engine = config.the_engine(std::set<cul::Provider::Ptr>{}, config.the_provider_selection_policy(), settings);
 
+    std::vector<std::future<void>> pending_provider_loads;
+
     for (const std::string& provider : selected_providers)
     {
         std::cout << "Instantiating and configuring: " << provider << std::endl;
@@ -132,7 +135,8 @@ int main(int argc, char** argv)
 
         try
         {
-            auto result = std::async(std::launch::async, [provider, config_lut, engine] {
+            // We keep the future around, its destructor would otherwise block until the provider is ready.
+            pending_provider_loads.push_back(std::async(std::launch::async, [provider, config_lut, engine] {
                 return cul::ProviderFactory::instance().create_provider_for_name_with_config(
                     provider,
                     config_lut.at(provider),
@@ -140,7 +144,7 @@ int main(int argc, char** argv)
                     {
                         engine->add_provider(provider);
                     });
-            });
+            }));
         } catch(const std::runtime_error& e)
         {
             std::cerr << "Exception instantiating provider: " << e.what() << " ... Aborting now." << std::endl;
@@ -34,6 +34,7 @@
 #include <core/dbus/codec.h>
 
 #include <sstream>
+#include <vector>
 
 namespace core
 {
@@ -353,6 +354,34 @@ struct Codec<std::map<com::ubuntu::location::SpaceVehicle::Key, com::ubuntu::loc
     }
 };
 
+template<>
+struct Codec<com::ubuntu::location::Criteria::Updates>
+{
+    typedef com::ubuntu::location::units::Quantity<com::ubuntu::location::units::Length> Displacement;
+
+    static void encode_argument(Message::Writer& writer, const com::ubuntu::location::Criteria::Updates& in)
+    {
+        bool has_interval{in.interval};
+        Codec<bool>::encode_argument(writer, has_interval);
+        if (has_interval)
+            Codec<std::int64_t>::encode_argument(writer, in.interval->count());
+
+        Codec<com::ubuntu::location::Optional<Displacement>>::encode_argument(writer, in.displacement);
+    }
+
+    static void decode_argument(Message::Reader& reader, com::ubuntu::location::Criteria::Updates& in)
+    {
+        bool has_interval{false};
+        Codec<bool>::decode_argument(reader, has_interval);
+        if (has_interval)
+            in.interval = std::chrono::milliseconds{reader.pop_int64()};
+        else
+            in.interval.reset();
+
+        Codec<com::ubuntu::location::Optional<Displacement>>::decode_argument(reader, in.displacement);
+    }
+};
+
 template<>
 struct Codec<com::ubuntu::location::Criteria>
 {
@@ -372,6 +401,8 @@ struct Codec<com::ubuntu::location::Criteria>
         Codec<com::ubuntu::location::Optional<VerticalAccuracy>>::encode_argument(writer, in.accuracy.vertical);
         Codec<com::ubuntu::location::Optional<VelocityAccuracy>>::encode_argument(writer, in.accuracy.velocity);
         Codec<com::ubuntu::location::Optional<HeadingAccuracy>>::encode_argument(writer, in.accuracy.heading);
+
+        Codec<com::ubuntu::location::Criteria::Updates>::encode_argument(writer, in.updates);
     }
 
     static void decode_argument(Message::Reader& reader, com::ubuntu::location::Criteria& in)
@@ -385,6 +416,10 @@ struct Codec<com::ubuntu::location::Criteria>
         Codec<com::ubuntu::location::Optional<VerticalAccuracy>>::decode_argument(reader, in.accuracy.vertical);
         Codec<com::ubuntu::location::Optional<VelocityAccuracy>>::decode_argument(reader, in.accuracy.velocity);
         Codec<com::ubuntu::location::Optional<HeadingAccuracy>>::decode_argument(reader, in.accuracy.heading);
+
+        // Clients predating update filters do not send them, we stay compatible.
+        if (reader.type() != ArgumentType::invalid)
+            Codec<com::ubuntu::location::Criteria::Updates>::decode_argument(reader, in.updates);
     }
 };
 
@@ -473,6 +508,73 @@ struct Codec<com::ubuntu::location::Update<T>>
         in.when = com::ubuntu::location::Clock::Timestamp(com::ubuntu::location::Clock::Duration(reader.pop_int64()));
     }    
 };
+
+namespace helper
+{
+template<typename T>
+struct TypeMapper<std::vector<com::ubuntu::location::Update<T>>>
+{
+    constexpr static ArgumentType type_value()
+    {
+        return ArgumentType::array;
+    }
+    constexpr static bool is_basic_type()
+    {
+        return false;
+    }
+    constexpr static bool requires_signature()
+    {
+        return true;
+    }
+
+    static std::string element_signature()
+    {
+        static const std::string s =
+                DBUS_STRUCT_BEGIN_CHAR_AS_STRING +
+                TypeMapper<com::ubuntu::location::Update<T>>::signature() +
+                DBUS_STRUCT_END_CHAR_AS_STRING;
+        return s;
+    }
+
+    static std::string signature()
+    {
+        static const std::string s = DBUS_TYPE_ARRAY_AS_STRING + element_signature();
+        return s;
+    }
+};
+}
+
+// Batches of updates are encoded as an array of structures, one per update.
+template<typename T>
+struct Codec<std::vector<com::ubuntu::location::Update<T>>>
+{
+    static void encode_argument(Message::Writer& writer, const std::vector<com::ubuntu::location::Update<T>>& in)
+    {
+        types::Signature signature(helper::TypeMapper<std::vector<com::ubuntu::location::Update<T>>>::element_signature());
+        auto sub = writer.open_array(signature);
+
+        for (const auto& update : in)
+        {
+            auto element = sub.open_structure();
+            Codec<com::ubuntu::location::Update<T>>::encode_argument(element, update);
+            sub.close_structure(std::move(element));
+        }
+
+        writer.close_array(std::move(sub));
+    }
+
+    static void decode_argument(Message::Reader& reader, std::vector<com::ubuntu::location::Update<T>>& out)
+    {
+        auto sub = reader.pop_array();
+        while (sub.type() != ArgumentType::invalid)
+        {
+            auto element = sub.pop_structure();
+            com::ubuntu::location::Update<T> update;
+            Codec<com::ubuntu::location::Update<T>>::decode_argument(element, update);
+            out.push_back(update);
+        }
+    }
+};
 }
 }
 
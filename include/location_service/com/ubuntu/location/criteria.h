@@ -21,6 +21,8 @@
 #include <com/ubuntu/location/optional.h>
 #include <com/ubuntu/location/units/units.h>
 
+#include <chrono>
+
 namespace com
 {
 namespace ubuntu
@@ -55,6 +57,15 @@ struct Criteria
         Optional<units::Quantity<units::Velocity>> velocity; ///< The client requires measurements of at least this velocity accuracy.
         Optional<units::Quantity<units::PlaneAngle>> heading; ///< The client requires measurements of at least this heading accuracy.
     } accuracy = Accuracy{};
+
+    struct Updates
+    {
+        bool operator==(const Updates& rhs) const;
+        bool operator!=(const Updates& rhs) const;
+
+        Optional<std::chrono::milliseconds> interval; ///< The client does not need updates more often than once per interval.
+        Optional<units::Quantity<units::Length>> displacement; ///< The client does not need position updates for movements smaller than this distance.
+    } updates = Updates{};
 };
 
 /**
@@ -30,6 +30,11 @@ class DefaultProviderSelectionPolicy : public ProviderSelectionPolicy
 {
 public:
     DefaultProviderSelectionPolicy();
+    /**
+     * @brief If hedge_position_updates is true and the selected position provider requires
+     * satellites, a provider not requiring satellites is selected as coarse position provider, too.
+     */
+    explicit DefaultProviderSelectionPolicy(bool hedge_position_updates);
     ~DefaultProviderSelectionPolicy() noexcept;
     
     ProviderSelection determine_provider_selection_for_criteria(
@@ -40,6 +45,11 @@ public:
         const Criteria& criteria,
         const ProviderEnumerator& enumerator);
 
+    Provider::Ptr determine_coarse_position_updates_provider(
+        const Criteria& criteria,
+        const ProviderEnumerator& enumerator,
+        const Provider::Ptr& position_updates_provider);
+
     Provider::Ptr determine_heading_updates_provider(
         const Criteria& criteria,
         const ProviderEnumerator& enumerator);
@@ -47,6 +57,9 @@ public:
     Provider::Ptr determine_velocity_updates_provider(
         const Criteria& criteria,
         const ProviderEnumerator& enumerator);
+
+private:
+    bool hedge_position_updates;
 };
 }
 }
@@ -48,11 +48,14 @@ public:
     void stop_heading_updates() override;
     void start_velocity_updates() override;
     void stop_velocity_updates() override;
+    void set_update_interval(const Optional<std::chrono::milliseconds>& interval) override;
 
 private:
     Optional<WithSource<Update<Position>>> last_position;
     std::set<Provider::Ptr> providers;
     std::vector<core::ScopedConnection> connections;
+    // The update interval we requested from all providers.
+    Optional<std::chrono::milliseconds> update_interval;
 };
 }
 }
@@ -30,7 +30,16 @@ namespace location
 // provider for higher quality position updates
 struct FusionProviderSelectionPolicy : public ProviderSelectionPolicy
 {
+    FusionProviderSelectionPolicy();
+    // If hedge_position_updates is true, providers not requiring satellites are fused
+    // separately and only bridge the time until the satellite-based providers deliver
+    // a sufficiently accurate fix.
+    explicit FusionProviderSelectionPolicy(bool hedge_position_updates);
+
     ProviderSelection determine_provider_selection_for_criteria(const Criteria &criteria, const ProviderEnumerator &enumerator);
+
+private:
+    bool hedge_position_updates;
 };
 }
 }
@@ -31,7 +31,11 @@
 
 #include <atomic>
 #include <bitset>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
 
 namespace com
 {
@@ -146,6 +150,31 @@ public:
          */
         bool are_velocity_updates_running() const;
 
+        /**
+         * @brief Requests updates at most once per interval. A zero interval asks for
+         * updates as often as the provider is able to deliver them. The provider is
+         * asked to run at the minimum interval across all outstanding requests.
+         */
+        virtual void request_update_interval(const std::chrono::milliseconds& interval);
+
+        /**
+         * @brief Withdraws a request previously made via request_update_interval.
+         */
+        virtual void release_update_interval(const std::chrono::milliseconds& interval);
+
+        /**
+         * @brief Requests next and withdraws previous, either one might be none.
+         *
+         * Helps providers relaying their own update interval to the providers they wrap.
+         */
+        void replace_update_interval(const Optional<std::chrono::milliseconds>& previous,
+                                     const Optional<std::chrono::milliseconds>& next);
+
+        /**
+         * @brief Returns the minimum interval across all outstanding requests, if any.
+         */
+        Optional<std::chrono::milliseconds> update_interval() const;
+
     protected:
         friend class Provider;
         explicit Controller(Provider& instance);
@@ -155,6 +184,8 @@ public:
         std::atomic<int> position_updates_counter;
         std::atomic<int> heading_updates_counter;
         std::atomic<int> velocity_updates_counter;
+        mutable std::mutex update_interval_guard;
+        std::multiset<std::chrono::milliseconds> update_interval_requests;
     };
 
     /**
@@ -170,6 +201,12 @@ public:
         core::Signal<Update<Velocity>> velocity;
         /** Space vehicle visibility updates. */
         core::Signal<Update<std::set<SpaceVehicle>>> svs;
+        /**
+         * Batches of position updates, ordered from oldest to newest. Sources that
+         * produce bursts of samples (e.g., chipsets batching fixes or replayed traces)
+         * hand them out in one go instead of emitting position once per sample.
+         */
+        core::Signal<std::vector<Update<Position>>> position_batch;
     };
 
     virtual ~Provider() = default;
@@ -188,6 +225,15 @@ public:
      */
     virtual const Controller::Ptr& state_controller() const;
 
+    /**
+     * @brief Whether the provider is able to deliver updates right now.
+     *
+     * Providers depending on external resources, e.g., a provider daemon running
+     * out of process, report false while those resources are gone. Providers are
+     * available by default.
+     */
+    virtual const core::Property<bool>& available() const;
+
     /**
      * @brief Checks if the provider supports a specific feature.
      * @param f Feature to test for
@@ -240,6 +286,8 @@ protected:
 
     virtual Updates& mutable_updates();
 
+    virtual core::Property<bool>& mutable_available();
+
     /**
      * @brief Implementation-specific, empty by default.
      */
@@ -270,6 +318,14 @@ protected:
      */
     virtual void stop_velocity_updates();
 
+    /**
+     * @brief Called whenever the minimum interval requested across all consumers changes.
+     * @param interval The minimum requested interval, or none if no consumer requested one.
+     *
+     * Implementation-specific, empty by default.
+     */
+    virtual void set_update_interval(const Optional<std::chrono::milliseconds>& interval);
+
 private:
     struct
     {
@@ -277,6 +333,7 @@ private:
         Requirements requirements = Requirements::none;
         Updates updates;
         Controller::Ptr controller = Controller::Ptr{};
+        core::Property<bool> available{true};
     } d;
 };
 
@@ -20,6 +20,7 @@
 
 #include <functional>
 #include <memory>
+#include <set>
 
 namespace com
 {
@@ -39,6 +40,21 @@ public:
 
     virtual void for_each_provider(const std::function<void(const std::shared_ptr<Provider>&)>&) const = 0;
 
+    // Returns a provider fusing the updates of all enumerated providers, shared by
+    // all callers. The default implementation does not offer one and returns nullptr.
+    virtual std::shared_ptr<Provider> shared_fusion_provider() const
+    {
+        return std::shared_ptr<Provider>{};
+    }
+
+    // Returns a provider fusing the updates of the given providers, shared by all
+    // callers asking for the same providers. The default implementation does not
+    // offer one and returns nullptr.
+    virtual std::shared_ptr<Provider> shared_fusion_provider_for(const std::set<std::shared_ptr<Provider>>&) const
+    {
+        return std::shared_ptr<Provider>{};
+    }
+
 protected:
     ProviderEnumerator() = default;
 };
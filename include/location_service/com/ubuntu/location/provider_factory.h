@@ -67,6 +67,10 @@ class ProviderFactory
     ProviderFactory(const ProviderFactory&) = delete;
     ProviderFactory& operator=(const ProviderFactory&) = delete;
 
+    // Returns a copy of the factory known for the given, potentially decorated name
+    // or an empty factory if no factory is known for the name.
+    Factory factory_for_name(const std::string& name);
+
     std::mutex guard;
     std::map<std::string, Factory> factory_store;
 };
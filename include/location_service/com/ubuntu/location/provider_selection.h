@@ -47,13 +47,19 @@ struct ProviderSelection
     std::shared_ptr<Provider> position_updates_provider;
     std::shared_ptr<Provider> heading_updates_provider;
     std::shared_ptr<Provider> velocity_updates_provider;
+    /**
+     * Optional, fast but coarse provider that is started alongside position_updates_provider,
+     * bridging the time until position_updates_provider delivers a sufficiently accurate fix.
+     */
+    std::shared_ptr<Provider> coarse_position_updates_provider;
 };
 
 inline bool operator==(const ProviderSelection& lhs, const ProviderSelection& rhs)
 {
     return lhs.position_updates_provider == rhs.position_updates_provider &&
             lhs.heading_updates_provider == rhs.heading_updates_provider &&
-            lhs.velocity_updates_provider == rhs.velocity_updates_provider;
+            lhs.velocity_updates_provider == rhs.velocity_updates_provider &&
+            lhs.coarse_position_updates_provider == rhs.coarse_position_updates_provider;
 }
 }
 }
@@ -25,14 +25,20 @@
 #include <core/dbus/signal.h>
 
 #include <core/dbus/traits/service.h>
+#include <core/dbus/types/unix_fd.h>
+#include <core/dbus/types/stl/tuple.h>
 
 #include <com/ubuntu/location/codec.h>
+#include <com/ubuntu/location/provider.h>
 #include <com/ubuntu/location/update.h>
 
 #include <com/ubuntu/location/heading.h>
 #include <com/ubuntu/location/position.h>
 #include <com/ubuntu/location/velocity.h>
 
+#include <tuple>
+#include <vector>
+
 namespace com
 {
 namespace ubuntu
@@ -51,6 +57,41 @@ struct Interface
         return s;
     }
 
+    // The features and requirements of a provider, as bitmasks.
+    typedef std::tuple
+    <
+        com::ubuntu::location::Provider::Features,
+        com::ubuntu::location::Provider::Requirements
+    > Capabilities;
+
+    struct Errors
+    {
+        struct OpeningSharedMemoryChannel
+        {
+            inline static std::string name()
+            {
+                return "com.ubuntu.remote.Service.Provider.Error.OpeningSharedMemoryChannel";
+            }
+        };
+    };
+
+    // Timestamped position, heading and velocity updates collected by the provider.
+    typedef std::tuple
+    <
+        std::vector<com::ubuntu::location::Update<com::ubuntu::location::Position>>,
+        std::vector<com::ubuntu::location::Update<com::ubuntu::location::Heading>>,
+        std::vector<com::ubuntu::location::Update<com::ubuntu::location::Velocity>>
+    > Batch;
+
+    // The file descriptors of a shared memory ring and of the eventfd signalling new records.
+    typedef std::tuple
+    <
+        core::dbus::types::UnixFileDescriptor,
+        core::dbus::types::UnixFileDescriptor
+    > SharedMemoryChannel;
+
+    // Returns all features and requirements of the provider in one go.
+    DBUS_CPP_METHOD_DEF(DescribeCapabilities, remote::Interface)
     // Checks if a provider satisfies a set of accuracy criteria.
     DBUS_CPP_METHOD_DEF(MatchesCriteria, remote::Interface)
     // Checks if the provider has got a specific requirement.
@@ -72,12 +113,27 @@ struct Interface
     DBUS_CPP_METHOD_DEF(StopHeadingUpdates, remote::Interface)
     DBUS_CPP_METHOD_DEF(StartVelocityUpdates, remote::Interface)
     DBUS_CPP_METHOD_DEF(StopVelocityUpdates, remote::Interface)
+    // Asks the provider to hand out updates via a shared memory ring with room for the given
+    // number of records, instead of the *Changed and UpdatesBatched signals. Returns the memfd
+    // backing the ring and an eventfd that is signalled whenever new records are available.
+    DBUS_CPP_METHOD_DEF(OpenSharedMemoryChannel, remote::Interface)
+    // Asks the provider to go back to handing out updates via signals.
+    DBUS_CPP_METHOD_DEF(CloseSharedMemoryChannel, remote::Interface)
+    // Called whenever the minimum update interval requested from the provider changes,
+    // handing the interval in [ms] or a negative value if no interval is requested anymore.
+    DBUS_CPP_METHOD_DEF(SetUpdateInterval, remote::Interface)
 
     struct Signals
     {
         DBUS_CPP_SIGNAL_DEF(PositionChanged, remote::Interface, com::ubuntu::location::Position)
         DBUS_CPP_SIGNAL_DEF(HeadingChanged, remote::Interface, com::ubuntu::location::Heading)
         DBUS_CPP_SIGNAL_DEF(VelocityChanged, remote::Interface, com::ubuntu::location::Velocity)
+        // Emitted whenever the capabilities of the provider might have changed,
+        // e.g., when the provider comes up.
+        DBUS_CPP_SIGNAL_DEF(CapabilitiesChanged, remote::Interface, Capabilities)
+        // Carries all updates collected since the last batch, ordered from oldest to newest.
+        // Replaces the individual *Changed signals above if batching is enabled.
+        DBUS_CPP_SIGNAL_DEF(UpdatesBatched, remote::Interface, Batch)
     };
 
     struct Properties
@@ -117,7 +173,9 @@ struct Interface
               {
                   object->get_signal<Signals::PositionChanged>(),
                   object->get_signal<Signals::HeadingChanged>(),
-                  object->get_signal<Signals::VelocityChanged>()
+                  object->get_signal<Signals::VelocityChanged>(),
+                  object->get_signal<Signals::CapabilitiesChanged>(),
+                  object->get_signal<Signals::UpdatesBatched>()
               }
         {
         }
@@ -155,6 +213,16 @@ struct Interface
                 Signals::VelocityChanged,
                 Signals::VelocityChanged::ArgumentType
             >> velocity_changed;
+
+            std::shared_ptr<core::dbus::Signal<
+                Signals::CapabilitiesChanged,
+                Signals::CapabilitiesChanged::ArgumentType
+            >> capabilities_changed;
+
+            std::shared_ptr<core::dbus::Signal<
+                Signals::UpdatesBatched,
+                Signals::UpdatesBatched::ArgumentType
+            >> updates_batched;
         } signals;
     };
 
@@ -181,7 +249,9 @@ struct Interface
               {
                   object->get_signal<Signals::PositionChanged>(),
                   object->get_signal<Signals::HeadingChanged>(),
-                  object->get_signal<Signals::VelocityChanged>()
+                  object->get_signal<Signals::VelocityChanged>(),
+                  object->get_signal<Signals::CapabilitiesChanged>(),
+                  object->get_signal<Signals::UpdatesBatched>()
               }
         {
         }
@@ -219,6 +289,16 @@ struct Interface
                 Signals::VelocityChanged,
                 Signals::VelocityChanged::ArgumentType
             >> velocity_changed;
+
+            std::shared_ptr<core::dbus::Signal<
+                Signals::CapabilitiesChanged,
+                Signals::CapabilitiesChanged::ArgumentType
+            >> capabilities_changed;
+
+            std::shared_ptr<core::dbus::Signal<
+                Signals::UpdatesBatched,
+                Signals::UpdatesBatched::ArgumentType
+            >> updates_batched;
         } signals;
     };
 
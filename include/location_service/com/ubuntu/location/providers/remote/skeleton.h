@@ -20,6 +20,8 @@
 
 #include <com/ubuntu/location/provider.h>
 
+#include <chrono>
+
 namespace core { namespace dbus {
 class Bus;
 class Object;
@@ -46,6 +48,18 @@ struct Configuration
     std::shared_ptr<core::dbus::Bus> bus;
     /** @brief The actual provider implementation. */
     Provider::Ptr provider;
+    /**
+     * @brief Controls how updates are coalesced before being sent to the remote end.
+     *
+     * Batching is disabled by default, with every update being sent as an individual signal.
+     */
+    struct Batching
+    {
+        /** @brief Updates are held back for at most this long, zero disables batching. */
+        std::chrono::milliseconds flush_interval{0};
+        /** @brief A batch is flushed as soon as it contains this many updates. */
+        std::size_t max_size{16};
+    } batching;
 };
 
 /** @brief Create a stub instance referring to a remote provider instance. */
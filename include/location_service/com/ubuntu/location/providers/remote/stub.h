@@ -42,6 +42,16 @@ struct Configuration
 {
     /** @brief Remote object implementing remote::Interface. */
     std::shared_ptr<core::dbus::Object> object;
+    /**
+     * @brief Controls receiving updates via a ring in shared memory instead of via the bus.
+     *
+     * Remote ends lacking support for shared memory keep on handing out updates via the bus.
+     */
+    struct SharedMemory
+    {
+        /** @brief The number of records the ring has room for, zero disables shared memory. */
+        std::size_t capacity{0};
+    } shared_memory;
 };
 
 /** @brief Create a stub instance referring to a remote provider instance. */
@@ -18,11 +18,15 @@
 #ifndef LOCATION_SERVICE_COM_UBUNTU_LOCATION_PROXY_PROVIDER_H_
 #define LOCATION_SERVICE_COM_UBUNTU_LOCATION_PROXY_PROVIDER_H_
 
+#include <com/ubuntu/location/criteria.h>
 #include <com/ubuntu/location/provider.h>
 #include <com/ubuntu/location/provider_selection_policy.h>
+#include <com/ubuntu/location/units/units.h>
 
+#include <atomic>
 #include <bitset>
 #include <memory>
+#include <vector>
 
 namespace com
 {
@@ -35,9 +39,21 @@ class ProxyProvider : public Provider
 public:
     typedef std::shared_ptr<ProxyProvider> Ptr;
 
+    /**
+     * @brief Creates a proxy that never hedges position updates, as it cannot tell
+     * when the position provider is accurate enough without the session's criteria.
+     */
     ProxyProvider(const ProviderSelection& selection);
+    /**
+     * @brief Creates a proxy that hedges position updates if the selection contains a coarse
+     * position provider. The coarse provider is started alongside the position provider and
+     * stopped once the position provider delivers a fix satisfying the horizontal accuracy
+     * requested in criteria.
+     */
+    ProxyProvider(const ProviderSelection& selection, const Criteria& criteria);
     ~ProxyProvider() noexcept;
 
+    // Starts the coarse position provider alongside the position provider, if selected.
     virtual void start_position_updates();
     virtual void stop_position_updates();
 
@@ -46,15 +62,30 @@ public:
 
     virtual void start_heading_updates();
     virtual void stop_heading_updates();
+
+    // Relays the interval to all selected providers.
+    virtual void set_update_interval(const Optional<std::chrono::milliseconds>& interval);
     
 private:
+    // Stops the coarse position provider if we are still hedging.
+    void stop_hedging();
+
     ProviderSelection providers;
+    // Fixes of the position provider at least this accurate end hedging.
+    units::Quantity<units::Length> target_accuracy;
+    // True while the coarse position provider runs alongside the position provider.
+    std::atomic<bool> hedging{false};
+    // The update interval we requested from the selected providers.
+    Optional<std::chrono::milliseconds> update_interval;
 
     struct
     {
         core::ScopedConnection position_updates;
         core::ScopedConnection heading_updates;
         core::ScopedConnection velocity_updates;
+        core::ScopedConnection position_batch_updates;
+        // Empty without a coarse position provider.
+        std::vector<core::ScopedConnection> coarse_position_updates;
     } connections;
 };
 }
@@ -0,0 +1,108 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_CACHING_PERMISSION_MANAGER_H_
+#define LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_CACHING_PERMISSION_MANAGER_H_
+
+#include <com/ubuntu/location/optional.h>
+#include <com/ubuntu/location/service/permission_manager.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace com
+{
+namespace ubuntu
+{
+namespace location
+{
+namespace service
+{
+// A PermissionManager decorator that remembers the decisions of the decorated
+// instance for a limited period of time. Decisions are keyed by the uid, the
+// start time and the AppArmor profile of the calling process, such that a
+// recycled pid never inherits the decision of an exited process, while an app
+// reconnecting to the service skips the potentially expensive round trip.
+// Decisions do not depend on criteria, just like with TrustStorePermissionManager.
+class CachingPermissionManager : public PermissionManager
+{
+public:
+    // Just a convenience typedef.
+    typedef std::shared_ptr<CachingPermissionManager> Ptr;
+
+    // Identifies a process by uid, start time in [clock ticks since boot] and AppArmor profile.
+    typedef std::tuple<uid_t, std::uint64_t, std::string> Key;
+
+    // Functor for resolving credentials to a key, throws if the process is gone.
+    typedef std::function<Key(const Credentials&)> KeyResolver;
+
+    // Counts lookups of decisions in the cache.
+    struct Statistics
+    {
+        // Number of lookups answered from the cache.
+        std::atomic<std::uint64_t> hits{0};
+        // Number of lookups handed to the decorated instance.
+        std::atomic<std::uint64_t> misses{0};
+    };
+
+    // Decisions are remembered for this long by default.
+    static const std::chrono::seconds default_lifetime;
+
+    // Returns a KeyResolver reading start time and AppArmor profile from /proc.
+    static KeyResolver proc_key_resolver();
+
+    // Sets up a new instance decorating impl, remembering decisions for lifetime.
+    CachingPermissionManager(
+            const PermissionManager::Ptr& impl,
+            const KeyResolver& key_resolver = proc_key_resolver(),
+            const std::chrono::milliseconds& lifetime = default_lifetime);
+
+    // Returns the remembered decision for credentials, without reaching out to the
+    // decorated instance. Returns an empty optional if no valid decision is known.
+    Optional<Result> cached_permission_for_credentials(const Credentials& credentials);
+
+    // From PermissionManager
+    Result check_permission_for_credentials(const Criteria& criteria, const Credentials& credentials) override;
+
+    // Returns the counters of cache hits and misses.
+    const Statistics& statistics() const;
+
+private:
+    // Resolves credentials to a key, returning an empty optional on error.
+    Optional<Key> key_for_credentials(const Credentials& credentials);
+    // Returns the remembered decision for key, if still valid.
+    Optional<Result> cached_permission_for_key(const Key& key);
+
+    PermissionManager::Ptr impl;
+    KeyResolver key_resolver;
+    std::chrono::milliseconds lifetime;
+    // Guards decisions.
+    std::mutex guard;
+    // Remembered decisions and the point in time they expire.
+    std::map<Key, std::pair<Result, std::chrono::steady_clock::time_point>> decisions;
+    Statistics stats;
+};
+}
+}
+}
+}
+
+#endif // LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_CACHING_PERMISSION_MANAGER_H_
@@ -21,14 +21,21 @@
 #include <com/ubuntu/location/service/state.h>
 #include <com/ubuntu/location/service/session/interface.h>
 
+#include <com/ubuntu/location/position.h>
 #include <com/ubuntu/location/space_vehicle.h>
+#include <com/ubuntu/location/update.h>
+#include <com/ubuntu/location/units/units.h>
 
 #include <core/dbus/service.h>
 #include <core/dbus/traits/service.h>
 #include <core/dbus/types/object_path.h>
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
+#include <map>
+#include <tuple>
+#include <vector>
 
 namespace dbus = core::dbus;
 
@@ -63,6 +70,20 @@ class Interface
                 return "com.ubuntu.location.Service.Error.CreatingSession";
             }
         };
+        struct RequestingSingleFix
+        {
+            inline static std::string name()
+            {
+                return "com.ubuntu.location.Service.Error.RequestingSingleFix";
+            }
+        };
+        struct QueryingLastKnownPosition
+        {
+            inline static std::string name()
+            {
+                return "com.ubuntu.location.Service.Error.QueryingLastKnownPosition";
+            }
+        };
     };
 
     struct CreateSessionForCriteria
@@ -86,6 +107,62 @@ class Interface
         }
     };
 
+    struct RequestSingleFix
+    {
+        typedef com::ubuntu::location::service::Interface Interface;
+
+        inline static const std::string& name()
+        {
+            static const std::string s
+            {
+                "RequestSingleFix"
+            };
+            return s;
+        }
+
+        // Arguments are the criteria, the horizontal accuracy target and the timeout in [ms].
+        typedef com::ubuntu::location::Update<com::ubuntu::location::Position> ResultType;
+
+        // Requests are answered within this period at the latest, the service
+        // clamps timeouts requested by clients accordingly.
+        inline static const std::chrono::milliseconds max_timeout()
+        {
+            return std::chrono::seconds{60};
+        }
+
+        inline static const std::chrono::milliseconds default_timeout()
+        {
+            return max_timeout() + std::chrono::seconds{5};
+        }
+    };
+
+    struct LastKnownPosition
+    {
+        typedef com::ubuntu::location::service::Interface Interface;
+
+        inline static const std::string& name()
+        {
+            static const std::string s
+            {
+                "LastKnownPosition"
+            };
+            return s;
+        }
+
+        // Returns the fix and its age in [ms] at the time of the query.
+        typedef std::tuple
+        <
+            com::ubuntu::location::Update<com::ubuntu::location::Position>,
+            std::int64_t
+        > ResultType;
+
+        inline static const std::chrono::milliseconds default_timeout()
+        {
+            // Uncached permission checks might involve prompting the user.
+            return std::chrono::seconds{25};
+        }
+    };
+
     struct Properties
     {
         struct State
@@ -175,6 +252,26 @@ class Interface
         };
     };
 
+    struct Signals
+    {
+        // Announces changes to the set of visible space vehicles, carrying the
+        // added and changed space vehicles, and the keys of removed ones.
+        struct VisibleSpaceVehiclesChanged
+        {
+            inline static std::string name()
+            {
+                return "VisibleSpaceVehiclesChanged";
+            }
+
+            typedef com::ubuntu::location::service::Interface Interface;
+            typedef std::tuple
+            <
+                std::map<com::ubuntu::location::SpaceVehicle::Key, com::ubuntu::location::SpaceVehicle>,
+                std::vector<com::ubuntu::location::SpaceVehicle::Key>
+            > ArgumentType;
+        };
+    };
+
     Interface() = default;
 
   public:
@@ -234,6 +331,33 @@ class Interface
      * @return A session instance.
      */
     virtual session::Interface::Ptr create_session_for_criteria(const Criteria& criteria) = 0;
+
+    /**
+     * @brief Acquires a single position fix without the need to manage a session.
+     *
+     * Providers are started for the given criteria and released by the service as
+     * soon as a fix meeting the accuracy target arrives, or the timeout expires.
+     *
+     * @throw std::runtime_error if no fix arrived within the timeout.
+     * @param criteria The client's requirements in terms of accuracy and functionality.
+     * @param accuracy The first fix with at least this horizontal accuracy is returned.
+     * @param timeout If expired, the most accurate fix seen so far is returned.
+     * @return The position fix.
+     */
+    virtual Update<Position> request_single_fix(
+            const Criteria& criteria,
+            const units::Quantity<units::Length>& accuracy,
+            const std::chrono::milliseconds& timeout) = 0;
+
+    /**
+     * @brief Queries the most recent position fix known to the service.
+     *
+     * The service answers from its cache, without starting any provider.
+     *
+     * @throw std::runtime_error if the service has not seen any fix yet.
+     * @return The fix and its age at the time of the query.
+     */
+    virtual std::tuple<Update<Position>, std::chrono::milliseconds> last_known_position() = 0;
 };
 }
 }
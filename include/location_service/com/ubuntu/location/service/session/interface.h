@@ -18,6 +18,7 @@
 #ifndef LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_SESSION_INTERFACE_H_
 #define LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_SESSION_INTERFACE_H_
 
+#include <com/ubuntu/location/criteria.h>
 #include <com/ubuntu/location/heading.h>
 #include <com/ubuntu/location/position.h>
 #include <com/ubuntu/location/provider.h>
@@ -25,6 +26,9 @@
 #include <com/ubuntu/location/velocity.h>
 
 #include <core/property.h>
+#include <core/signal.h>
+
+#include <vector>
 
 namespace com
 {
@@ -45,6 +49,7 @@ public:
     struct UpdatePosition;
     struct UpdateVelocity;
     struct UpdateHeading;
+    struct UpdatePositionBatch;
 
     struct StartPositionUpdates;
     struct StopPositionUpdates;
@@ -55,10 +60,16 @@ public:
     struct StartHeadingUpdates;
     struct StopHeadingUpdates;
 
+    struct StartPositionBatches;
+    struct StopPositionBatches;
+
+    struct SetUpdateFilter;
+
     struct Errors
     {
         struct ErrorParsingUpdate;
         struct ErrorStartingUpdate;
+        struct ErrorSettingUpdateFilter;
     };
     /**
      * @brief Encapsulates updates provided for this session, and the ability to enable/disable updates.
@@ -82,6 +93,17 @@ public:
          * @brief Status of position updates, mutable.
          */
         core::Property<Status> position_status{Status::disabled};
+        /**
+         * @brief Batches of position measurements, ordered from oldest to newest.
+         */
+        core::Signal<std::vector<Update<Position>>> position_batch;
+        /**
+         * @brief Whether the client accepts batches of position updates, mutable.
+         *
+         * Clients that have not opted in receive the samples of a batch as
+         * individual position updates.
+         */
+        core::Property<Status> position_batch_status{Status::disabled};
 
         /**
          * @brief Updates for the heading measurements.
@@ -100,6 +122,11 @@ public:
          * @brief Status of velocity updates, mutable.
          */
         core::Property<Status> velocity_status{Status::disabled};
+
+        /**
+         * @brief Minimum interval and displacement between updates delivered to this session, mutable.
+         */
+        core::Property<Criteria::Updates> filter{};
     };
 
     typedef std::shared_ptr<Interface> Ptr;
@@ -30,7 +30,13 @@
 #include <core/dbus/object.h>
 #include <core/dbus/skeleton.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace com
 {
@@ -40,11 +46,50 @@ namespace location
 {
 namespace service
 {
+class Timer;
+
 namespace session
 {
+class DeliveryTracker;
+class UpdateEncoder;
+class UpdateFilter;
+
 class Skeleton : public core::dbus::Skeleton<Interface>
 {
 public:
+    // Bounds the resources a client can bind in the service. Updates sent
+    // as tracked method calls occupy memory in the service until the client
+    // replies to them or they time out.
+    struct Limits
+    {
+        // Maximum number of updates awaiting a reply. The oldest update is
+        // dropped if a new one would exceed the limit.
+        std::size_t max_outstanding_updates{8};
+        // Number of consecutive updates the client is allowed to fail replying
+        // to before the session is evicted.
+        std::size_t max_consecutive_failures{3};
+        // The session is evicted if the smoothed time the client takes to reply
+        // to updates exceeds this budget.
+        std::chrono::milliseconds max_latency{500};
+        // With a shared encoder, every probe_interval-th update is tracked to
+        // check whether the client is still responsive.
+        std::size_t probe_interval{10};
+    };
+
+    // Counts how often sessions had to be throttled or evicted. One instance
+    // is shared by all sessions of a service.
+    struct Statistics
+    {
+        // Updates dropped as too many updates were outstanding.
+        std::atomic<std::uint64_t> dropped_updates{0};
+        // Updates that failed or that the client did not reply to in time.
+        std::atomic<std::uint64_t> failed_updates{0};
+        // Sessions evicted for exceeding their failure budget.
+        std::atomic<std::uint64_t> evicted_for_failures{0};
+        // Sessions evicted for exceeding their latency budget.
+        std::atomic<std::uint64_t> evicted_for_latency{0};
+    };
+
     // All local, i.e., in-process creation-time properties of the Skeleton.
     struct Local
     {
@@ -52,17 +97,30 @@ public:
         Interface::Ptr impl;
         // The bus connection that the object is exposed upon.
         core::dbus::Bus::Ptr bus;
+        // Encoder shared across all sessions of the service. If set, updates
+        // are serialized once for all sessions and delivered without expecting
+        // a reply. Otherwise, every update is sent as a tracked method call.
+        std::shared_ptr<UpdateEncoder> encoder;
+        // Accumulates throttling and eviction counts, may be shared across sessions.
+        std::shared_ptr<Statistics> statistics;
+        // Invoked if the client exceeds its budget and the session should be torn down.
+        std::function<void()> on_session_died;
     };
 
     // We communicate position, heading and velocity updates to the client
-    // via an explicit function call. The reason is simple: We want to know
-    // whether the client is still alive and responding as expected to make sure
-    // that we stop positioning as early as possible.
+    // via an explicit function call. Tracked calls tell us whether the client
+    // is still alive and responding as expected. Calls not expecting a reply
+    // are cheaper to dispatch and rely on the service observing the client's
+    // bus name to detect dead clients.
     struct Remote
     {
         // The remote object corresponding to the client, implementing
         // com.ubuntu.location.service.session.Interface
         core::dbus::Object::Ptr object;
+        // The unique bus name of the client.
+        std::string name;
+        // The bus connection for reaching out to the client.
+        core::dbus::Bus::Ptr bus;
     };
 
     struct Configuration
@@ -73,6 +131,8 @@ public:
         Local local;
         // Remote attributes
         Remote remote;
+        // Budget of the client.
+        Limits limits;
     };
 
     Skeleton(const Configuration& configuration);
@@ -90,6 +150,11 @@ private:
     // Handles incoming requests for Start/StopVelocityUpdates
     virtual void on_start_velocity_updates(const core::dbus::Message::Ptr&);
     virtual void on_stop_velocity_updates(const core::dbus::Message::Ptr&);
+    // Handles incoming requests for Start/StopPositionBatches
+    virtual void on_start_position_batches(const core::dbus::Message::Ptr&);
+    virtual void on_stop_position_batches(const core::dbus::Message::Ptr&);
+    // Handles incoming requests for SetUpdateFilter
+    virtual void on_set_update_filter(const core::dbus::Message::Ptr&);
 
     // Invoked whenever the actual session impl. for the session reports a position update.
     virtual void on_position_changed(const Update<Position>& position);
@@ -97,11 +162,38 @@ private:
     virtual void on_heading_changed(const Update<Heading>& heading);
     // Invoked whenever the actual session impl. reports a velocity update.
     virtual void on_velocity_changed(const Update<Velocity>& velocity);
+    // Invoked whenever the actual session impl. reports a batch of position updates.
+    virtual void on_position_batch(const std::vector<Update<Position>>& batch);
+
+    // Sends out update to the client as a Method invocation, either via the shared
+    // encoder or by encoding it for this session. Tracked updates are accounted
+    // for against the client's budget.
+    template<typename Method, typename T>
+    void send_update(const Update<T>& update);
+
+    // Sends out batch to the client as a single Method invocation.
+    template<typename Method, typename T>
+    void send_batch(const std::vector<Update<T>>& batch);
+
+    // Hands msg to the bus, accounting for it against the client's budget if tracked.
+    template<typename Method>
+    void deliver(const core::dbus::Message::Ptr& msg, bool tracked);
+
+    // Makes sure that updates held back by the filter are delivered once due.
+    void schedule_held_back_updates();
+    // Delivers the updates held back by the filter that are due.
+    void deliver_held_back_updates();
 
     // Stores all attributes passed at creation time.
     Configuration configuration;
     // The DBus object corresponding to the session.
     core::dbus::Object::Ptr object;
+    // Drops updates that the client is not interested in.
+    std::shared_ptr<UpdateFilter> filter;
+    // Accounts for updates awaiting a reply from the client.
+    std::shared_ptr<DeliveryTracker> tracker;
+    // Delivers the latest update held back by the filter once the update interval elapsed.
+    std::shared_ptr<Timer> held_back;
     // Scoped connections for automatically disconnecting on destruction
     struct
     {
@@ -111,6 +203,10 @@ private:
         core::ScopedConnection heading_changed;
         // Corresponds to velocity updates coming in from the actual implementation instance.
         core::ScopedConnection velocity_changed;
+        // Corresponds to batches of position updates coming in from the actual implementation instance.
+        core::ScopedConnection position_batch;
+        // Corresponds to changes of the update filter of the actual implementation instance.
+        core::ScopedConnection filter_changed;
     } connections;
 };
 }
@@ -18,18 +18,34 @@
 #ifndef LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_SKELETON_H_
 #define LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_SKELETON_H_
 
+#include <com/ubuntu/location/service/caching_permission_manager.h>
 #include <com/ubuntu/location/service/interface.h>
 #include <com/ubuntu/location/service/permission_manager.h>
 #include <com/ubuntu/location/service/session/interface.h>
+#include <com/ubuntu/location/service/session/skeleton.h>
 
 #include <core/dbus/dbus.h>
 #include <core/dbus/object.h>
 #include <core/dbus/property.h>
 #include <core/dbus/service_watcher.h>
+#include <core/dbus/signal.h>
 #include <core/dbus/skeleton.h>
 
 #include <core/dbus/interfaces/properties.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
 namespace com
 {
 namespace ubuntu
@@ -38,6 +54,8 @@ namespace location
 {
 namespace service
 {
+class Timer;
+
 class Skeleton
         : public core::dbus::Skeleton<com::ubuntu::location::service::Interface>,
           public std::enable_shared_from_this<Skeleton>
@@ -58,19 +76,77 @@ public:
     };
 
     // Implements CredentialsResolver by reaching out to the dbus daemon and
-    // invoking:
+    // invoking GetConnectionCredentials, falling back to:
     //   * GetConnectionUnixProcessID
     //   * GetConnectionUnixUser
+    // Results are cached per unique bus name until the name vanishes from the bus.
     struct DBusDaemonCredentialsResolver : public CredentialsResolver
     {
+        // Counts resolutions answered from the cache and by the dbus daemon.
+        struct Statistics
+        {
+            std::atomic<std::uint64_t> hits{0};
+            std::atomic<std::uint64_t> misses{0};
+        };
+
+        // The dbus daemon's NameOwnerChanged signal, defined in the implementation.
+        struct NameOwnerChanged;
+        typedef core::dbus::Signal<
+            NameOwnerChanged,
+            std::tuple<std::string, std::string, std::string>
+        > NameOwnerChangedSignal;
+
         // Sets up a new instance for the given bus connection.
         DBusDaemonCredentialsResolver(const core::dbus::Bus::Ptr& bus);
+        // Stops watching for peers leaving the bus.
+        ~DBusDaemonCredentialsResolver();
 
         // Resolves the sender of msg to pid, uid by calling out to the dbus daemon.
         Credentials resolve_credentials_for_incoming_message(const core::dbus::Message::Ptr& msg);
 
+        // Resolves name to pid, uid with a single call to the dbus daemon.
+        Credentials resolve_credentials_for_name(const std::string& name);
+
+        // Marks credentials of the unique name as being resolved, replacing any
+        // cached ones. The returned generation identifies the pending entry.
+        std::uint64_t reserve_cache_entry_for_name(const std::string& name);
+
+        // Caches credentials for the unique name until the peer leaves the bus.
+        // Returns false, caching nothing, if the pending entry of the given generation
+        // has been evicted or replaced in the meantime, e.g., as the peer left.
+        bool cache_credentials_for_name(const std::string& name, std::uint64_t generation, const Credentials& credentials);
+
+        // Drops the pending entry of the given generation for name, if any.
+        void release_cache_entry_for_name(const std::string& name, std::uint64_t generation);
+
+        // Returns true iff credentials are cached for name.
+        bool has_cached_credentials_for_name(const std::string& name);
+
+        // The bus connection we resolve credentials on.
+        core::dbus::Bus::Ptr bus;
         // Stub for accessing the dbus daemon.
         core::dbus::DBus daemon;
+        // The dbus daemon's object, for the calls not covered by daemon.
+        core::dbus::Object::Ptr object;
+        // Credentials of a peer, pending until they have been resolved.
+        struct CacheEntry
+        {
+            std::uint64_t generation;
+            bool pending;
+            Credentials credentials;
+        };
+
+        // Guards cache and last_generation.
+        std::mutex guard;
+        // Cached credentials, keyed by unique bus name.
+        std::map<std::string, CacheEntry> cache;
+        // The generation handed out to the most recent pending entry.
+        std::uint64_t last_generation{0};
+        Statistics stats;
+        // A single subscription evicts the entries of all peers leaving the bus,
+        // instead of a match rule per peer.
+        std::shared_ptr<NameOwnerChangedSignal> name_owner_changed;
+        NameOwnerChangedSignal::SubscriptionToken name_owner_changed_token;
     };
 
     // Models the generation of stable and unique object paths for client-specific sessions.
@@ -105,6 +181,8 @@ public:
         ObjectPathGenerator::Ptr object_path_generator;
         // Permission manager implementation for verifying incoming requests.
         PermissionManager::Ptr permission_manager;
+        // Budget of every individual session.
+        session::Skeleton::Limits session_limits;
     };
 
     Skeleton(const Configuration& configuration);
@@ -116,15 +194,69 @@ public:
     core::Property<bool>& does_report_cell_and_wifi_ids();
     core::Property<bool>& is_online();
     core::Property<std::map<SpaceVehicle::Key, SpaceVehicle>>& visible_space_vehicles();
+    // Blocks the caller until the fix is available, meant for in-process callers.
+    Update<Position> request_single_fix(
+            const Criteria& criteria,
+            const units::Quantity<units::Length>& accuracy,
+            const std::chrono::milliseconds& timeout);
+
+    // Returns the counters of throttled and evicted sessions.
+    const session::Skeleton::Statistics& session_statistics() const;
+
+    // Returns the hit and miss counters of the permission cache.
+    const CachingPermissionManager::Statistics& permission_statistics() const;
 
 protected:
     // Enable subclasses to alter the state.
     core::Property<State>& mutable_state();
 private:
+    // Queue and workers for permission checks that miss the cache, defined below.
+    struct PermissionChecks;
+    // Pending single fix requests and their worker, defined below.
+    struct SingleFixes;
+
     // Handles incoming message calls for create_session_for_criteria.
     // Dispatches to the actual implementation, and manages object lifetimes.
     void handle_create_session_for_criteria(const core::dbus::Message::Ptr& msg);
 
+    // Handles incoming message calls for request_single_fix. Replies once the fix
+    // is available, without blocking the dispatcher in the meantime.
+    void handle_request_single_fix(const core::dbus::Message::Ptr& msg);
+
+    // Starts acquiring a single fix on a session created for criteria. Invokes then exactly
+    // once, with the fix, or with none if no fix arrived within timeout.
+    void acquire_single_fix(
+            const Criteria& criteria,
+            const units::Quantity<units::Length>& accuracy,
+            const std::chrono::milliseconds& timeout,
+            const std::function<void(const Optional<Update<Position>>&)>& then);
+
+    // Handles incoming message calls for last_known_position.
+    void handle_last_known_position(const core::dbus::Message::Ptr& msg);
+
+    // Creates a session for the sender of msg and replies to msg with its path.
+    // Invoked once the sender has been granted permission.
+    void create_session_for_caller(
+            const core::dbus::Message::Ptr& msg,
+            const Criteria& criteria,
+            const Credentials& credentials);
+
+    // Checks whether the caller with the given credentials is allowed to access the service.
+    // Cached decisions are handed to then right away. Otherwise, the permission manager is
+    // consulted on permission_checks->workers, as it might block, e.g., on a trust prompt,
+    // and then is invoked there.
+    void check_permission_for_credentials(
+            const Criteria& criteria,
+            const Credentials& credentials,
+            const std::function<void(PermissionManager::Result)>& then);
+
+    // Executes queued permission checks. Executed on permission_checks->workers.
+    static void run_permission_checks(const std::shared_ptr<PermissionChecks>& checks);
+
+    // Completes single fix requests that are satisfied or expired, releasing their
+    // sessions and thus the providers. Executed on single_fixes->worker.
+    void run_single_fix_requests();
+
     // Tries to register the given session under the given path in the session store.
     // Returns true iff the session has been added to the store.
     bool add_to_session_store_for_path(
@@ -143,6 +275,14 @@ private:
     void on_does_report_cell_and_wifi_ids_changed(bool value);
     // Called whenever the value of the respective property changes.
     void on_is_online_changed(bool value);
+    // Called whenever the set of visible space vehicles changes. Announces
+    // the difference to the last announced set, at most once per second.
+    // Changes arriving faster are held back and the latest one is announced
+    // by announced_space_vehicles.timer once the second has passed.
+    void on_visible_space_vehicles_changed(const std::map<SpaceVehicle::Key, SpaceVehicle>& svs);
+    // Announces space vehicles held back by on_visible_space_vehicles_changed.
+    // Executed by announced_space_vehicles.timer once they are due.
+    void announce_held_back_space_vehicles();
 
     // Stores the configuration passed in at creation time.
     Configuration configuration;
@@ -156,6 +296,12 @@ private:
         core::dbus::interfaces::Properties::Signals::PropertiesChanged,
         core::dbus::interfaces::Properties::Signals::PropertiesChanged::ArgumentType
     >::Ptr properties_changed;
+    // We announce changes to the visible space vehicles as deltas.
+    core::dbus::Signal
+    <
+        Interface::Signals::VisibleSpaceVehiclesChanged,
+        Interface::Signals::VisibleSpaceVehiclesChanged::ArgumentType
+    >::Ptr visible_space_vehicles_changed;
 
     // DBus properties as exposed on the bus for com.ubuntu.location.service.Interface
     struct
@@ -173,7 +319,19 @@ private:
         core::ScopedConnection does_satellite_based_positioning;
         core::ScopedConnection does_report_cell_and_wifi_ids;
         core::ScopedConnection is_online;
+        core::ScopedConnection visible_space_vehicles;
     } connections;
+    // Remembers the space vehicles that clients have last been told about.
+    struct
+    {
+        std::mutex guard;
+        std::map<SpaceVehicle::Key, SpaceVehicle> svs;
+        std::chrono::steady_clock::time_point when;
+        // The latest change that arrived too early to be announced right away.
+        Optional<std::map<SpaceVehicle::Key, SpaceVehicle>> pending;
+        // Announces the pending change once it is due.
+        std::shared_ptr<Timer> timer;
+    } announced_space_vehicles;
     // Guards the session store.
     std::mutex guard;
     // We track sessions and their respective watchers.
@@ -184,6 +342,57 @@ private:
     };
     // Keeps track of running sessions, keying them by their unique object path.
     std::map<dbus::types::ObjectPath, Element> session_store;
+    // A pending request for a single fix.
+    struct SingleFixRequest
+    {
+        // Fixes at least this accurate satisfy the request.
+        units::Quantity<units::Length> accuracy;
+        // The request is completed with the best fix seen so far at this point in time.
+        std::chrono::steady_clock::time_point deadline;
+        // Invoked exactly once on completion.
+        std::function<void(const Optional<Update<Position>>&)> then;
+        // The session delivering fixes, released on completion.
+        session::Interface::Ptr session;
+        // The most accurate fix seen so far.
+        Optional<Update<Position>> best;
+        // Set once the request is satisfied or completed.
+        bool done;
+        // Connections to the session's position updates.
+        std::vector<core::ScopedConnection> connections;
+    };
+    // All pending single fix requests, completed by the worker.
+    struct SingleFixes
+    {
+        std::mutex guard;
+        std::condition_variable wakeup;
+        std::set<std::shared_ptr<SingleFixRequest>> pending;
+        bool stopped{false};
+        // Only started with the first request.
+        std::thread worker;
+    };
+    // Shared with the sessions' update handlers, as providers might still deliver
+    // a fix on their own threads while we are going away.
+    std::shared_ptr<SingleFixes> single_fixes;
+    // Remembers the decisions of configuration.permission_manager.
+    CachingPermissionManager::Ptr permission_cache;
+    // Permission checks that missed the cache, executed by a small pool of workers.
+    struct PermissionChecks
+    {
+        std::mutex guard;
+        std::condition_variable wakeup;
+        std::deque<std::function<void()>> queue;
+        // Number of workers waiting for a check.
+        std::size_t idle{0};
+        bool stopped{false};
+        // Only started on demand.
+        std::vector<std::thread> workers;
+    };
+    // Shared with the workers, as the last reference to us might be released on one of them.
+    std::shared_ptr<PermissionChecks> permission_checks;
+    // Shared across all sessions, making sure that an update is only encoded once.
+    std::shared_ptr<session::UpdateEncoder> update_encoder;
+    // Shared across all sessions, accumulating throttling and eviction counts.
+    std::shared_ptr<session::Skeleton::Statistics> statistics;
 };
 }
 }
@@ -40,6 +40,11 @@ class Stub : public core::dbus::Stub<Interface>
     ~Stub() noexcept;
 
     session::Interface::Ptr create_session_for_criteria(const Criteria& criteria);
+    Update<Position> request_single_fix(
+            const Criteria& criteria,
+            const units::Quantity<units::Length>& accuracy,
+            const std::chrono::milliseconds& timeout);
+    std::tuple<Update<Position>, std::chrono::milliseconds> last_known_position();
 
     const core::Property<State>& state() const;
     core::Property<bool>& does_satellite_based_positioning();
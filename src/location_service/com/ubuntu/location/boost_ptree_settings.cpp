@@ -22,8 +22,47 @@
 
 #include <boost/property_tree/ini_parser.hpp>
 
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace location = com::ubuntu::location;
 
+namespace
+{
+// Flushes the file or directory at path to disk, returning false on error.
+bool fsync_path(const std::string& path, int flags)
+{
+    int fd = ::open(path.c_str(), flags | O_CLOEXEC);
+    if (fd == -1)
+        return false;
+
+    bool result = ::fsync(fd) == 0;
+    // We report the error of fsync, not close.
+    int error = errno;
+    ::close(fd);
+    errno = error;
+
+    return result;
+}
+
+// Returns the directory containing fn.
+std::string directory_of(const std::string& fn)
+{
+    auto pos = fn.find_last_of('/');
+
+    if (pos == std::string::npos)
+        return ".";
+    if (pos == 0)
+        return "/";
+
+    return fn.substr(0, pos);
+}
+}
+
 // Creates a new instance, reading values from the given filename.
 location::BoostPtreeSettings::BoostPtreeSettings(const std::string& fn) : fn{fn}
 {
@@ -38,16 +77,40 @@ location::BoostPtreeSettings::BoostPtreeSettings(const std::string& fn) : fn{fn}
 }
 
 // Syncs the current settings to implementation-specific backends.
+// We write to a temporary file next to fn, flush it to disk and rename it
+// into place, such that neither readers nor a crash ever leave us with a
+// partially written configuration file. Flushing the directory afterwards
+// makes the rename itself durable.
 void location::BoostPtreeSettings::sync()
 {
+    const std::string tmp{fn + ".tmp"};
+
     try
     {
-        boost::property_tree::write_ini(fn, tree);
+        boost::property_tree::write_ini(tmp, tree);
     }
     catch (const boost::property_tree::ini_parser_error& e)
     {
         LOG(WARNING) << "Could not store to configuration file " << fn << ": " << e.what();
+        return;
     }
+
+    if (not fsync_path(tmp, O_RDONLY))
+    {
+        LOG(WARNING) << "Could not flush configuration file " << tmp << ": " << std::strerror(errno);
+        std::remove(tmp.c_str());
+        return;
+    }
+
+    if (std::rename(tmp.c_str(), fn.c_str()) != 0)
+    {
+        LOG(WARNING) << "Could not replace configuration file " << fn << ": " << std::strerror(errno);
+        std::remove(tmp.c_str());
+        return;
+    }
+
+    if (not fsync_path(directory_of(fn), O_RDONLY | O_DIRECTORY))
+        LOG(WARNING) << "Could not flush directory of configuration file " << fn << ": " << std::strerror(errno);
 }
 
 // Returns true iff a value is known for the given key.
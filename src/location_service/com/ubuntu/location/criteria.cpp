@@ -95,5 +95,35 @@ com::ubuntu::location::Criteria com::ubuntu::location::operator+(
         result.accuracy.heading = rhs.accuracy.heading;
     }
 
+    // An update filter that is not set means that all updates are required,
+    // i.e., we only keep a filter if both sides ask for it.
+    if (result.updates.interval && rhs.updates.interval)
+    {
+        if (rhs.updates.interval < result.updates.interval)
+            result.updates.interval = rhs.updates.interval;
+    } else
+    {
+        result.updates.interval.reset();
+    }
+
+    if (result.updates.displacement && rhs.updates.displacement)
+    {
+        if (rhs.updates.displacement < result.updates.displacement)
+            result.updates.displacement = rhs.updates.displacement;
+    } else
+    {
+        result.updates.displacement.reset();
+    }
+
     return result;
 }
+
+bool com::ubuntu::location::Criteria::Updates::operator==(const com::ubuntu::location::Criteria::Updates& rhs) const
+{
+    return interval == rhs.interval && displacement == rhs.displacement;
+}
+
+bool com::ubuntu::location::Criteria::Updates::operator!=(const com::ubuntu::location::Criteria::Updates& rhs) const
+{
+    return !(*this == rhs);
+}
@@ -40,6 +40,12 @@ const cul::Provider::Ptr& cul::ProviderSelectionPolicy::null_provider()
 }
 
 cul::DefaultProviderSelectionPolicy::DefaultProviderSelectionPolicy()
+    : DefaultProviderSelectionPolicy(false)
+{
+}
+
+cul::DefaultProviderSelectionPolicy::DefaultProviderSelectionPolicy(bool hedge_position_updates)
+    : hedge_position_updates(hedge_position_updates)
 {
 }
 
@@ -56,9 +62,14 @@ cul::DefaultProviderSelectionPolicy::determine_provider_selection_for_criteria(
     {
         determine_position_updates_provider(criteria, enumerator),
         determine_heading_updates_provider(criteria, enumerator),
-        determine_velocity_updates_provider(criteria, enumerator)
+        determine_velocity_updates_provider(criteria, enumerator),
+        Provider::Ptr{}
     };
-    
+
+    if (hedge_position_updates)
+        selection.coarse_position_updates_provider = determine_coarse_position_updates_provider(
+                    criteria, enumerator, selection.position_updates_provider);
+
     return selection;
 }
 
@@ -88,6 +99,34 @@ cul::DefaultProviderSelectionPolicy::determine_position_updates_provider(
     return matching_providers.empty() ? null_provider() : *matching_providers.begin();
 }
 
+cul::Provider::Ptr
+cul::DefaultProviderSelectionPolicy::determine_coarse_position_updates_provider(
+    const cul::Criteria& criteria,
+    const cul::ProviderEnumerator& enumerator,
+    const cul::Provider::Ptr& position_updates_provider)
+{
+    // Only satellite-based providers are slow to deliver their first fix.
+    if (position_updates_provider == null_provider() ||
+        not position_updates_provider->requires(Provider::Requirements::satellites))
+        return Provider::Ptr{};
+
+    Provider::Ptr result;
+
+    enumerator.for_each_provider(
+        [&](const Provider::Ptr& provider)
+        {
+            if (result || provider == position_updates_provider)
+                return;
+
+            if (provider->supports(Provider::Features::position) &&
+                not provider->requires(Provider::Requirements::satellites) &&
+                provider->matches_criteria(criteria))
+                result = provider;
+        });
+
+    return result;
+}
+
 cul::Provider::Ptr cul::DefaultProviderSelectionPolicy::determine_heading_updates_provider(
     const cul::Criteria& criteria,
     const cul::ProviderEnumerator& enumerator)
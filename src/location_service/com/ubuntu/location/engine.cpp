@@ -17,27 +17,101 @@
  */
 #include <com/ubuntu/location/engine.h>
 
+#include <com/ubuntu/location/fusion_provider.h>
 #include <com/ubuntu/location/logging.h>
+#include <com/ubuntu/location/newer_or_more_accurate_update_selector.h>
 #include <com/ubuntu/location/provider_selection_policy.h>
 #include <com/ubuntu/location/state_tracking_provider.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <stdexcept>
 #include <unordered_map>
 
+#include "kalman_update_policy.h"
 #include "time_based_update_policy.h"
 
 namespace cul = com::ubuntu::location;
 
+namespace
+{
+// Fixes arrive up to once per second, but we only want to rewrite settings
+// if the device moved or the fix improved, and not more often than every
+// last_known_location_min_period. A fix that is persisted is replaced by any
+// newer one after last_known_location_refresh_period at the latest.
+constexpr std::chrono::seconds last_known_location_min_period{30};
+constexpr std::chrono::minutes last_known_location_refresh_period{10};
+constexpr double last_known_location_min_distance_in_meters{100.};
+
+// Encodes update as "latitude longitude horizontal_accuracy timestamp" with the
+// horizontal accuracy in [m], or -1 if unknown, and the timestamp in [ms] since the
+// epoch. We rely on the wall clock, as Clock does not survive restarts.
+std::string encode_last_known_location(const cul::Update<cul::Position>& update)
+{
+    auto age = cul::Clock::now() - update.when;
+    auto when = std::chrono::duration_cast<std::chrono::milliseconds>(
+                (std::chrono::system_clock::now() - age).time_since_epoch());
+
+    std::stringstream ss; ss.precision(std::numeric_limits<double>::max_digits10);
+    ss << update.value.latitude.value.value() << " "
+       << update.value.longitude.value.value() << " "
+       << (update.value.accuracy.horizontal ? update.value.accuracy.horizontal->value() : -1.) << " "
+       << when.count();
+
+    return ss.str();
+}
+
+// Decodes an update encoded by encode_last_known_location, returning its age alongside.
+// Returns an empty optional if the value cannot be parsed.
+cul::Optional<std::pair<cul::Position, std::chrono::milliseconds>> decode_last_known_location(const std::string& value)
+{
+    double latitude{0.}, longitude{0.}, accuracy{0.};
+    std::int64_t when{0};
+
+    std::stringstream ss{value};
+    if (not (ss >> latitude >> longitude >> accuracy >> when))
+        return cul::Optional<std::pair<cul::Position, std::chrono::milliseconds>>{};
+
+    cul::Position position
+    {
+        cul::wgs84::Latitude{latitude * cul::units::Degrees},
+        cul::wgs84::Longitude{longitude * cul::units::Degrees}
+    };
+
+    if (accuracy >= 0.)
+        position.accuracy.horizontal = accuracy * cul::units::Meters;
+
+    auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()) - std::chrono::milliseconds{when};
+
+    return std::make_pair(position, std::max(std::chrono::milliseconds{0}, age));
+}
+}
+
 const cul::SatelliteBasedPositioningState cul::Engine::Configuration::Defaults::satellite_based_positioning_state;
 const cul::WifiAndCellIdReportingState cul::Engine::Configuration::Defaults::wifi_and_cell_id_reporting_state;
 const cul::Engine::Status cul::Engine::Configuration::Defaults::engine_state;
+const std::chrono::seconds cul::Engine::Configuration::Defaults::space_vehicle_max_age;
+const std::chrono::seconds cul::Engine::Configuration::Defaults::provider_linger_period;
+const std::chrono::seconds cul::Engine::Configuration::Defaults::last_known_location_max_age;
 
 cul::Engine::Engine(const cul::ProviderSelectionPolicy::Ptr& provider_selection_policy,
                     const cul::Settings::Ptr& settings)
-          : provider_selection_policy(provider_selection_policy),
+          : Engine(provider_selection_policy, settings, Dispatcher{})
+{
+}
+
+cul::Engine::Engine(const cul::ProviderSelectionPolicy::Ptr& provider_selection_policy,
+                    const cul::Settings::Ptr& settings,
+                    const cul::Engine::Dispatcher& dispatcher)
+          : providers(std::make_shared<ProviderRegistry>()),
+            provider_selection_policy(provider_selection_policy),
             settings(settings),
-            update_policy(std::make_shared<cul::TimeBasedUpdatePolicy>())
+            dispatcher(dispatcher),
+            lifetime(std::make_shared<Lifetime>())
 {
     if (!provider_selection_policy) throw std::runtime_error
     {
@@ -49,9 +123,16 @@ cul::Engine::Engine(const cul::ProviderSelectionPolicy::Ptr& provider_selection_
         "Cannot construct an engine given a null Settings instance"
     };
 
+    if (settings->get_string_for_key(Configuration::Keys::update_policy, "TimeBased") == "Kalman")
+        update_policy = std::make_shared<cul::KalmanUpdatePolicy>();
+    else
+        update_policy = std::make_shared<cul::TimeBasedUpdatePolicy>();
+
     // Setup behavior in case of configuration changes.
     configuration.satellite_based_positioning_state.changed().connect([this](const SatelliteBasedPositioningState& state)
     {
+        invalidate_provider_selections();
+
         for_each_provider([this, state](const Provider::Ptr& provider)
         {
             if (provider->requires(cul::Provider::Requirements::satellites))
@@ -71,8 +152,15 @@ cul::Engine::Engine(const cul::ProviderSelectionPolicy::Ptr& provider_selection_
         });
     });
 
+    engine_off = configuration.engine_state.get() == Engine::Status::off;
     configuration.engine_state.changed().connect([this](const Engine::Status& status)
     {
+        // Toggling between on and active merely follows provider activity and
+        // leaves the set of eligible providers alone.
+        auto was_off = engine_off.exchange(status == Engine::Status::off);
+        if (was_off || status == Engine::Status::off)
+            invalidate_provider_selections();
+
         for_each_provider([this, status](const Provider::Ptr& provider)
         {
             switch (status)
@@ -114,10 +202,35 @@ cul::Engine::Engine(const cul::ProviderSelectionPolicy::Ptr& provider_selection_
     {
         Engine::settings->set_enum_for_key<WifiAndCellIdReportingState>(Configuration::Keys::wifi_and_cell_id_reporting_state, state);
     });
+
+    configuration.provider_linger_period.changed().connect([this](const std::chrono::seconds& period)
+    {
+        auto registry = provider_registry();
+        for (const auto& pair : *registry)
+            pair.first->set_linger_period(period);
+    });
+
+    restore_last_known_location();
+
+    updates.last_known_location.changed().connect([this](const cul::Optional<cul::Update<cul::Position>>& update)
+    {
+        if (update)
+            persist_last_known_location(*update);
+    });
 }
 
 cul::Engine::~Engine()
 {
+    // Pending expiry of space vehicles must not reach out to us anymore.
+    space_vehicle_expiry.stop();
+
+    // From here on, we are not handling events from the dispatcher anymore.
+    {
+        std::unique_lock<std::mutex> ul(lifetime->guard);
+        lifetime->alive = false;
+        lifetime->cv.wait(ul, [this]() { return lifetime->running == 0; });
+    }
+
     settings->set_enum_for_key<Engine::Status>(
         Configuration::Keys::engine_state,
         configuration.engine_state);
@@ -126,6 +239,17 @@ cul::Engine::~Engine()
         Configuration::Keys::wifi_and_cell_id_reporting_state,
         configuration.wifi_and_cell_id_reporting_state);
 
+    // The most recent fix is the best reference for the next start.
+    if (updates.last_known_location.get())
+        settings->set_string_for_key(
+            Configuration::Keys::last_known_location,
+            encode_last_known_location(*updates.last_known_location.get()));
+
+    // Providers are not supposed to outlive us in a running state.
+    auto registry = provider_registry();
+    for (const auto& pair : *registry)
+        pair.first->set_linger_period(std::chrono::milliseconds{0});
+
     for_each_provider([](const Provider::Ptr& provider)
     {
         provider->state_controller()->stop_position_updates();
@@ -136,7 +260,87 @@ cul::Engine::~Engine()
 
 cul::ProviderSelection cul::Engine::determine_provider_selection_for_criteria(const cul::Criteria& criteria)
 {
-    return provider_selection_policy->determine_provider_selection_for_criteria(criteria, *this);
+    auto key = selection_key_for_criteria(criteria);
+    std::uint64_t generation{0};
+
+    {
+        std::lock_guard<std::mutex> lg(selections.guard);
+
+        auto it = selections.entries.find(key);
+        if (it != selections.entries.end())
+        {
+            ProviderSelection selection;
+            if (restore_provider_selection(it->second, selection))
+                return selection;
+
+            // The last session using the selection is gone.
+            selections.entries.erase(it);
+        }
+
+        generation = selections.generation;
+    }
+
+    // We do not hold the lock while selecting, as matching providers to
+    // criteria might involve calls out to remote providers.
+    auto selection = provider_selection_policy->determine_provider_selection_for_criteria(criteria, *this);
+
+    std::lock_guard<std::mutex> lg(selections.guard);
+    if (generation == selections.generation)
+        selections.entries[key] = cache_provider_selection(selection);
+
+    return selection;
+}
+
+cul::Engine::CachedSelection cul::Engine::cache_provider_selection(const cul::ProviderSelection& selection)
+{
+    auto weak = [](const cul::Provider::Ptr& provider)
+    {
+        return WeakSelection{static_cast<bool>(provider), provider};
+    };
+
+    return CachedSelection
+    {
+        weak(selection.position_updates_provider),
+        weak(selection.heading_updates_provider),
+        weak(selection.velocity_updates_provider),
+        weak(selection.coarse_position_updates_provider)
+    };
+}
+
+bool cul::Engine::restore_provider_selection(const cul::Engine::CachedSelection& cached, cul::ProviderSelection& selection)
+{
+    auto strong = [](const WeakSelection& weak, cul::Provider::Ptr& provider)
+    {
+        provider = weak.provider.lock();
+        return provider || not weak.selected;
+    };
+
+    return strong(cached.position, selection.position_updates_provider) &&
+            strong(cached.heading, selection.heading_updates_provider) &&
+            strong(cached.velocity, selection.velocity_updates_provider) &&
+            strong(cached.coarse_position, selection.coarse_position_updates_provider);
+}
+
+cul::Engine::SelectionKey cul::Engine::selection_key_for_criteria(const cul::Criteria& criteria)
+{
+    return SelectionKey
+    {
+        criteria.requires.position,
+        criteria.requires.altitude,
+        criteria.requires.velocity,
+        criteria.requires.heading,
+        criteria.accuracy.horizontal.value(),
+        criteria.accuracy.vertical ? criteria.accuracy.vertical->value() : -1.,
+        criteria.accuracy.velocity ? criteria.accuracy.velocity->value() : -1.,
+        criteria.accuracy.heading ? criteria.accuracy.heading->value() : -1.
+    };
+}
+
+void cul::Engine::invalidate_provider_selections()
+{
+    std::lock_guard<std::mutex> lg(selections.guard);
+    selections.generation++;
+    selections.entries.clear();
 }
 
 void cul::Engine::add_provider(const cul::Provider::Ptr& impl)
@@ -144,7 +348,20 @@ void cul::Engine::add_provider(const cul::Provider::Ptr& impl)
     if (!impl)
         throw std::runtime_error("Cannot add null provider");
 
-    auto provider = std::make_shared<StateTrackingProvider>(impl);
+    // Provider updates reach the engine and sessions on the dispatcher. The engine's
+    // handlers below thus run in order and do not need to dispatch themselves.
+    // Providers might outlive us, e.g., if still referenced by a session, and thus
+    // must not refer back to the engine.
+    StateTrackingProvider::Dispatcher provider_dispatcher;
+    if (dispatcher)
+    {
+        auto d = dispatcher; auto lt = lifetime;
+        provider_dispatcher = [d, lt](std::function<void()> task) { Engine::dispatch(d, lt, task); };
+    }
+
+    auto provider = std::make_shared<StateTrackingProvider>(impl, provider_dispatcher);
+    // Sessions coming and going in quick succession should not restart the provider every time.
+    provider->set_linger_period(configuration.provider_linger_period.get());
 
     // We synchronize to the engine state.
     if (provider->requires(Provider::Requirements::satellites) && configuration.satellite_based_positioning_state == SatelliteBasedPositioningState::off)
@@ -153,6 +370,11 @@ void cul::Engine::add_provider(const cul::Provider::Ptr& impl)
     if (configuration.engine_state == Engine::Status::off)
         provider->state_controller()->disable();
 
+    // Providers added after a fix is known, e.g., one restored from settings,
+    // get to see it right away.
+    if (updates.last_known_location.get())
+        provider->on_reference_location_updated(*updates.last_known_location.get());
+
     // We wire up changes in the engine's configuration to the respective slots
     // of the provider.
     auto cp = updates.last_known_location.changed().connect([provider](const cul::Optional<cul::Update<cul::Position>>& pos)
@@ -163,17 +385,22 @@ void cul::Engine::add_provider(const cul::Provider::Ptr& impl)
         }
     });
 
-    auto cv = updates.last_known_velocity.changed().connect([provider](const cul::Optional<cul::Update<cul::Velocity>>& velocity)
+    // Only satellite-based providers make use of reference velocity and heading to aid
+    // their fix. Everybody else would just be bothered, remote providers even with a
+    // round-trip across the bus for every update.
+    auto wants_reference_motion = provider->requires(Provider::Requirements::satellites);
+
+    auto cv = updates.last_known_velocity.changed().connect([provider, wants_reference_motion](const cul::Optional<cul::Update<cul::Velocity>>& velocity)
     {
-        if (velocity)
+        if (velocity && wants_reference_motion)
         {
             provider->on_reference_velocity_updated(velocity.get());
         }
     });
 
-    auto ch = updates.last_known_heading.changed().connect([provider](const cul::Optional<cul::Update<cul::Heading>>& heading)
+    auto ch = updates.last_known_heading.changed().connect([provider, wants_reference_motion](const cul::Optional<cul::Update<cul::Heading>>& heading)
     {
-        if (heading)
+        if (heading && wants_reference_motion)
         {
             provider->on_reference_heading_updated(heading.get());
         }
@@ -187,15 +414,7 @@ void cul::Engine::add_provider(const cul::Provider::Ptr& impl)
     // And do the reverse: Satellite visibility updates are funneled via the engine's configuration.
     auto cs = provider->updates().svs.connect([this](const cul::Update<std::set<cul::SpaceVehicle>>& src)
     {
-        updates.visible_space_vehicles.update([src](std::map<cul::SpaceVehicle::Key, cul::SpaceVehicle>& dest)
-        {
-            for(auto& sv : src.value)
-            {
-                dest[sv.key] = sv;
-            }
-
-            return true;
-        });
+        on_space_vehicles_reported(src);
     });
 
     // We are a bit dumb and just take any position update as new reference.
@@ -205,25 +424,304 @@ void cul::Engine::add_provider(const cul::Provider::Ptr& impl)
         updates.last_known_location = update_policy->verify_update(src);
     });
 
+    // Batches are processed in one go, the update policy still sees every sample.
+    auto cpb = provider->updates().position_batch.connect([this](const std::vector<cul::Update<cul::Position>>& batch)
+    {
+        if (batch.empty())
+            return;
+
+        cul::Update<cul::Position> verified;
+        for (const auto& update : batch)
+            verified = update_policy->verify_update(update);
+
+        updates.last_known_location = verified;
+    });
+
+    // Velocity and heading are subject to the same policy as positions.
+    auto cpv = provider->updates().velocity.connect([this](const cul::Update<cul::Velocity>& src)
+    {
+        updates.last_known_velocity = update_policy->verify_update(src);
+    });
+
+    auto cph = provider->updates().heading.connect([this](const cul::Update<cul::Heading>& src)
+    {
+        updates.last_known_heading = update_policy->verify_update(src);
+    });
+
+    // Providers starting and stopping, lingering included, do not affect selections.
     auto cps = provider->state().changed().connect([this](const StateTrackingProvider::State&)
     {
-        bool is_any_active = false;
+        dispatch([this]()
+        {
+            bool is_any_active = false;
 
-        std::lock_guard<std::recursive_mutex> lg(guard);
-        for (const auto& pair : providers)
-            is_any_active = pair.first->state() == StateTrackingProvider::State::active;
+            auto registry = provider_registry();
+            for (const auto& pair : *registry)
+                is_any_active = pair.first->state() == StateTrackingProvider::State::active;
 
-        configuration.engine_state = is_any_active ? Engine::Status::active : Engine::Status::on;
+            configuration.engine_state = is_any_active ? Engine::Status::active : Engine::Status::on;
+        });
     });
 
-    std::lock_guard<std::recursive_mutex> lg(guard);
-    providers.emplace(provider, std::move(ProviderConnections{cp, ch, cv, cr, cs, cpr, cps}));
+    // Selections made while the provider was (un)available are stale now.
+    auto ca = provider->available().changed().connect([this](bool)
+    {
+        invalidate_provider_selections();
+    });
+
+    auto connections = std::make_shared<ProviderConnections>(ProviderConnections{cp, cv, ch, cr, cs, cpr, cpb, cpv, cph, cps, ca});
+
+    // Publish a new version of the registry. Readers holding on to the previous
+    // snapshot are not affected.
+    std::lock_guard<std::mutex> lg(guard);
+    auto registry = std::make_shared<ProviderRegistry>(*provider_registry());
+    registry->emplace(provider, connections);
+    std::atomic_store(&providers, std::shared_ptr<const ProviderRegistry>{registry});
+
+    // Sessions created from now on should see the new provider, too.
+    {
+        std::lock_guard<std::mutex> lg(fusion.guard);
+        fusion.stages.clear();
+    }
+
+    invalidate_provider_selections();
+}
+
+cul::Provider::Ptr cul::Engine::shared_fusion_provider() const
+{
+    std::set<cul::Provider::Ptr> bag;
+    for_each_provider([&bag](const cul::Provider::Ptr& provider)
+    {
+        bag.insert(provider);
+    });
+
+    return shared_fusion_provider_for(bag);
+}
+
+cul::Provider::Ptr cul::Engine::shared_fusion_provider_for(const std::set<cul::Provider::Ptr>& providers) const
+{
+    std::lock_guard<std::mutex> lg(fusion.guard);
+
+    auto it = fusion.stages.find(providers);
+    if (it != fusion.stages.end())
+        if (auto provider = it->second.lock())
+            return provider;
+
+    // Stages released by their last session are of no use anymore.
+    for (auto jt = fusion.stages.begin(); jt != fusion.stages.end();)
+        jt = jt->second.expired() ? fusion.stages.erase(jt) : std::next(jt);
+
+    cul::Provider::Ptr provider = std::make_shared<cul::FusionProvider>(providers, std::make_shared<cul::NewerOrMoreAccurateUpdateSelector>());
+    fusion.stages[providers] = provider;
+
+    return provider;
+}
+
+std::map<cul::Provider::Ptr, cul::StateTrackingProvider::Statistics> cul::Engine::provider_statistics() const
+{
+    std::map<cul::Provider::Ptr, cul::StateTrackingProvider::Statistics> result;
+
+    auto registry = provider_registry();
+    for (const auto& pair : *registry)
+        result[pair.first] = pair.first->statistics();
+
+    return result;
+}
+
+std::shared_ptr<const cul::Engine::ProviderRegistry> cul::Engine::provider_registry() const
+{
+    return std::atomic_load(&providers);
+}
+
+void cul::Engine::on_space_vehicles_reported(const cul::Update<std::set<cul::SpaceVehicle>>& src)
+{
+    std::lock_guard<std::mutex> lg(space_vehicle_guard);
+
+    updates.visible_space_vehicles.update([this, &src](std::map<cul::SpaceVehicle::Key, cul::SpaceVehicle>& dest)
+    {
+        bool changed = false;
+
+        for (const auto& sv : src.value)
+        {
+            space_vehicles_last_seen[sv.key] = src.when;
+
+            auto it = dest.find(sv.key);
+            if (it == dest.end() || not (it->second == sv))
+            {
+                dest[sv.key] = sv;
+                changed = true;
+            }
+        }
+
+        return age_out_space_vehicles_locked(src.when, dest) || changed;
+    });
+
+    schedule_space_vehicle_expiry_locked();
+}
+
+void cul::Engine::expire_space_vehicles()
+{
+    std::lock_guard<std::mutex> lg(space_vehicle_guard);
+
+    auto now = cul::Clock::now();
+    updates.visible_space_vehicles.update([this, now](std::map<cul::SpaceVehicle::Key, cul::SpaceVehicle>& dest)
+    {
+        return age_out_space_vehicles_locked(now, dest);
+    });
+
+    schedule_space_vehicle_expiry_locked();
+}
+
+bool cul::Engine::age_out_space_vehicles_locked(const cul::Clock::Timestamp& now, std::map<cul::SpaceVehicle::Key, cul::SpaceVehicle>& dest)
+{
+    auto max_age = configuration.space_vehicle_max_age.get();
+    bool changed = false;
+
+    // Age out space vehicles that no provider reported recently.
+    for (auto it = space_vehicles_last_seen.begin(); it != space_vehicles_last_seen.end();)
+    {
+        if (now - it->second > max_age)
+        {
+            dest.erase(it->first);
+            it = space_vehicles_last_seen.erase(it);
+            changed = true;
+        } else
+        {
+            ++it;
+        }
+    }
+
+    return changed;
+}
+
+void cul::Engine::schedule_space_vehicle_expiry_locked()
+{
+    if (space_vehicles_last_seen.empty())
+    {
+        space_vehicle_expiry.cancel();
+        return;
+    }
+
+    auto oldest = space_vehicles_last_seen.begin()->second;
+    for (const auto& pair : space_vehicles_last_seen)
+        oldest = std::min(oldest, pair.second);
+
+    // We round up, such that the oldest space vehicle is stale by the time we check.
+    auto due = oldest + configuration.space_vehicle_max_age.get() - cul::Clock::now();
+    auto delay = std::max(std::chrono::milliseconds{0}, std::chrono::duration_cast<std::chrono::milliseconds>(due)) + std::chrono::milliseconds{1};
+
+    space_vehicle_expiry.schedule(delay, [this]()
+    {
+        dispatch([this]() { expire_space_vehicles(); });
+    });
+}
+
+void cul::Engine::dispatch(const std::function<void()>& task)
+{
+    if (not dispatcher)
+    {
+        task();
+        return;
+    }
+
+    dispatch(dispatcher, lifetime, task);
+}
+
+void cul::Engine::dispatch(const cul::Engine::Dispatcher& dispatcher,
+                           const std::shared_ptr<cul::Engine::Lifetime>& lifetime,
+                           const std::function<void()>& task)
+{
+    auto lt = lifetime;
+    dispatcher([lt, task]()
+    {
+        {
+            std::lock_guard<std::mutex> lg(lt->guard);
+            if (not lt->alive)
+                return;
+            lt->running++;
+        }
+
+        // We do not hold the guard while running the task, a slow task must
+        // not block the engine from going away longer than necessary.
+        struct Scope
+        {
+            ~Scope()
+            {
+                std::lock_guard<std::mutex> lg(lt->guard);
+                lt->running--;
+                lt->cv.notify_all();
+            }
+
+            std::shared_ptr<Lifetime> lt;
+        } scope{lt};
+
+        task();
+    });
+}
+
+void cul::Engine::restore_last_known_location()
+{
+    auto value = settings->get_string_for_key(Configuration::Keys::last_known_location, std::string{});
+
+    if (value.empty())
+        return;
+
+    auto restored = decode_last_known_location(value);
+
+    if (not restored)
+    {
+        LOG(WARNING) << "Ignoring malformed last known location: " << value;
+        return;
+    }
+
+    if (restored->second > Configuration::Defaults::last_known_location_max_age)
+        return;
+
+    // The fix keeps its age, such that its staleness is apparent to consumers.
+    cul::Update<cul::Position> update{restored->first, cul::Clock::now() - restored->second};
+    {
+        std::lock_guard<std::mutex> lg(persisted.guard);
+        persisted.location = update;
+    }
+    updates.last_known_location = update;
+
+    VLOG(1) << "Restored last known location " << update.value << " of age " << restored->second.count() << " [ms]";
+}
+
+void cul::Engine::persist_last_known_location(const cul::Update<cul::Position>& update)
+{
+    std::lock_guard<std::mutex> lg(persisted.guard);
+
+    if (persisted.location)
+    {
+        auto elapsed = update.when - persisted.location->when;
+
+        if (elapsed < last_known_location_min_period)
+            return;
+
+        if (elapsed < last_known_location_refresh_period)
+        {
+            const auto& lhs = update.value.accuracy.horizontal;
+            const auto& rhs = persisted.location->value.accuracy.horizontal;
+
+            bool more_accurate = lhs && (not rhs || *lhs < *rhs);
+            bool moved = cul::haversine_distance(update.value, persisted.location->value).value() >= last_known_location_min_distance_in_meters;
+
+            if (not more_accurate && not moved)
+                return;
+        }
+    }
+
+    if (settings->set_string_for_key(Configuration::Keys::last_known_location, encode_last_known_location(update)))
+        persisted.location = update;
 }
 
 void cul::Engine::for_each_provider(const std::function<void(const Provider::Ptr&)>& enumerator) const noexcept
 {
-    std::lock_guard<std::recursive_mutex> lg(guard);
-    for (const auto& provider : providers)
+    // We iterate a snapshot, such that enumerators are free to call back into
+    // the engine, and do not contend with threads adding providers.
+    auto registry = provider_registry();
+    for (const auto& provider : *registry)
     {
         try
         {
@@ -27,12 +27,21 @@
 #include <com/ubuntu/location/state_tracking_provider.h>
 #include <com/ubuntu/location/wifi_and_cell_reporting_state.h>
 
+#include <com/ubuntu/location/service/runtime.h>
 #include <com/ubuntu/location/settings.h>
 
 #include <core/property.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <set>
+#include <tuple>
 
 #include "update_policy.h"
 
@@ -53,6 +62,11 @@ class Engine : public ProviderEnumerator
 public:
     typedef std::shared_ptr<Engine> Ptr;
 
+    /**
+     * @brief Executes tasks in order, e.g., on a service::Runtime strand.
+     */
+    typedef std::function<void(std::function<void()>)> Dispatcher;
+
     /**
      * @brief The State enum models the current state of the engine
      */
@@ -86,6 +100,16 @@ public:
             {
                 "Engine::State"
             };
+            /** Key for selecting the policy for verifying updates, either "TimeBased" or "Kalman" */
+            static constexpr const char* update_policy
+            {
+                "Engine::UpdatePolicy"
+            };
+            /** Key for persisting the last known location across restarts */
+            static constexpr const char* last_known_location
+            {
+                "Engine::LastKnownLocation"
+            };
         };
 
         /** Default values go here. */
@@ -105,6 +129,21 @@ public:
             {
                 Engine::Status::on
             };
+
+            static constexpr const std::chrono::seconds space_vehicle_max_age
+            {
+                10
+            };
+
+            static constexpr const std::chrono::seconds provider_linger_period
+            {
+                5
+            };
+
+            static constexpr const std::chrono::seconds last_known_location_max_age
+            {
+                24 * 60 * 60
+            };
         };
 
         /** Setable/getable/observable property for the satellite based positioning state. */
@@ -122,6 +161,16 @@ public:
         {
             Defaults::engine_state
         };
+        /** Space vehicles not reported by any provider for this period are considered invisible. */
+        core::Property<std::chrono::seconds> space_vehicle_max_age
+        {
+            Defaults::space_vehicle_max_age
+        };
+        /** Providers keep running for this period after the last session stopped updates. */
+        core::Property<std::chrono::seconds> provider_linger_period
+        {
+            Defaults::provider_linger_period
+        };
     };
 
     /** @brief Summarizes all updates delivered via the engine. */
@@ -140,12 +189,31 @@ public:
     Engine(const ProviderSelectionPolicy::Ptr& provider_selection_policy,
            const Settings::Ptr& settings);
 
+    /**
+     * @brief Creates an engine that handles all provider events on the given dispatcher.
+     *
+     * Providers hand over their events and return immediately. The engine
+     * processes the events one after the other, in the order they were received,
+     * and hands out provider updates to sessions from the dispatcher, too. Tasks
+     * still pending once the engine is destroyed are skipped, destruction waits
+     * for a task that is running.
+     */
+    Engine(const ProviderSelectionPolicy::Ptr& provider_selection_policy,
+           const Settings::Ptr& settings,
+           const Dispatcher& dispatcher);
+
     Engine(const Engine&) = delete;
     Engine& operator=(const Engine&) = delete;
     virtual ~Engine();
 
     /**
      * @brief Calculates a set of providers that satisfies the given criteria.
+     *
+     * Selections are cached per criteria until a provider is added, a provider
+     * changes its state, or the engine or satellite configuration changes. The
+     * cache does not keep the selected providers alive, and a selection is
+     * calculated anew once any of its providers is gone.
+     *
      * @param [in] criteria The criteria to be satisfied by the returned provider selection.
      * @return A provider selection that satisfies the given criteria.
      */
@@ -163,6 +231,29 @@ public:
      */
     virtual void for_each_provider(const std::function<void(const Provider::Ptr&)>& enumerator) const noexcept;
 
+    /**
+     * @brief Returns the fusion stage covering all known providers.
+     *
+     * The stage is shared by all sessions, each one of them only holding a thin
+     * view onto it. It is created on demand and released when the last session
+     * referring to it goes away. Sessions created after a provider has been added
+     * share a new stage covering the new provider, too.
+     */
+    Provider::Ptr shared_fusion_provider() const override;
+
+    /**
+     * @brief Returns the fusion stage covering the given providers.
+     *
+     * Stages are shared and released just like the one covering all providers.
+     */
+    Provider::Ptr shared_fusion_provider_for(const std::set<Provider::Ptr>& providers) const override;
+
+    /**
+     * @brief Returns a snapshot of the start/stop and time to first fix statistics
+     * of all known providers, keyed on the providers handed out by for_each_provider.
+     */
+    std::map<Provider::Ptr, StateTrackingProvider::Statistics> provider_statistics() const;
+
     /** @brief The engine's configuration. */
     Configuration configuration;
 
@@ -178,14 +269,130 @@ private:
         core::ScopedConnection wifi_and_cell_id_reporting_state_updates;
         core::ScopedConnection space_vehicle_visibility_updates;
         core::ScopedConnection provider_position_updates;
+        core::ScopedConnection provider_position_batch_updates;
+        core::ScopedConnection provider_velocity_updates;
+        core::ScopedConnection provider_heading_updates;
         core::ScopedConnection provider_state_updates;
+        core::ScopedConnection provider_availability_updates;
+    };
+
+    // Providers are registered rarely but enumerated often, and from many threads.
+    // We thus keep an immutable snapshot of the registry that readers atomically
+    // load without locking. Writers, serialized by guard, publish a new version.
+    typedef std::map<StateTrackingProvider::Ptr, std::shared_ptr<ProviderConnections>> ProviderRegistry;
+
+    // Returns the current snapshot of the registry.
+    std::shared_ptr<const ProviderRegistry> provider_registry() const;
+
+    // Provider selection only depends on the requirements and accuracies of
+    // criteria, which we normalize into this key. Unset accuracies map to -1.
+    typedef std::tuple<bool, bool, bool, bool, double, double, double, double> SelectionKey;
+
+    // Normalizes criteria into a key of the selection cache.
+    static SelectionKey selection_key_for_criteria(const Criteria& criteria);
+
+    // Refers to a selected provider without keeping it alive.
+    struct WeakSelection
+    {
+        // True iff a provider has been selected at all.
+        bool selected;
+        std::weak_ptr<Provider> provider;
     };
 
-    mutable std::recursive_mutex guard;
-    std::map<StateTrackingProvider::Ptr, ProviderConnections> providers;
+    // A cached provider selection. Sessions keep their providers alive, the cache
+    // does not, such that the shared fusion stage goes away with the last session.
+    struct CachedSelection
+    {
+        WeakSelection position;
+        WeakSelection heading;
+        WeakSelection velocity;
+        WeakSelection coarse_position;
+    };
+
+    // Captures selection for caching it.
+    static CachedSelection cache_provider_selection(const ProviderSelection& selection);
+    // Restores a cached selection into selection. Returns false if any of
+    // the selected providers is gone.
+    static bool restore_provider_selection(const CachedSelection& cached, ProviderSelection& selection);
+
+    // Drops all cached provider selections.
+    void invalidate_provider_selections();
+
+    // Merges the space vehicles reported by a provider into the set of visible space
+    // vehicles, and ages out space vehicles that have not been reported recently.
+    void on_space_vehicles_reported(const Update<std::set<SpaceVehicle>>& update);
+    // Removes space vehicles not reported within the configured max age.
+    void expire_space_vehicles();
+    // Removes the entries of dest last seen longer than the configured max age before now,
+    // returning true if any entry has been removed. space_vehicle_guard must be held.
+    bool age_out_space_vehicles_locked(const Clock::Timestamp& now, std::map<SpaceVehicle::Key, SpaceVehicle>& dest);
+    // Schedules expire_space_vehicles for when the oldest space vehicle becomes stale.
+    // space_vehicle_guard must be held.
+    void schedule_space_vehicle_expiry_locked();
+
+    struct Lifetime;
+
+    // Hands task to the dispatcher, or executes it inline if no dispatcher is configured.
+    void dispatch(const std::function<void()>& task);
+    // Hands task to dispatcher, skipping it if lifetime has ended by the time it is executed.
+    static void dispatch(const Dispatcher& dispatcher, const std::shared_ptr<Lifetime>& lifetime, const std::function<void()>& task);
+
+    // Reloads the persisted last known location, unless it is older than
+    // Defaults::last_known_location_max_age.
+    void restore_last_known_location();
+
+    // Persists update if it is more accurate than or far enough away from the
+    // fix persisted last, or if the fix persisted last is getting stale. Updates
+    // following the fix persisted last too closely are never persisted.
+    void persist_last_known_location(const Update<Position>& update);
+
+    std::mutex guard;
+    std::shared_ptr<const ProviderRegistry> providers;
+    // Caches provider selections. The generation is bumped on invalidation, such
+    // that selections calculated concurrently with an invalidation are not cached.
+    struct
+    {
+        std::mutex guard;
+        std::uint64_t generation{0};
+        std::map<SelectionKey, CachedSelection> entries;
+    } selections;
+    // Whether the engine has been switched off last, selections are invalidated when
+    // switching off or back on.
+    std::atomic<bool> engine_off{false};
+    // The fusion stages shared by all sessions, keyed on the providers they cover.
+    // We do not keep them alive ourselves.
+    mutable struct
+    {
+        std::mutex guard;
+        std::map<std::set<Provider::Ptr>, std::weak_ptr<Provider>> stages;
+    } fusion;
+    // Guards updates to the set of visible space vehicles.
+    std::mutex space_vehicle_guard;
+    // Tracks when a space vehicle has last been reported, for ageing out stale entries.
+    std::map<SpaceVehicle::Key, Clock::Timestamp> space_vehicles_last_seen;
+    // Ages out space vehicles once they are stale, even if no further reports arrive.
+    service::Timer space_vehicle_expiry;
     ProviderSelectionPolicy::Ptr provider_selection_policy;
     Settings::Ptr settings;
+    // The fix handed to settings last. Updates arrive on multiple threads.
+    struct
+    {
+        std::mutex guard;
+        Optional<Update<Position>> location;
+    } persisted;
     UpdatePolicy::Ptr update_policy;
+    Dispatcher dispatcher;
+    // Tasks check alive before running, such that tasks still pending on the dispatcher
+    // are skipped once the engine is gone. Tasks run without holding guard, ~Engine waits
+    // for the ones in flight to finish.
+    struct Lifetime
+    {
+        std::mutex guard;
+        std::condition_variable cv;
+        bool alive{true};
+        std::size_t running{0};
+    };
+    std::shared_ptr<Lifetime> lifetime;
 };
 
 /** @brief Pretty prints the given status to the given stream. */
@@ -62,6 +62,33 @@ cul::FusionProvider::FusionProvider(const std::set<location::Provider::Ptr>& pro
                       }
                   }
               }));
+        connections.push_back(provider->updates().position_batch.connect(
+              [this, provider, update_selector](const std::vector<cul::Update<cul::Position>>& batch)
+              {
+                  if (batch.empty())
+                      return;
+
+                  // The most recent sample of the batch competes with the
+                  // current position on behalf of the whole batch.
+                  WithSource<Update<Position>> candidate{provider, batch.back()};
+
+                  try
+                  {
+                      last_position = last_position ? update_selector->select(*last_position, candidate) : candidate;
+                  } catch (const std::exception& e)
+                  {
+                      LOG(WARNING) << "Error while updating position";
+                      return;
+                  }
+
+                  // We only hand on the batch if the selector went for it, and
+                  // report the position that won otherwise, just like for
+                  // individual updates.
+                  if (last_position->source == provider && last_position->value == candidate.value)
+                      mutable_updates().position_batch(batch);
+                  else
+                      mutable_updates().position(last_position->value);
+              }));
         connections.push_back(provider->updates().heading.connect(
               [this](const cul::Update<cul::Heading>& u)
               {
@@ -142,3 +169,11 @@ void cul::FusionProvider::stop_velocity_updates()
     for (auto provider : providers)
         provider->state_controller()->stop_velocity_updates();
 }
+
+void cul::FusionProvider::set_update_interval(const cul::Optional<std::chrono::milliseconds>& interval)
+{
+    for (auto provider : providers)
+        provider->state_controller()->replace_update_interval(update_interval, interval);
+
+    update_interval = interval;
+}
@@ -4,23 +4,77 @@
 
 namespace location = com::ubuntu::location;
 
+namespace
+{
+// Prefers a fusion stage shared with all other sessions, falling back to a new one.
+location::Provider::Ptr shared_or_new_fusion_provider_for(
+        const location::ProviderEnumerator& enumerator,
+        const std::set<location::Provider::Ptr>& providers)
+{
+    if (auto provider = enumerator.shared_fusion_provider_for(providers))
+        return provider;
+
+    return std::make_shared<location::FusionProvider>(providers, std::make_shared<location::NewerOrMoreAccurateUpdateSelector>());
+}
+}
+
+location::FusionProviderSelectionPolicy::FusionProviderSelectionPolicy()
+    : FusionProviderSelectionPolicy(false)
+{
+}
+
+location::FusionProviderSelectionPolicy::FusionProviderSelectionPolicy(bool hedge_position_updates)
+    : hedge_position_updates(hedge_position_updates)
+{
+}
+
 location::ProviderSelection location::FusionProviderSelectionPolicy::determine_provider_selection_for_criteria(
         const location::Criteria&,
         const location::ProviderEnumerator& enumerator)
 {
-    // We put all providers in a set.
-    std::set<location::Provider::Ptr> bag;
-    enumerator.for_each_provider([&bag](const location::Provider::Ptr& provider)
+    // We prefer a fusion stage shared with all other sessions.
+    auto fusion_providers = enumerator.shared_fusion_provider();
+
+    if (not fusion_providers)
     {
-        bag.insert(provider);
-    });
+        // We put all providers in a set.
+        std::set<location::Provider::Ptr> bag;
+        enumerator.for_each_provider([&bag](const location::Provider::Ptr& provider)
+        {
+            bag.insert(provider);
+        });
 
-    auto fusion_providers = std::make_shared<location::FusionProvider>(bag, std::make_shared<location::NewerOrMoreAccurateUpdateSelector>());
+        fusion_providers = std::make_shared<location::FusionProvider>(bag, std::make_shared<location::NewerOrMoreAccurateUpdateSelector>());
+    }
 
-    return location::ProviderSelection
+    location::ProviderSelection selection
     {
         fusion_providers, // position
         fusion_providers, // heading
         fusion_providers, // velocity
+        location::Provider::Ptr{} // coarse position
     };
+
+    if (not hedge_position_updates)
+        return selection;
+
+    // Fast but coarse providers only run until the precise ones delivered an accurate fix.
+    std::set<location::Provider::Ptr> precise, coarse;
+    enumerator.for_each_provider([&precise, &coarse](const location::Provider::Ptr& provider)
+    {
+        if (provider->supports(location::Provider::Features::position) &&
+            not provider->requires(location::Provider::Requirements::satellites))
+            coarse.insert(provider);
+        else
+            precise.insert(provider);
+    });
+
+    // There is nothing to hedge against.
+    if (precise.empty() || coarse.empty())
+        return selection;
+
+    selection.position_updates_provider = shared_or_new_fusion_provider_for(enumerator, precise);
+    selection.coarse_position_updates_provider = shared_or_new_fusion_provider_for(enumerator, coarse);
+
+    return selection;
 }
@@ -0,0 +1,287 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kalman_update_policy.h"
+
+#include <cmath>
+
+namespace com
+{
+namespace ubuntu
+{
+namespace location
+{
+
+namespace
+{
+// Mean radius of the earth in [m].
+constexpr double radius_of_earth{6371000.};
+// The local frame is recentered once the estimate is this far away from its origin, in [m].
+constexpr double max_distance_from_origin{10000.};
+// Velocity updates are only fused with headings at most this far apart.
+constexpr std::chrono::seconds max_heading_age{5};
+
+constexpr double radians(double degrees)
+{
+    return degrees * M_PI / 180.;
+}
+
+constexpr double degrees(double radians)
+{
+    return radians * 180. / M_PI;
+}
+
+double seconds(const Clock::Duration& duration)
+{
+    return std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+}
+}
+
+KalmanUpdatePolicy::KalmanUpdatePolicy() : KalmanUpdatePolicy(Configuration{})
+{
+}
+
+KalmanUpdatePolicy::KalmanUpdatePolicy(const Configuration& configuration)
+    : configuration(configuration)
+{
+}
+
+const location::Update<location::Position>& KalmanUpdatePolicy::verify_update(const location::Update<location::Position>& update)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (not initialized || update.when - when > configuration.reset_after)
+    {
+        reset(update);
+        return position_estimate;
+    }
+
+    // We do not rewind the filter for out-of-order updates.
+    if (update.when < when)
+        return position_estimate;
+
+    predict(seconds(update.when - when));
+    when = update.when;
+
+    auto sigma = update.value.accuracy.horizontal ?
+                update.value.accuracy.horizontal->value() :
+                configuration.default_horizontal_accuracy;
+
+    auto east = radius_of_earth * std::cos(radians(origin.latitude)) * radians(update.value.longitude.value.value() - origin.longitude);
+    auto north = radius_of_earth * radians(update.value.latitude.value.value() - origin.latitude);
+
+    if (not correct(0, east, north, sigma * sigma))
+    {
+        // A sequence of outliers hints at the estimate having diverged,
+        // e.g., after a provider lost and reacquired its fix.
+        if (++consecutive_outliers >= configuration.max_consecutive_outliers)
+            reset(update);
+
+        return position_estimate;
+    }
+
+    consecutive_outliers = 0;
+    recenter();
+    publish(update);
+
+    return position_estimate;
+}
+
+const location::Update<location::Heading>& KalmanUpdatePolicy::verify_update(const location::Update<location::Heading>& update)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    last_heading = update;
+    return update;
+}
+
+const location::Update<location::Velocity>& KalmanUpdatePolicy::verify_update(const location::Update<location::Velocity>& update)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (not initialized || not last_heading)
+        return update;
+
+    auto age = update.when - last_heading->when;
+    if (age > max_heading_age || age < -max_heading_age)
+        return update;
+
+    if (update.when > when)
+    {
+        predict(seconds(update.when - when));
+        when = update.when;
+    }
+
+    auto speed = update.value.value();
+    auto heading = radians(last_heading->value.value());
+    auto sigma = configuration.velocity_noise;
+
+    if (not correct(2, speed * std::sin(heading), speed * std::cos(heading), sigma * sigma))
+        return update;
+
+    velocity_estimate = location::Update<location::Velocity>
+    {
+        std::hypot(x[2], x[3]) * units::MetersPerSecond,
+        update.when
+    };
+
+    return velocity_estimate;
+}
+
+void KalmanUpdatePolicy::reset(const location::Update<location::Position>& update)
+{
+    auto sigma = update.value.accuracy.horizontal ?
+                update.value.accuracy.horizontal->value() :
+                configuration.default_horizontal_accuracy;
+
+    origin.latitude = update.value.latitude.value.value();
+    origin.longitude = update.value.longitude.value.value();
+
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        x[i] = 0.;
+        for (std::size_t j = 0; j < 4; j++)
+            P[i][j] = 0.;
+    }
+
+    // We know nothing about the velocity, yet. We assume that the device
+    // is moving at most at highway speed.
+    P[0][0] = P[1][1] = sigma * sigma;
+    P[2][2] = P[3][3] = 30. * 30.;
+
+    when = update.when;
+    consecutive_outliers = 0;
+    initialized = true;
+
+    position_estimate = update;
+}
+
+void KalmanUpdatePolicy::predict(double dt)
+{
+    // x' = F x with F = [I dt*I; 0 I].
+    x[0] += dt * x[2];
+    x[1] += dt * x[3];
+
+    // P' = F P F^T + Q, expanded for the block structure of F.
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        P[0][i] += dt * P[2][i];
+        P[1][i] += dt * P[3][i];
+    }
+
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        P[i][0] += dt * P[i][2];
+        P[i][1] += dt * P[i][3];
+    }
+
+    // Discretized white noise acceleration, applied per axis.
+    auto q = configuration.acceleration_noise;
+    auto q_pp = q * dt * dt * dt / 3.;
+    auto q_pv = q * dt * dt / 2.;
+    auto q_vv = q * dt;
+
+    for (std::size_t axis = 0; axis < 2; axis++)
+    {
+        P[axis][axis] += q_pp;
+        P[axis][axis + 2] += q_pv;
+        P[axis + 2][axis] += q_pv;
+        P[axis + 2][axis + 2] += q_vv;
+    }
+}
+
+bool KalmanUpdatePolicy::correct(std::size_t offset, double z0, double z1, double r)
+{
+    auto a = offset, b = offset + 1;
+
+    // Innovation and its covariance S = H P H^T + R.
+    double y[2] = {z0 - x[a], z1 - x[b]};
+    double s00 = P[a][a] + r, s01 = P[a][b], s10 = P[b][a], s11 = P[b][b] + r;
+
+    auto det = s00 * s11 - s01 * s10;
+    if (det <= 0.)
+        return false;
+
+    double si00 = s11 / det, si01 = -s01 / det, si10 = -s10 / det, si11 = s00 / det;
+
+    auto d2 = y[0] * (si00 * y[0] + si01 * y[1]) + y[1] * (si10 * y[0] + si11 * y[1]);
+    if (d2 > configuration.outlier_gate)
+        return false;
+
+    // K = P H^T S^-1
+    double K[4][2];
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        K[i][0] = P[i][a] * si00 + P[i][b] * si10;
+        K[i][1] = P[i][a] * si01 + P[i][b] * si11;
+    }
+
+    for (std::size_t i = 0; i < 4; i++)
+        x[i] += K[i][0] * y[0] + K[i][1] * y[1];
+
+    // P = (I - K H) P, using the rows of P selected by H.
+    double Pa[4], Pb[4];
+    for (std::size_t j = 0; j < 4; j++)
+    {
+        Pa[j] = P[a][j];
+        Pb[j] = P[b][j];
+    }
+
+    for (std::size_t i = 0; i < 4; i++)
+        for (std::size_t j = 0; j < 4; j++)
+            P[i][j] -= K[i][0] * Pa[j] + K[i][1] * Pb[j];
+
+    // Keep P symmetric in the presence of rounding errors.
+    for (std::size_t i = 0; i < 4; i++)
+        for (std::size_t j = i + 1; j < 4; j++)
+            P[i][j] = P[j][i] = (P[i][j] + P[j][i]) / 2.;
+
+    return true;
+}
+
+void KalmanUpdatePolicy::recenter()
+{
+    if (std::fabs(x[0]) < max_distance_from_origin && std::fabs(x[1]) < max_distance_from_origin)
+        return;
+
+    // The current state is expressed relative to the previous origin, and so is its projection.
+    auto latitude = origin.latitude + degrees(x[1] / radius_of_earth);
+    auto longitude = origin.longitude + degrees(x[0] / (radius_of_earth * std::cos(radians(origin.latitude))));
+
+    origin.latitude = latitude;
+    origin.longitude = longitude;
+    x[0] = x[1] = 0.;
+}
+
+void KalmanUpdatePolicy::publish(const location::Update<location::Position>& update)
+{
+    position_estimate = update;
+
+    auto latitude = origin.latitude + degrees(x[1] / radius_of_earth);
+    auto longitude = origin.longitude + degrees(x[0] / (radius_of_earth * std::cos(radians(origin.latitude))));
+
+    position_estimate.value.latitude = wgs84::Latitude{latitude * units::Degrees};
+    position_estimate.value.longitude = wgs84::Longitude{longitude * units::Degrees};
+
+    // We report the standard deviation along the major axis of the error ellipse.
+    auto mean = (P[0][0] + P[1][1]) / 2.;
+    auto spread = std::sqrt(std::pow((P[0][0] - P[1][1]) / 2., 2) + P[0][1] * P[1][0]);
+    position_estimate.value.accuracy.horizontal = std::sqrt(mean + spread) * units::Meters;
+}
+
+}
+}
+}
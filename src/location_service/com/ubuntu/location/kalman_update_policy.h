@@ -0,0 +1,115 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LOCATION_SERVICE_UBUNTU_LOCATION_SERVICE_KALMAN_UPDATE_POLICY_H_
+#define LOCATION_SERVICE_UBUNTU_LOCATION_SERVICE_KALMAN_UPDATE_POLICY_H_
+
+#include <com/ubuntu/location/clock.h>
+#include <com/ubuntu/location/optional.h>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#include "update_policy.h"
+
+namespace com
+{
+namespace ubuntu
+{
+namespace location
+{
+
+// An UpdatePolicy that fuses position, velocity and heading updates from all providers
+// into a constant-velocity state estimate with covariance. The state is tracked in a local
+// east/north frame around a reference point that follows the estimate. Position updates
+// yield a smoothed fix whose horizontal accuracy reflects the estimate's covariance.
+// Updates that are inconsistent with the estimate are rejected as outliers.
+//
+// Every update is processed in constant time and without allocating memory.
+class KalmanUpdatePolicy : public UpdatePolicy {
+
+ public:
+    // Tuning parameters of the filter.
+    struct Configuration
+    {
+        // Spectral density of the white acceleration noise driving the model, in [m²/s³].
+        double acceleration_noise{1.};
+        // Standard deviation of velocity measurements, in [m/s].
+        double velocity_noise{1.};
+        // Horizontal accuracy assumed for fixes not reporting one, in [m].
+        double default_horizontal_accuracy{50.};
+        // Fixes with a squared Mahalanobis distance beyond the gate are rejected.
+        // 13.8 is the 99.9% quantile of a chi-square distribution with 2 degrees of freedom.
+        double outlier_gate{13.8};
+        // The filter is reset to the latest fix after this many consecutive outliers.
+        std::uint32_t max_consecutive_outliers{3};
+        // The filter is reset if no fix has been seen for this period.
+        std::chrono::seconds reset_after{120};
+    };
+
+    KalmanUpdatePolicy();
+    explicit KalmanUpdatePolicy(const Configuration& configuration);
+    KalmanUpdatePolicy(const KalmanUpdatePolicy&) = delete;
+    ~KalmanUpdatePolicy() = default;
+
+    // Fuses the position update and returns the resulting estimate.
+    const location::Update<location::Position>& verify_update(const location::Update<location::Position>& update) override;
+    // Remembers the heading for fusing subsequent velocity updates and returns it unaltered.
+    const location::Update<location::Heading>& verify_update(const location::Update<location::Heading>& update) override;
+    // Fuses the velocity update, if a recent heading is known, and returns the estimated speed.
+    const location::Update<location::Velocity>& verify_update(const location::Update<location::Velocity>& update) override;
+
+ private:
+    // Resets the state to the given fix.
+    void reset(const location::Update<location::Position>& update);
+    // Propagates state and covariance by dt seconds.
+    void predict(double dt);
+    // Corrects the state with a measurement (z0, z1) of the state components at offset,
+    // with variance r. Returns false if the measurement is rejected as outlier.
+    bool correct(std::size_t offset, double z0, double z1, double r);
+    // Moves the reference point to the current estimate if it drifted too far away.
+    void recenter();
+    // Assembles the estimate from the current state, taking over all other
+    // attributes from update.
+    void publish(const location::Update<location::Position>& update);
+
+    // Updates are delivered from different threads.
+    std::mutex guard;
+    Configuration configuration;
+    bool initialized{false};
+    // The reference point of the local frame, in [°].
+    struct
+    {
+        double latitude;
+        double longitude;
+    } origin{0., 0.};
+    // State: east, north [m], east and north velocity [m/s].
+    double x[4];
+    // Covariance of the state.
+    double P[4][4];
+    // Time of the state.
+    Clock::Timestamp when;
+    std::uint32_t consecutive_outliers{0};
+    Optional<location::Update<location::Heading>> last_heading;
+    location::Update<location::Position> position_estimate;
+    location::Update<location::Velocity> velocity_estimate;
+};
+
+}
+}
+}
+
+#endif //LOCATION_SERVICE_UBUNTU_LOCATION_SERVICE_KALMAN_UPDATE_POLICY_H_
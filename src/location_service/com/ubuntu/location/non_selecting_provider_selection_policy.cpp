@@ -42,6 +42,7 @@ location::ProviderSelection location::NonSelectingProviderSelectionPolicy::deter
     {
         bag_of_providers, // position
         bag_of_providers, // heading
-        bag_of_providers  // velocity
+        bag_of_providers, // velocity
+        location::Provider::Ptr{} // coarse position
     };
 }
@@ -130,6 +130,55 @@ bool cul::Provider::Controller::are_velocity_updates_running() const
     return velocity_updates_counter > 0;
 }
 
+void cul::Provider::Controller::request_update_interval(const std::chrono::milliseconds& interval)
+{
+    std::lock_guard<std::mutex> lg(update_interval_guard);
+
+    auto before = update_interval_requests.empty() ? Optional<std::chrono::milliseconds>{} : *update_interval_requests.begin();
+    update_interval_requests.insert(interval);
+
+    if (before != *update_interval_requests.begin())
+        instance.set_update_interval(*update_interval_requests.begin());
+}
+
+void cul::Provider::Controller::release_update_interval(const std::chrono::milliseconds& interval)
+{
+    std::lock_guard<std::mutex> lg(update_interval_guard);
+
+    auto it = update_interval_requests.find(interval);
+    if (it == update_interval_requests.end())
+        return;
+
+    auto before = *update_interval_requests.begin();
+    update_interval_requests.erase(it);
+
+    if (update_interval_requests.empty())
+        instance.set_update_interval(Optional<std::chrono::milliseconds>{});
+    else if (before != *update_interval_requests.begin())
+        instance.set_update_interval(*update_interval_requests.begin());
+}
+
+void cul::Provider::Controller::replace_update_interval(
+        const cul::Optional<std::chrono::milliseconds>& previous,
+        const cul::Optional<std::chrono::milliseconds>& next)
+{
+    // We request first, such that we never fall back to no request in between.
+    if (next)
+        request_update_interval(*next);
+    if (previous)
+        release_update_interval(*previous);
+}
+
+cul::Optional<std::chrono::milliseconds> cul::Provider::Controller::update_interval() const
+{
+    std::lock_guard<std::mutex> lg(update_interval_guard);
+
+    if (update_interval_requests.empty())
+        return Optional<std::chrono::milliseconds>{};
+
+    return *update_interval_requests.begin();
+}
+
 cul::Provider::Controller::Controller(cul::Provider& instance)
     : instance(instance),
       position_updates_counter(0),
@@ -143,6 +192,11 @@ const cul::Provider::Controller::Ptr& cul::Provider::state_controller() const
     return d.controller;
 }
 
+const core::Property<bool>& cul::Provider::available() const
+{
+    return d.available;
+}
+
 bool cul::Provider::supports(const cul::Provider::Features& f) const
 {
     return (d.features & f) != Features::none;
@@ -177,6 +231,11 @@ cul::Provider::Updates& cul::Provider::mutable_updates()
     return d.updates;
 }
 
+core::Property<bool>& cul::Provider::mutable_available()
+{
+    return d.available;
+}
+
 void cul::Provider::on_wifi_and_cell_reporting_state_changed(cul::WifiAndCellIdReportingState)
 {
 }
@@ -200,6 +259,8 @@ void cul::Provider::stop_heading_updates() {}
 void cul::Provider::start_velocity_updates() {}
 void cul::Provider::stop_velocity_updates() {}
 
+void cul::Provider::set_update_interval(const cul::Optional<std::chrono::milliseconds>&) {}
+
 cul::Provider::Features cul::operator|(cul::Provider::Features lhs, cul::Provider::Features rhs)
 {
     return static_cast<cul::Provider::Features>(static_cast<unsigned int>(lhs) | static_cast<unsigned int>(rhs));
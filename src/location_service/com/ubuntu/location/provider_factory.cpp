@@ -43,13 +43,12 @@ cul::Provider::Ptr cul::ProviderFactory::create_provider_for_name_with_config(
     const std::string& name, 
     const cul::ProviderFactory::Configuration& config)
 {
-    auto undecorated_name = extract_undecorated_name(name);
+    auto factory = factory_for_name(name);
 
-    std::lock_guard<std::mutex> lg(guard);
-    if (factory_store.count(undecorated_name) == 0)
+    if (not factory)
         return Provider::Ptr{};
-    
-    return cul::Provider::Ptr{factory_store.at(undecorated_name)(config)};
+
+    return cul::Provider::Ptr{factory(config)};
 }
 
 void cul::ProviderFactory::create_provider_for_name_with_config(
@@ -57,13 +56,12 @@ void cul::ProviderFactory::create_provider_for_name_with_config(
     const cul::ProviderFactory::Configuration& config,
     const std::function<void(Provider::Ptr)>& cb)
 {
-    auto undecorated_name = extract_undecorated_name(name);
+    auto factory = factory_for_name(name);
 
-    std::lock_guard<std::mutex> lg(guard);
-    if (factory_store.count(undecorated_name) == 0)
+    if (not factory)
         return;
 
-    cb(cul::Provider::Ptr{factory_store.at(undecorated_name)(config)});
+    cb(cul::Provider::Ptr{factory(config)});
 }
 
 void cul::ProviderFactory::enumerate(
@@ -79,6 +77,21 @@ void cul::ProviderFactory::enumerate(
         });
 }
 
+cul::ProviderFactory::Factory cul::ProviderFactory::factory_for_name(const std::string& name)
+{
+    auto undecorated_name = extract_undecorated_name(name);
+
+    // We only hold the lock while looking up the factory. Invoking the factory
+    // might take a considerable amount of time (e.g., waiting for a remote
+    // provider to come up) and must not serialize concurrent instantiations.
+    std::lock_guard<std::mutex> lg(guard);
+    auto it = factory_store.find(undecorated_name);
+    if (it == factory_store.end())
+        return Factory{};
+
+    return it->second;
+}
+
 std::string cul::ProviderFactory::extract_undecorated_name(const std::string& name)
 {
     return name.substr(0, name.find("@"));
@@ -20,6 +20,8 @@
 
 #include <com/ubuntu/location/logging.h>
 
+#include <algorithm>
+#include <atomic>
 #include <thread>
 
 namespace location = com::ubuntu::location;
@@ -42,6 +44,8 @@ struct dummy::Provider::Private
 
     dummy::Configuration configuration;
     std::atomic<State> state;
+    // The minimum interval requested by consumers, zero if none.
+    std::atomic<std::chrono::milliseconds> requested_interval{std::chrono::milliseconds{0}};
     bool stop_requested;
     std::thread worker{};
 };
@@ -155,7 +159,7 @@ void dummy::Provider::start_position_updates()
             mutable_updates().heading(heading_update);
             mutable_updates().velocity(velocity_update);
 
-            std::this_thread::sleep_for(d->configuration.update_period);
+            std::this_thread::sleep_for(std::max(d->configuration.update_period, d->requested_interval.load()));
         }
 
         d->state.store(Private::State::stopped);
@@ -176,3 +180,7 @@ void dummy::Provider::stop_position_updates()
         d->worker.join();
 }
 
+void dummy::Provider::set_update_interval(const location::Optional<std::chrono::milliseconds>& interval)
+{
+    d->requested_interval.store(interval ? *interval : std::chrono::milliseconds{0});
+}
@@ -126,6 +126,8 @@ class Provider : public com::ubuntu::location::Provider
     void start_position_updates();
     // Stops the updater thread.
     void stop_position_updates();
+    // Slows down the updater thread if consumers need updates less often than update_period.
+    void set_update_interval(const Optional<std::chrono::milliseconds>& interval);
 
   private:
     struct Private;
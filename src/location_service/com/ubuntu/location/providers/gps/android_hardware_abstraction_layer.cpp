@@ -33,6 +33,7 @@
 
 #include <boost/property_tree/ini_parser.hpp>
 
+#include <algorithm>
 #include <random>
 
 namespace gps = com::ubuntu::location::providers::gps;
@@ -509,6 +510,19 @@ bool android::HardwareAbstractionLayer::set_position_mode(gps::PositionMode mode
     return impl.dispatch_updated_modes_to_driver();
 }
 
+bool android::HardwareAbstractionLayer::set_position_interval(const std::chrono::milliseconds& interval)
+{
+    // The chipset is not asked to deliver fixes more often than this.
+    static const std::chrono::milliseconds default_interval{500};
+
+    auto new_interval = std::max(interval, default_interval);
+    if (new_interval == impl.position_interval)
+        return true;
+
+    impl.position_interval = new_interval;
+    return impl.dispatch_updated_modes_to_driver();
+}
+
 bool android::HardwareAbstractionLayer::inject_reference_position(const location::Position& position)
 {
     // TODO(tvoss): We should expose the int return type of the underyling
@@ -555,6 +569,7 @@ android::HardwareAbstractionLayer::Impl::Impl(
     : capabilities(0),
       assistance_mode(gps::AssistanceMode::mobile_station_based),
       position_mode(gps::PositionMode::periodic),
+      position_interval(500),
       supl_assistant(*parent),
       reference_time_source(configuration.reference_time_source),
       gps_xtra_configuration(configuration.gps_xtra.configuration),
@@ -602,13 +617,12 @@ bool android::HardwareAbstractionLayer::Impl::dispatch_updated_modes_to_driver()
 
     static const uint32_t preferred_accuracy_in_meters = 0;
     static const uint32_t preferred_ttff_in_ms = 0;
-    static const std::chrono::milliseconds min_interval{500};
 
     return u_hardware_gps_set_position_mode(
                 gps_handle,
                 am,
                 pm,
-                min_interval.count(),
+                position_interval.count(),
                 preferred_accuracy_in_meters,
                 preferred_ttff_in_ms);
 }
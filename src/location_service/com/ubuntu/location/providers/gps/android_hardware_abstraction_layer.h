@@ -245,6 +245,7 @@ struct HardwareAbstractionLayer : public gps::HardwareAbstractionLayer
 
     bool set_assistance_mode(gps::AssistanceMode mode) override;
     bool set_position_mode(gps::PositionMode mode) override;
+    bool set_position_interval(const std::chrono::milliseconds& interval) override;
 
     bool inject_reference_position(const location::Position& position) override;
     bool inject_reference_time(const ReferenceTimeSample& sample) override;
@@ -268,6 +269,8 @@ struct HardwareAbstractionLayer : public gps::HardwareAbstractionLayer
         gps::AssistanceMode assistance_mode;
         // The current position mode.
         gps::PositionMode position_mode;
+        // The current minimum interval between fixes.
+        std::chrono::milliseconds position_interval;
 
         // An implementation of the gps::HardwareAbstractionLayer::SuplAssistant interface.
         SuplAssistant supl_assistant;
@@ -304,6 +304,13 @@ public:
      */
     virtual bool set_position_mode(PositionMode mode) = 0;
 
+    /**
+     * @brief Dispatches the requested minimum interval between fixes to the driver/hw.
+     * @param interval The new minimum interval, zero restores the default interval.
+     * @return true iff the interval change was carried out successfully.
+     */
+    virtual bool set_position_interval(const std::chrono::milliseconds& interval) = 0;
+
     /**
      * @brief Injects a reference position to the underlying gps driver/chipset.
      * @return true iff the injection was successful, false otherwise.
@@ -101,6 +101,12 @@ void culg::Provider::stop_heading_updates()
 {
 }
 
+void culg::Provider::set_update_interval(const cul::Optional<std::chrono::milliseconds>& interval)
+{
+    // The chipset only runs as often as the most demanding consumer requires.
+    hal->set_position_interval(interval ? *interval : std::chrono::milliseconds{0});
+}
+
 void culg::Provider::on_reference_location_updated(const cul::Update<cul::Position>& position)
 {
     hal->inject_reference_position(position.value);
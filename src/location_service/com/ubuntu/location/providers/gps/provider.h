@@ -58,6 +58,8 @@ class Provider : public com::ubuntu::location::Provider
     void start_heading_updates();
     void stop_heading_updates();
 
+    void set_update_interval(const Optional<std::chrono::milliseconds>& interval);
+
     void on_reference_location_updated(const Update<Position>& position);
 
   private:
@@ -19,6 +19,7 @@
 #include <com/ubuntu/location/providers/remote/provider.h>
 
 #include <com/ubuntu/location/providers/remote/interface.h>
+#include <com/ubuntu/location/providers/remote/shared_memory_ring.h>
 
 #include <com/ubuntu/location/logging.h>
 
@@ -31,7 +32,20 @@
 
 #include <boost/asio.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <system_error>
 #include <thread>
+#include <tuple>
+#include <vector>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace cul = com::ubuntu::location;
 namespace remote = com::ubuntu::location::providers::remote;
@@ -156,13 +170,33 @@ T throw_if_error_or_return(const dbus::Result<T>& result)
     };
     return result.value();
 }
+
+// Remote providers are asked only once per distinct set of requirements and accuracies.
+// Unset accuracies map to -1.
+typedef std::tuple<bool, bool, bool, bool, double, double, double, double> CriteriaKey;
+
+CriteriaKey key_for_criteria(const cul::Criteria& criteria)
+{
+    return CriteriaKey
+    {
+        criteria.requires.position,
+        criteria.requires.altitude,
+        criteria.requires.velocity,
+        criteria.requires.heading,
+        criteria.accuracy.horizontal.value(),
+        criteria.accuracy.vertical ? criteria.accuracy.vertical->value() : -1.,
+        criteria.accuracy.velocity ? criteria.accuracy.velocity->value() : -1.,
+        criteria.accuracy.heading ? criteria.accuracy.heading->value() : -1.
+    };
+}
 }
 
 struct remote::Provider::Stub::Private
 {
     Private(const remote::stub::Configuration& config)
             : object(config.object),
-              stub(object)
+              stub(object),
+              shared_memory_capacity(config.shared_memory.capacity)
     {
     }
 
@@ -170,8 +204,223 @@ struct remote::Provider::Stub::Private
     {
     }
 
+    // Fetches the capabilities of the remote end and drops all cached answers.
+    // Throws if the remote end cannot be reached.
+    void refresh_capabilities()
+    {
+        auto result = stub.object->transact_method<
+                remote::Interface::DescribeCapabilities,
+                remote::Interface::Capabilities
+                >();
+
+        remote::Interface::Capabilities capabilities;
+
+        if (not result.is_error())
+        {
+            capabilities = result.value();
+        } else
+        {
+            // Remote ends predating DescribeCapabilities are asked for every flag individually.
+            VLOG(1) << "Falling back to querying capabilities individually: " << result.error().print();
+
+            auto features = cul::Provider::Features::none;
+            for (auto f : {cul::Provider::Features::position, cul::Provider::Features::velocity, cul::Provider::Features::heading})
+                if (throw_if_error_or_return(stub.object->transact_method<remote::Interface::Supports, bool>(f)))
+                    features = features | f;
+
+            auto requirements = cul::Provider::Requirements::none;
+            for (auto r : {cul::Provider::Requirements::satellites, cul::Provider::Requirements::cell_network,
+                           cul::Provider::Requirements::data_network, cul::Provider::Requirements::monetary_spending})
+                if (throw_if_error_or_return(stub.object->transact_method<remote::Interface::Requires, bool>(r)))
+                    requirements = requirements | r;
+
+            capabilities = remote::Interface::Capabilities{features, requirements};
+        }
+
+        update_capabilities(capabilities);
+    }
+
+    // Replaces the cached capabilities and drops all cached answers to matches_criteria.
+    void update_capabilities(const remote::Interface::Capabilities& capabilities)
+    {
+        std::lock_guard<std::mutex> lg(cache.guard);
+        cache.capabilities = capabilities;
+        cache.matches.clear();
+    }
+
+    // Forwards pending reference state to the remote end, as long as fewer than
+    // max_reference_calls_in_flight calls are awaiting their reply. Invoked whenever
+    // new reference state arrives and whenever a call completes.
+    static void forward_reference_state(const std::weak_ptr<Private>& wp)
+    {
+        auto sp = wp.lock();
+
+        // Pending state is kept while the remote end is gone, and forwarded once it is back.
+        if (not sp or not sp->available)
+            return;
+
+        std::unique_lock<std::mutex> ul(sp->reference.guard);
+
+        // We rotate over the kinds, such that frequent position updates do not starve the others.
+        unsigned int idle{0};
+        while (sp->reference.in_flight < max_reference_calls_in_flight && idle < 3)
+        {
+            auto kind = sp->reference.next;
+            sp->reference.next = (kind + 1) % 3;
+
+            bool forwarded{false};
+            switch (kind)
+            {
+            case 0:
+                forwarded = forward_if_pending<remote::Interface::OnReferenceLocationChanged>(wp, sp, sp->reference.position, ul);
+                break;
+            case 1:
+                forwarded = forward_if_pending<remote::Interface::OnReferenceHeadingChanged>(wp, sp, sp->reference.heading, ul);
+                break;
+            case 2:
+                forwarded = forward_if_pending<remote::Interface::OnReferenceVelocityChanged>(wp, sp, sp->reference.velocity, ul);
+                break;
+            }
+
+            idle = forwarded ? 0 : idle + 1;
+        }
+    }
+
+    // Sends out pending without waiting for the reply, returning false if nothing is pending.
+    // ul is released while sending.
+    template<typename Method, typename T>
+    static bool forward_if_pending(
+            const std::weak_ptr<Private>& wp,
+            const std::shared_ptr<Private>& sp,
+            cul::Optional<cul::Update<T>>& pending,
+            std::unique_lock<std::mutex>& ul)
+    {
+        if (not pending)
+            return false;
+
+        auto value = *pending;
+        pending.reset();
+        sp->reference.in_flight++;
+
+        ul.unlock();
+
+        auto on_completed = [wp]()
+        {
+            if (auto sp = wp.lock())
+            {
+                {
+                    std::lock_guard<std::mutex> lg(sp->reference.guard);
+                    sp->reference.in_flight--;
+                }
+
+                forward_reference_state(wp);
+            }
+        };
+
+        try
+        {
+            sp->stub.object->template invoke_method_asynchronously_with_callback<Method, void>(
+                [on_completed](const dbus::Result<void>& result)
+                {
+                    // We drop the error and just log it for post-mortem inspection.
+                    if (result.is_error())
+                        LOG(WARNING) << "Transaction<" << Method::name() << ">: " << result.error().print();
+
+                    on_completed();
+                }, value);
+        } catch(const std::exception& e)
+        {
+            LOG(WARNING) << "Transaction<" << Method::name() << ">: " << e.what();
+
+            std::lock_guard<std::mutex> lg(sp->reference.guard);
+            sp->reference.in_flight--;
+        }
+
+        ul.lock();
+
+        return true;
+    }
+
+    // The maximum number of reference state calls awaiting their reply from the remote end.
+    static constexpr std::size_t max_reference_calls_in_flight{2};
+
+    // Updates handed out by the remote end via shared memory, see Stub::open_shared_memory_channel.
+    struct Channel
+    {
+        Channel(const remote::SharedMemoryRing::Ptr& ring, int wakeup)
+            : ring{ring},
+              wakeup{Runtime::instance().io.service, wakeup}
+        {
+        }
+
+        remote::SharedMemoryRing::Ptr ring;
+        boost::asio::posix::stream_descriptor wakeup;
+        // The value of the eventfd is read into here.
+        std::uint64_t counter{0};
+    };
+
+    // Stops reading from the shared memory channel, if any, without notifying the remote end.
+    void drop_channel()
+    {
+        if (not channel)
+            return;
+
+        // The descriptor is only ever touched on the io service, closing it cancels the pending read.
+        auto c = channel;
+        Runtime::instance().io.service.post([c]()
+        {
+            boost::system::error_code ec;
+            c->wakeup.close(ec);
+        });
+
+        channel.reset();
+    }
+
     dbus::Object::Ptr object;
     remote::Interface::Stub stub;
+    std::size_t shared_memory_capacity;
+    std::shared_ptr<Channel> channel;
+    // False while the remote end is gone, transactions are skipped until it comes back.
+    std::atomic<bool> available{true};
+    // The interval last requested by the engine, restored on a fresh remote end.
+    struct
+    {
+        std::mutex guard;
+        cul::Optional<std::chrono::milliseconds> value;
+    } update_interval;
+    // Tracks the owner of the remote end's bus name.
+    struct
+    {
+        std::string name;
+        std::shared_ptr<dbus::DBus> daemon;
+        dbus::ServiceWatcher::Ptr watcher;
+        std::chrono::steady_clock::time_point lost_at{std::chrono::steady_clock::now()};
+    } presence;
+    // Reference state waiting to be forwarded to the remote end. Only the newest
+    // value per kind is kept, values superseded before being sent are dropped.
+    struct
+    {
+        std::mutex guard;
+        cul::Optional<cul::Update<cul::Position>> position;
+        cul::Optional<cul::Update<cul::Heading>> heading;
+        cul::Optional<cul::Update<cul::Velocity>> velocity;
+        // The number of calls awaiting their reply from the remote end.
+        std::size_t in_flight{0};
+        // The kind considered first when forwarding.
+        unsigned int next{0};
+    } reference;
+    // Caches what we know about the remote end, such that engine configuration
+    // changes and provider selection do not wait for the remote end.
+    struct
+    {
+        mutable std::mutex guard;
+        remote::Interface::Capabilities capabilities
+        {
+            cul::Provider::Features::none,
+            cul::Provider::Requirements::none
+        };
+        std::map<CriteriaKey, bool> matches;
+    } cache;
 };
 
 std::string remote::Provider::Stub::class_name()
@@ -192,29 +441,30 @@ cul::Provider::Ptr remote::Provider::Stub::create_instance(const cul::ProviderFa
     auto service = dbus::Service::use_service(bus, name);
     auto object = service->object_for_path(path);
 
-    // Check if the service has come up
-    if (!bus->has_owner_for_name(name)) {
-        // If it hasn't wait for it to come up
-        bool valid = false;
-        std::mutex guard;
-        std::condition_variable cv;
-        dbus::DBus daemon(bus);
-        dbus::ServiceWatcher::Ptr service_watcher(
-            daemon.make_service_watcher(name, dbus::DBus::WatchMode::registration));
+    remote::stub::Configuration stub_config{object, remote::stub::Configuration::SharedMemory{}};
+    if (config.count(Stub::key_shared_memory_capacity) > 0)
+        stub_config.shared_memory.capacity = config.get<std::size_t>(Stub::key_shared_memory_capacity);
 
-        service_watcher->service_registered().connect([&valid, &guard, &cv]()
-            {
-                std::unique_lock<std::mutex> ul(guard);
-                valid = true;
-                cv.notify_all();
-            });
+    std::shared_ptr<remote::Provider::Stub> result{new remote::Provider::Stub{stub_config}};
+
+    result->setup_event_connections();
+    // We start watching before checking for an owner, such that we do not miss the remote end coming up.
+    result->watch(bus, name);
 
-        std::unique_lock<std::mutex> ul(guard);
-        if (not cv.wait_for(ul, std::chrono::seconds{30}, [&valid]() { return valid; }))
-            throw std::runtime_error("Remote service failed to start");
+    if (bus->has_owner_for_name(name))
+    {
+        // This call throws if we fail to reach the remote end.
+        result->ping();
+        result->try_open_shared_memory_channel();
+    } else
+    {
+        // We do not wait for the remote end to come up but hand out an unavailable
+        // provider that reconnects as soon as the remote end registers its name.
+        LOG(INFO) << "Remote provider " << name << " is not running yet, waiting for it in the background.";
+        result->on_remote_lost();
     }
 
-    return create_instance_with_config(remote::stub::Configuration{object});
+    return result;
 }
 
 cul::Provider::Ptr remote::Provider::Stub::create_instance_with_config(const remote::stub::Configuration& config)
@@ -222,10 +472,13 @@ cul::Provider::Ptr remote::Provider::Stub::create_instance_with_config(const rem
     std::shared_ptr<remote::Provider::Stub> result{new remote::Provider::Stub{config}};
 
     // This call throws if we fail to reach the remote end. With that, we make sure that
-    // we do not return a potentially invalid instance that throws later on.
+    // we do not return a potentially invalid instance that throws later on. It also
+    // fetches the capabilities of the remote end.
     result->ping();
 
     result->setup_event_connections();
+    result->try_open_shared_memory_channel();
+
     return result;
 }
 
@@ -283,104 +536,326 @@ void remote::Provider::Stub::setup_event_connections()
                 sp->mutable_updates().velocity(arg);
             });
         });
+
+    d->stub.signals.updates_batched->connect(
+        [wp](const remote::Interface::Signals::UpdatesBatched::ArgumentType& arg)
+        {
+            VLOG(50) << "remote::Provider::Stub::UpdatesBatched";
+            // The whole batch is handed out in one task, instead of posting once per update.
+            Runtime::instance().task.service.post([wp, arg]()
+            {
+                if (auto sp = wp.lock())
+                    sp->deliver(arg);
+            });
+        });
+
+    std::weak_ptr<Private> wd{d};
+    d->stub.signals.capabilities_changed->connect(
+        [wd](const remote::Interface::Signals::CapabilitiesChanged::ArgumentType& arg)
+        {
+            VLOG(10) << "remote::Provider::Stub::CapabilitiesChanged";
+
+            if (auto sp = wd.lock())
+                sp->update_capabilities(arg);
+        });
+}
+
+void remote::Provider::Stub::deliver(const remote::Interface::Batch& batch)
+{
+    const auto& positions = std::get<0>(batch);
+
+    if (positions.size() == 1)
+        mutable_updates().position(positions.front());
+    else if (positions.size() > 1)
+        mutable_updates().position_batch(positions);
+
+    for (const auto& heading : std::get<1>(batch))
+        mutable_updates().heading(heading);
+
+    for (const auto& velocity : std::get<2>(batch))
+        mutable_updates().velocity(velocity);
+}
+
+void remote::Provider::Stub::open_shared_memory_channel(std::size_t capacity)
+{
+    auto fds = throw_if_error_or_return(d->stub.object->transact_method<
+            remote::Interface::OpenSharedMemoryChannel,
+            remote::Interface::SharedMemoryChannel
+            >(static_cast<std::uint32_t>(capacity)));
+
+    // attach takes ownership of the duplicated fd, the stream descriptor of the other one.
+    auto ring = remote::SharedMemoryRing::attach(::dup(std::get<0>(fds).to_raw()));
+    d->channel = std::make_shared<Private::Channel>(ring, ::dup(std::get<1>(fds).to_raw()));
+
+    VLOG(1) << "Receiving updates via shared memory ring with capacity " << ring->capacity();
+
+    read_from_shared_memory_channel();
+}
+
+void remote::Provider::Stub::read_from_shared_memory_channel()
+{
+    std::weak_ptr<remote::Provider::Stub> wp{shared_from_this()};
+    auto channel = d->channel;
+
+    channel->wakeup.async_read_some(
+        boost::asio::buffer(&channel->counter, sizeof(channel->counter)),
+        [wp, channel](const boost::system::error_code& ec, std::size_t)
+        {
+            if (ec)
+            {
+                if (ec != boost::asio::error::operation_aborted)
+                    LOG(WARNING) << "Stopped reading from shared memory channel: " << ec.message();
+                return;
+            }
+
+            auto sp = wp.lock();
+
+            if (not sp)
+                return;
+
+            // We drain everything that is available, a single wakeup might
+            // account for any number of records.
+            remote::Interface::Batch batch;
+            remote::SharedMemoryRing::Record record;
+
+            while (channel->ring->pop(record))
+            {
+                switch (record.kind)
+                {
+                case remote::SharedMemoryRing::Record::Kind::position:
+                    std::get<0>(batch).push_back(remote::SharedMemoryRing::decode_position(record));
+                    break;
+                case remote::SharedMemoryRing::Record::Kind::heading:
+                    std::get<1>(batch).push_back(remote::SharedMemoryRing::decode_heading(record));
+                    break;
+                case remote::SharedMemoryRing::Record::Kind::velocity:
+                    std::get<2>(batch).push_back(remote::SharedMemoryRing::decode_velocity(record));
+                    break;
+                }
+            }
+
+            Runtime::instance().task.service.post([wp, batch]()
+            {
+                if (auto sp = wp.lock())
+                    sp->deliver(batch);
+            });
+
+            sp->read_from_shared_memory_channel();
+        });
+}
+
+void remote::Provider::Stub::try_open_shared_memory_channel()
+{
+    if (d->shared_memory_capacity == 0)
+        return;
+
+    try
+    {
+        open_shared_memory_channel(d->shared_memory_capacity);
+    } catch(const std::exception& e)
+    {
+        // Remote ends lacking support keep on handing out updates via the bus.
+        LOG(WARNING) << "Falling back to receiving updates via the bus: " << e.what();
+    }
+}
+
+void remote::Provider::Stub::watch(const core::dbus::Bus::Ptr& bus, const std::string& name)
+{
+    d->presence.name = name;
+    d->presence.daemon = std::make_shared<dbus::DBus>(bus);
+    d->presence.watcher = d->presence.daemon->make_service_watcher(name);
+
+    std::weak_ptr<remote::Provider::Stub> wp{shared_from_this()};
+
+    // Owner changes are reported on the bus executor, we handle them on the task
+    // service in order to not block the bus while talking to the remote end.
+    d->presence.watcher->owner_changed().connect([wp](const std::string&, const std::string& new_owner)
+    {
+        Runtime::instance().task.service.post([wp, new_owner]()
+        {
+            auto sp = wp.lock();
+
+            if (not sp)
+                return;
+
+            if (new_owner.empty())
+                sp->on_remote_lost();
+            else
+                sp->on_remote_appeared();
+        });
+    });
+}
+
+void remote::Provider::Stub::on_remote_lost()
+{
+    if (not d->available.exchange(false))
+        return;
+
+    d->presence.lost_at = std::chrono::steady_clock::now();
+
+    LOG(WARNING) << "Remote provider " << d->presence.name << " vanished, marking it unavailable.";
+
+    // A restarted remote end hands out a fresh ring, if any.
+    d->drop_channel();
+
+    {
+        std::lock_guard<std::mutex> lg(d->cache.guard);
+        d->cache.matches.clear();
+    }
+
+    mutable_available().set(false);
+}
+
+void remote::Provider::Stub::on_remote_appeared()
+{
+    try
+    {
+        ping();
+
+        // A fresh remote end knows nothing about our clients, we restore what the engine asked for.
+        auto controller = state_controller();
+
+        if (controller->are_position_updates_running())
+            throw_if_error(d->stub.object->transact_method<remote::Interface::StartPositionUpdates, void>());
+        if (controller->are_heading_updates_running())
+            throw_if_error(d->stub.object->transact_method<remote::Interface::StartHeadingUpdates, void>());
+        if (controller->are_velocity_updates_running())
+            throw_if_error(d->stub.object->transact_method<remote::Interface::StartVelocityUpdates, void>());
+
+        cul::Optional<std::chrono::milliseconds> interval;
+        {
+            std::lock_guard<std::mutex> lg(d->update_interval.guard);
+            interval = d->update_interval.value;
+        }
+
+        if (interval)
+            throw_if_error(d->stub.object->transact_method<remote::Interface::SetUpdateInterval, void>(
+                    static_cast<std::int64_t>(interval->count())));
+
+        d->drop_channel();
+        try_open_shared_memory_channel();
+    } catch(const std::exception& e)
+    {
+        // We stay unavailable and try again once the remote end restarts.
+        LOG(WARNING) << "Failed to reconnect to remote provider " << d->presence.name << ": " << e.what();
+        return;
+    }
+
+    if (d->available.exchange(true))
+        return;
+
+    auto recovery = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - d->presence.lost_at);
+
+    LOG(INFO) << "Remote provider " << d->presence.name << " is back after " << recovery.count() << " [ms].";
+
+    mutable_available().set(true);
+
+    // Reference state that arrived in the meantime has been held back.
+    Private::forward_reference_state(d);
 }
 
 void remote::Provider::Stub::ping()
 {
-    // Requires reaches out to the remote side and throws in case of issues.
-    requires(Provider::Requirements::satellites);
+    // Reaches out to the remote side and throws in case of issues.
+    d->refresh_capabilities();
 }
 
 remote::Provider::Stub::~Stub() noexcept
 {
     VLOG(10) << __PRETTY_FUNCTION__;
+
+    if (not d->channel or not d->available)
+        return;
+
+    d->drop_channel();
+
+    // The remote end falls back to signals on its own once the ring runs full,
+    // asking it to do so right away is a courtesy only.
+    auto result = d->stub.object->transact_method<remote::Interface::CloseSharedMemoryChannel, void>();
+    if (result.is_error())
+        VLOG(1) << "Failed to close shared memory channel: " << result.error().print();
 }
 
 bool remote::Provider::Stub::matches_criteria(const cul::Criteria& criteria)
 {
-    VLOG(10) << __PRETTY_FUNCTION__ << std::endl;    
-    return throw_if_error_or_return(d->stub.object->transact_method<remote::Interface::MatchesCriteria, bool>(criteria));
+    VLOG(10) << __PRETTY_FUNCTION__ << std::endl;
+
+    // Selection policies route around us while the remote end is gone.
+    if (not d->available)
+        return false;
+
+    auto key = key_for_criteria(criteria);
+
+    {
+        std::lock_guard<std::mutex> lg(d->cache.guard);
+        auto it = d->cache.matches.find(key);
+        if (it != d->cache.matches.end())
+            return it->second;
+    }
+
+    auto result = throw_if_error_or_return(d->stub.object->transact_method<remote::Interface::MatchesCriteria, bool>(criteria));
+
+    std::lock_guard<std::mutex> lg(d->cache.guard);
+    d->cache.matches[key] = result;
+
+    return result;
 }
 
 bool remote::Provider::Stub::supports(const cul::Provider::Features& f) const
 {
     VLOG(10) << __PRETTY_FUNCTION__;
-    return throw_if_error_or_return(d->stub.object->transact_method<remote::Interface::Supports, bool>(f));
+
+    std::lock_guard<std::mutex> lg(d->cache.guard);
+    return (std::get<0>(d->cache.capabilities) & f) != cul::Provider::Features::none;
 }
 
 bool remote::Provider::Stub::requires(const cul::Provider::Requirements& r) const
 {
     VLOG(10) << __PRETTY_FUNCTION__;
-    return throw_if_error_or_return(d->stub.object->transact_method<remote::Interface::Requires, bool>(r));
+
+    std::lock_guard<std::mutex> lg(d->cache.guard);
+    return (std::get<1>(d->cache.capabilities) & r) != cul::Provider::Requirements::none;
 }
 
 void remote::Provider::Stub::on_wifi_and_cell_reporting_state_changed(cul::WifiAndCellIdReportingState state)
 {
     VLOG(10) << __PRETTY_FUNCTION__;
+
+    if (not d->available)
+        return;
+
     throw_if_error(d->stub.object->transact_method<remote::Interface::OnWifiAndCellIdReportingStateChanged, void>(state));
 }
 
 void remote::Provider::Stub::on_reference_location_updated(const cul::Update<cul::Position>& position)
 {
-    std::weak_ptr<Private> wp{d};
-    Runtime::instance().task.service.post([wp, position]()
     {
-        auto sp = wp.lock();
-
-        if (not sp)
-            return;
+        std::lock_guard<std::mutex> lg(d->reference.guard);
+        d->reference.position = position;
+    }
 
-        try
-        {
-            throw_if_error(sp->stub.object->transact_method<remote::Interface::OnReferenceLocationChanged, void>(position));
-        } catch(const std::exception& e)
-        {
-            // We drop the error and just log it for post-mortem inspection.
-            LOG(WARNING) << "Transaction<remote::Interface::OnReferenceLocationChanged>: " << e.what();
-        }
-    });
+    Private::forward_reference_state(d);
 }
 
 void remote::Provider::Stub::on_reference_velocity_updated(const cul::Update<cul::Velocity>& velocity)
 {
-    std::weak_ptr<Private> wp{d};
-    Runtime::instance().task.service.post([wp, velocity]()
     {
-        auto sp = wp.lock();
-
-        if (not sp)
-            return;
+        std::lock_guard<std::mutex> lg(d->reference.guard);
+        d->reference.velocity = velocity;
+    }
 
-        try
-        {
-            throw_if_error(sp->stub.object->transact_method<remote::Interface::OnReferenceVelocityChanged, void>(velocity));
-        } catch(const std::exception& e)
-        {
-            // We drop the error and just log it for post-mortem inspection.
-            LOG(WARNING) << "Transaction<remote::Interface::OnReferenceVelocityChanged>: " << e.what();
-        }
-    });
+    Private::forward_reference_state(d);
 }
 
 void remote::Provider::Stub::on_reference_heading_updated(const cul::Update<cul::Heading>& heading)
 {
-    std::weak_ptr<Private> wp{d};
-    Runtime::instance().task.service.post([wp, heading]()
     {
-        auto sp = wp.lock();
-
-        if (not sp)
-            return;
+        std::lock_guard<std::mutex> lg(d->reference.guard);
+        d->reference.heading = heading;
+    }
 
-        try
-        {
-            throw_if_error(sp->stub.object->transact_method<remote::Interface::OnReferenceHeadingChanged, void>(heading));
-        } catch(const std::exception& e)
-        {
-            // We drop the error and just log it for post-mortem inspection.
-            LOG(WARNING) << "Transaction<remote::Interface::OnReferenceHeadingChanged>: " << e.what();
-        }
-    });
+    Private::forward_reference_state(d);
 }
 
 void remote::Provider::Stub::start_position_updates()
@@ -391,7 +866,7 @@ void remote::Provider::Stub::start_position_updates()
     {
         auto sp = wp.lock();
 
-        if (not sp)
+        if (not sp or not sp->available)
             return;
 
         throw_if_error(sp->stub.object->transact_method<remote::Interface::StartPositionUpdates, void>());
@@ -407,7 +882,7 @@ void remote::Provider::Stub::stop_position_updates()
     {
         auto sp = wp.lock();
 
-        if (not sp)
+        if (not sp or not sp->available)
             return;
 
         throw_if_error(sp->stub.object->transact_method<remote::Interface::StopPositionUpdates, void>());
@@ -423,7 +898,7 @@ void remote::Provider::Stub::start_heading_updates()
     {
         auto sp = wp.lock();
 
-        if (not sp)
+        if (not sp or not sp->available)
             return;
 
         throw_if_error(sp->stub.object->transact_method<remote::Interface::StartHeadingUpdates, void>());
@@ -439,7 +914,7 @@ void remote::Provider::Stub::stop_heading_updates()
     {
         auto sp = wp.lock();
 
-        if (not sp)
+        if (not sp or not sp->available)
             return;
 
         throw_if_error(sp->stub.object->transact_method<remote::Interface::StopHeadingUpdates, void>());
@@ -455,7 +930,7 @@ void remote::Provider::Stub::start_velocity_updates()
     {
         auto sp = wp.lock();
 
-        if (not sp)
+        if (not sp or not sp->available)
             return;
 
         throw_if_error(sp->stub.object->transact_method<remote::Interface::StartVelocityUpdates, void>());
@@ -472,7 +947,7 @@ void remote::Provider::Stub::stop_velocity_updates()
     {
         auto sp = wp.lock();
 
-        if (not sp)
+        if (not sp or not sp->available)
             return;
 
         throw_if_error(sp->stub.object->transact_method<remote::Interface::StopVelocityUpdates, void>());
@@ -480,44 +955,299 @@ void remote::Provider::Stub::stop_velocity_updates()
     VLOG(10) << "< " << __PRETTY_FUNCTION__;
 }
 
+void remote::Provider::Stub::set_update_interval(const cul::Optional<std::chrono::milliseconds>& interval)
+{
+    VLOG(10) << "> " << __PRETTY_FUNCTION__;
+    std::int64_t ms = interval ? static_cast<std::int64_t>(interval->count()) : -1;
+
+    {
+        std::lock_guard<std::mutex> lg(d->update_interval.guard);
+        d->update_interval.value = interval;
+    }
+
+    std::weak_ptr<Private> wp{d};
+    Runtime::instance().task.service.post([wp, ms]()
+    {
+        auto sp = wp.lock();
+
+        // The interval is restored once the remote end comes back.
+        if (not sp or not sp->available)
+            return;
+
+        try
+        {
+            throw_if_error(sp->stub.object->transact_method<remote::Interface::SetUpdateInterval, void>(ms));
+        } catch(const std::exception& e)
+        {
+            // The remote end keeps running at its previous interval, we just log for post-mortem inspection.
+            LOG(WARNING) << "Transaction<remote::Interface::SetUpdateInterval>: " << e.what();
+        }
+    });
+    VLOG(10) << "< " << __PRETTY_FUNCTION__;
+}
+
+constexpr std::size_t remote::Provider::Stub::Private::max_reference_calls_in_flight;
+
 struct remote::Provider::Skeleton::Private
 {
     Private(const remote::skeleton::Configuration& config)
             : bus(config.bus),
               skeleton(config.object),
               impl(config.provider),
-              connections
-              {
-                  impl->updates().position.connect([this](const cul::Update<cul::Position>& position)
-                  {
-                      VLOG(100) << "Position changed reported by impl: " << position;                      
-                      skeleton.signals.position_changed->emit(position.value);
-                  }),
-                  impl->updates().heading.connect([this](const cul::Update<cul::Heading>& heading)
-                  {
-                      VLOG(100) << "Heading changed reported by impl: " << heading;
-                      skeleton.signals.heading_changed->emit(heading.value);
-                  }),
-                  impl->updates().velocity.connect([this](const cul::Update<cul::Velocity>& velocity)
-                  {
-                      VLOG(100) << "Velocity changed reported by impl: " << velocity;
-                      skeleton.signals.velocity_changed->emit(velocity.value);
-                  })
-              }
+              batching(config.batching)
+    {
+        connections.emplace_back(impl->updates().position.connect([this](const cul::Update<cul::Position>& position)
+        {
+            VLOG(100) << "Position changed reported by impl: " << position;
+            send<0>(position, skeleton.signals.position_changed);
+        }));
+        connections.emplace_back(impl->updates().heading.connect([this](const cul::Update<cul::Heading>& heading)
+        {
+            VLOG(100) << "Heading changed reported by impl: " << heading;
+            send<1>(heading, skeleton.signals.heading_changed);
+        }));
+        connections.emplace_back(impl->updates().velocity.connect([this](const cul::Update<cul::Velocity>& velocity)
+        {
+            VLOG(100) << "Velocity changed reported by impl: " << velocity;
+            send<2>(velocity, skeleton.signals.velocity_changed);
+        }));
+        connections.emplace_back(impl->updates().position_batch.connect([this](const std::vector<cul::Update<cul::Position>>& positions)
+        {
+            VLOG(100) << "Position batch of size " << positions.size() << " reported by impl";
+
+            for (const auto& position : positions)
+                send<0>(position, skeleton.signals.position_changed);
+        }));
+
+        if (is_batching())
+            batch.worker = std::thread{[this]() { flush_periodically(); }};
+    }
+
+    ~Private()
+    {
+        // No more updates reach the batch from here on.
+        connections.clear();
+
+        // Owner changes refer to us, so we stop watching before tearing down.
+        {
+            std::lock_guard<std::mutex> lg(channel.guard);
+            channel.watcher.reset();
+        }
+
+        // Whatever is pending is handed out before we go away.
+        {
+            std::lock_guard<std::mutex> lg(batch.guard);
+            flush_locked();
+            batch.stopped = true;
+        }
+
+        batch.wakeup.notify_all();
+
+        if (batch.worker.joinable())
+            batch.worker.join();
+
+        close_channel();
+    }
+
+    // Hands out update via the shared memory channel if one is open, via
+    // the pending batch if batching is enabled, or via signal otherwise.
+    template<std::size_t index, typename T, typename Signal>
+    void send(const cul::Update<T>& update, const Signal& signal)
+    {
+        if (push_to_channel(update))
+            return;
+
+        if (is_batching())
+            enqueue<index>(update);
+        else
+            signal->emit(update.value);
+    }
+
+    // Returns true if no channel is open or if owner opened the open channel.
+    bool may_access_channel(const std::string& owner)
+    {
+        std::lock_guard<std::mutex> lg(channel.guard);
+        return not channel.ring or channel.owner == owner;
+    }
+
+    // Replaces the shared memory channel of owner, taking ownership of wakeup.
+    // The channel is closed once owner leaves the bus.
+    void open_channel(const std::string& owner, const remote::SharedMemoryRing::Ptr& ring, int wakeup)
+    {
+        if (not daemon)
+            daemon = std::make_shared<dbus::DBus>(bus);
+
+        // Only replaced from within method handlers, i.e., never while reporting an owner change.
+        auto watcher = daemon->make_service_watcher(owner);
+        watcher->owner_changed().connect([this, owner](const std::string&, const std::string& new_owner)
+        {
+            if (not new_owner.empty())
+                return;
+
+            std::lock_guard<std::mutex> lg(channel.guard);
+            if (channel.owner != owner)
+                return;
+
+            VLOG(1) << "Closing shared memory channel as " << owner << " left the bus.";
+            close_channel_locked();
+        });
+
+        std::lock_guard<std::mutex> lg(channel.guard);
+        close_channel_locked();
+        channel.owner = owner;
+        channel.ring = ring;
+        channel.wakeup = wakeup;
+        channel.watcher = std::move(watcher);
+    }
+
+    void close_channel()
+    {
+        std::lock_guard<std::mutex> lg(channel.guard);
+        close_channel_locked();
+    }
+
+    void close_channel_locked()
+    {
+        channel.owner.clear();
+        channel.ring.reset();
+
+        if (channel.wakeup >= 0)
+            ::close(channel.wakeup);
+
+        channel.wakeup = -1;
+    }
+
+    // Returns false if no shared memory channel is open and update has to go out via the bus.
+    template<typename T>
+    bool push_to_channel(const cul::Update<T>& update)
+    {
+        std::lock_guard<std::mutex> lg(channel.guard);
+
+        if (not channel.ring)
+            return false;
+
+        if (not channel.ring->push(remote::SharedMemoryRing::encode(update)))
+        {
+            // The consumer fell behind by a whole ring, most likely because it went away.
+            LOG(WARNING) << "Closing shared memory channel as its consumer stopped reading.";
+            close_channel_locked();
+            return false;
+        }
+
+        // The eventfd adds up wakeups until the consumer reads it.
+        std::uint64_t one{1};
+        if (::write(channel.wakeup, &one, sizeof(one)) < 0)
+            VLOG(1) << "Failed to signal shared memory channel: " << std::strerror(errno);
+
+        return true;
+    }
+
+    bool is_batching() const
+    {
+        return batching.flush_interval.count() > 0;
+    }
+
+    // Appends update to the pending batch, flushing the batch if it is full.
+    template<std::size_t index, typename T>
+    void enqueue(const cul::Update<T>& update)
     {
+        std::lock_guard<std::mutex> lg(batch.guard);
+
+        if (batch.size == 0)
+        {
+            batch.deadline = std::chrono::steady_clock::now() + batching.flush_interval;
+            batch.wakeup.notify_all();
+        }
+
+        std::get<index>(batch.pending).push_back(update);
+
+        if (++batch.size >= batching.max_size)
+            flush_locked();
+    }
+
+    // Emits all pending updates in one signal. batch.guard has to be held by the caller,
+    // such that batches reach the remote end in order.
+    void flush_locked()
+    {
+        if (batch.size == 0)
+            return;
+
+        VLOG(50) << "Flushing batch of " << batch.size << " updates";
+
+        skeleton.signals.updates_batched->emit(batch.pending);
+
+        batch.pending = remote::Interface::Batch{};
+        batch.size = 0;
+    }
+
+    // Flushes pending updates once they have been held back for flush_interval.
+    void flush_periodically()
+    {
+        std::unique_lock<std::mutex> ul(batch.guard);
+
+        while (not batch.stopped)
+        {
+            if (batch.size == 0)
+                batch.wakeup.wait(ul);
+            else if (batch.wakeup.wait_until(ul, batch.deadline) == std::cv_status::timeout)
+                flush_locked();
+        }
+    }
+
+    // Collects the features and requirements of impl.
+    remote::Interface::Capabilities capabilities() const
+    {
+        auto features = cul::Provider::Features::none;
+        for (auto f : {cul::Provider::Features::position, cul::Provider::Features::velocity, cul::Provider::Features::heading})
+            if (impl->supports(f))
+                features = features | f;
+
+        auto requirements = cul::Provider::Requirements::none;
+        for (auto r : {cul::Provider::Requirements::satellites, cul::Provider::Requirements::cell_network,
+                       cul::Provider::Requirements::data_network, cul::Provider::Requirements::monetary_spending})
+            if (impl->requires(r))
+                requirements = requirements | r;
+
+        return remote::Interface::Capabilities{features, requirements};
     }
 
     core::dbus::Bus::Ptr bus;
     remote::Interface::Skeleton skeleton;
     cul::Provider::Ptr impl;
+    // The update interval we requested from impl on behalf of the remote end.
+    cul::Optional<std::chrono::milliseconds> update_interval;
 
-    // All connections to signals go here.
+    // How updates of impl are coalesced before being sent out.
+    remote::skeleton::Configuration::Batching batching;
+    // Updates that have not been sent out yet.
+    struct
+    {
+        std::mutex guard;
+        std::condition_variable wakeup;
+        bool stopped{false};
+        remote::Interface::Batch pending;
+        // The number of updates in pending.
+        std::size_t size{0};
+        // The point in time when pending has to be flushed at the latest.
+        std::chrono::steady_clock::time_point deadline;
+        std::thread worker;
+    } batch;
+    // Stub for accessing the dbus daemon, set up once a channel is opened.
+    std::shared_ptr<dbus::DBus> daemon;
+    // The shared memory channel opened by the remote end, if any.
     struct
     {
-        core::ScopedConnection position_changed;
-        core::ScopedConnection heading_changed;
-        core::ScopedConnection velocity_changed;
-    } connections;
+        std::mutex guard;
+        // The unique bus name of the remote end that opened the channel.
+        std::string owner;
+        remote::SharedMemoryRing::Ptr ring;
+        int wakeup{-1};
+        // Tracks owner, kept until the next channel is opened.
+        dbus::ServiceWatcher::Ptr watcher;
+    } channel;
+
+    // All connections to signals of impl go here, dropped first on destruction.
+    std::vector<core::ScopedConnection> connections;
 };
 
 remote::Provider::Skeleton::Skeleton(const remote::skeleton::Configuration& config)
@@ -536,6 +1266,77 @@ remote::Provider::Skeleton::Skeleton(const remote::skeleton::Configuration& conf
         d->bus->send(reply);
     });
 
+    d->skeleton.object->install_method_handler<remote::Interface::DescribeCapabilities>([this](const dbus::Message::Ptr & msg)
+    {
+        VLOG(1) << "DescribeCapabilities";
+
+        auto capabilities = d->capabilities();
+        auto reply = dbus::Message::make_method_return(msg);
+        reply->writer() << std::get<0>(capabilities) << std::get<1>(capabilities);
+
+        d->bus->send(reply);
+    });
+
+    d->skeleton.object->install_method_handler<remote::Interface::OpenSharedMemoryChannel>([this](const dbus::Message::Ptr & msg)
+    {
+        VLOG(1) << "OpenSharedMemoryChannel";
+
+        std::uint32_t capacity{0}; msg->reader() >> capacity;
+        dbus::Message::Ptr reply;
+
+        // Only a single remote end can consume updates from the channel.
+        if (not d->may_access_channel(msg->sender()))
+        {
+            LOG(WARNING) << "Rejecting shared memory channel for " << msg->sender() << " as another peer holds it.";
+            d->bus->send(dbus::Message::make_error(
+                        msg,
+                        remote::Interface::Errors::OpeningSharedMemoryChannel::name(),
+                        "Shared memory channel is held by another peer"));
+            return;
+        }
+
+        try
+        {
+            auto ring = remote::SharedMemoryRing::create(
+                        std::min<std::size_t>(capacity, remote::SharedMemoryRing::max_capacity));
+
+            int wakeup = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            if (wakeup < 0) throw std::system_error
+            {
+                errno, std::system_category(), "Could not create eventfd"
+            };
+
+            d->open_channel(msg->sender(), ring, wakeup);
+
+            reply = dbus::Message::make_method_return(msg);
+            reply->writer() << dbus::types::UnixFileDescriptor{ring->fd()}
+                            << dbus::types::UnixFileDescriptor{wakeup};
+        } catch(const std::exception& e)
+        {
+            LOG(WARNING) << "Could not open shared memory channel: " << e.what();
+
+            d->close_channel();
+            reply = dbus::Message::make_error(
+                        msg,
+                        remote::Interface::Errors::OpeningSharedMemoryChannel::name(),
+                        e.what());
+        }
+
+        d->bus->send(reply);
+    });
+
+    d->skeleton.object->install_method_handler<remote::Interface::CloseSharedMemoryChannel>([this](const dbus::Message::Ptr & msg)
+    {
+        VLOG(1) << "CloseSharedMemoryChannel";
+
+        if (d->may_access_channel(msg->sender()))
+            d->close_channel();
+        else
+            LOG(WARNING) << "Ignoring request of " << msg->sender() << " to close the shared memory channel of another peer.";
+
+        d->bus->send(dbus::Message::make_method_return(msg));
+    });
+
     d->skeleton.object->install_method_handler<remote::Interface::Supports>([this](const dbus::Message::Ptr & msg)
     {
         VLOG(1) << "Supports";
@@ -639,10 +1440,28 @@ remote::Provider::Skeleton::Skeleton(const remote::skeleton::Configuration& conf
         stop_velocity_updates();
         d->bus->send(dbus::Message::make_method_return(msg));
     });
+
+    d->skeleton.object->install_method_handler<remote::Interface::SetUpdateInterval>([this](const dbus::Message::Ptr & msg)
+    {
+        VLOG(1) << "SetUpdateInterval";
+
+        std::int64_t ms; msg->reader() >> ms;
+        d->bus->send(dbus::Message::make_method_return(msg));
+
+        set_update_interval(ms < 0 ?
+            cul::Optional<std::chrono::milliseconds>{} :
+            cul::Optional<std::chrono::milliseconds>{std::chrono::milliseconds{ms}});
+    });
+
+    // Stubs that talked to a previous instance refresh what they know about us.
+    d->skeleton.signals.capabilities_changed->emit(d->capabilities());
 }
 
 remote::Provider::Skeleton::~Skeleton() noexcept
 {
+    d->skeleton.object->uninstall_method_handler<remote::Interface::DescribeCapabilities>();
+    d->skeleton.object->uninstall_method_handler<remote::Interface::OpenSharedMemoryChannel>();
+    d->skeleton.object->uninstall_method_handler<remote::Interface::CloseSharedMemoryChannel>();
     d->skeleton.object->uninstall_method_handler<remote::Interface::MatchesCriteria>();
 
     d->skeleton.object->uninstall_method_handler<remote::Interface::StartPositionUpdates>();
@@ -653,6 +1472,11 @@ remote::Provider::Skeleton::~Skeleton() noexcept
 
     d->skeleton.object->uninstall_method_handler<remote::Interface::StartVelocityUpdates>();
     d->skeleton.object->uninstall_method_handler<remote::Interface::StopVelocityUpdates>();
+
+    d->skeleton.object->uninstall_method_handler<remote::Interface::SetUpdateInterval>();
+
+    // Withdraw whatever the remote end requested from the implementation.
+    set_update_interval(cul::Optional<std::chrono::milliseconds>{});
 }
 
 // We just forward calls to the actual implementation
@@ -720,3 +1544,9 @@ void remote::Provider::Skeleton::stop_velocity_updates()
 {
     d->impl->state_controller()->stop_velocity_updates();
 }
+
+void remote::Provider::Skeleton::set_update_interval(const cul::Optional<std::chrono::milliseconds>& interval)
+{
+    d->impl->state_controller()->replace_update_interval(d->update_interval, interval);
+    d->update_interval = interval;
+}
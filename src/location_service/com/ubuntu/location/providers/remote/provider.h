@@ -21,6 +21,7 @@
 #include <com/ubuntu/location/provider.h>
 #include <com/ubuntu/location/provider_factory.h>
 
+#include <com/ubuntu/location/providers/remote/interface.h>
 #include <com/ubuntu/location/providers/remote/skeleton.h>
 #include <com/ubuntu/location/providers/remote/stub.h>
 
@@ -57,6 +58,9 @@ struct Provider
         static constexpr const char* key_name{"name"};
         // Name of the command line parameter for passing in the path of the remote provider impl.
         static constexpr const char* key_path{"path"};
+        // Name of the command line parameter for passing in the capacity of the shared memory
+        // ring to receive updates through, 0 or absent for receiving updates via the bus.
+        static constexpr const char* key_shared_memory_capacity{"shared_memory_capacity"};
 
         ~Stub() noexcept;
 
@@ -78,6 +82,8 @@ struct Provider
         virtual void start_velocity_updates() override;
         virtual void stop_velocity_updates() override;
 
+        virtual void set_update_interval(const Optional<std::chrono::milliseconds>& interval) override;
+
     private:
         Stub(const stub::Configuration& config);
 
@@ -86,6 +92,22 @@ struct Provider
         // ping tries to reach out to the remote end and throws
         // if the ping fails.
         void ping();
+        // Hands out all updates of batch in order.
+        void deliver(const Interface::Batch& batch);
+        // Asks the remote end to hand out updates via a shared memory ring
+        // with room for capacity records. Throws in case of issues.
+        void open_shared_memory_channel(std::size_t capacity);
+        // Waits for the remote end to signal new records in the shared memory ring.
+        void read_from_shared_memory_channel();
+        // Opens the shared memory channel if configured, falling back to the bus on failure.
+        void try_open_shared_memory_channel();
+        // Tracks the owner of name on bus, reconnecting whenever the remote end restarts.
+        void watch(const core::dbus::Bus::Ptr& bus, const std::string& name);
+        // Marks the provider unavailable until the remote end comes back.
+        void on_remote_lost();
+        // Restores the state of the provider on a fresh remote end and marks
+        // the provider available again. Stays unavailable in case of issues.
+        void on_remote_appeared();
 
         struct Private;
         std::shared_ptr<Private> d;
@@ -116,6 +138,8 @@ struct Provider
         virtual void start_velocity_updates() override;
         virtual void stop_velocity_updates() override;
 
+        virtual void set_update_interval(const Optional<std::chrono::milliseconds>& interval) override;
+
     private:
         struct Private;
         std::shared_ptr<Private> d;
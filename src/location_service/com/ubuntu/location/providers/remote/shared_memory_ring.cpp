@@ -0,0 +1,327 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <com/ubuntu/location/providers/remote/shared_memory_ring.h>
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <linux/memfd.h>
+
+// Older userspace headers lack the sealing API, although the kernel might support it.
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS (1024 + 9)
+#define F_GET_SEALS (1024 + 10)
+#define F_SEAL_SEAL 0x0001
+#define F_SEAL_SHRINK 0x0002
+#define F_SEAL_GROW 0x0004
+#endif
+
+namespace cul = com::ubuntu::location;
+namespace remote = com::ubuntu::location::providers::remote;
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Sharing indices across processes requires lock-free 64-bit atomics.");
+static_assert(std::is_standard_layout<remote::SharedMemoryRing::Record>::value, "Records must have a fixed layout.");
+static_assert(sizeof(remote::SharedMemoryRing::Record) == 56, "Records must have a fixed size.");
+
+// The layout at the beginning of the shared memory region. Indices increase monotonically
+// and are reduced modulo capacity on access. Producer and consumer indices live on separate
+// cache lines such that both sides do not contend on the same line.
+struct remote::SharedMemoryRing::Header
+{
+    static constexpr std::uint32_t expected_magic{0x756c7372}; // "ulsr"
+    static constexpr std::uint32_t expected_version{1};
+
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t capacity;
+
+    alignas(64) std::atomic<std::uint64_t> head; // Written by the producer only.
+    alignas(64) std::atomic<std::uint64_t> tail; // Written by the consumer only.
+    alignas(64) std::atomic<std::uint64_t> dropped; // Written by the producer only.
+};
+
+constexpr std::uint32_t remote::SharedMemoryRing::Header::expected_magic;
+constexpr std::uint32_t remote::SharedMemoryRing::Header::expected_version;
+constexpr std::size_t remote::SharedMemoryRing::default_capacity;
+constexpr std::size_t remote::SharedMemoryRing::max_capacity;
+
+namespace
+{
+std::size_t next_power_of_two(std::size_t value)
+{
+    std::size_t result{1};
+    while (result < value)
+        result <<= 1;
+    return result;
+}
+
+void throw_system_error(const std::string& what)
+{
+    throw std::system_error{errno, std::system_category(), what};
+}
+}
+
+std::size_t remote::SharedMemoryRing::size_for_capacity(std::size_t capacity)
+{
+    return sizeof(Header) + capacity * sizeof(Record);
+}
+
+remote::SharedMemoryRing::Ptr remote::SharedMemoryRing::create(std::size_t capacity)
+{
+    capacity = next_power_of_two(std::max<std::size_t>(capacity, 1));
+    auto size = size_for_capacity(capacity);
+
+    int fd = ::syscall(SYS_memfd_create, "location-service-updates", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0)
+        throw_system_error("Could not create memfd");
+
+    if (::ftruncate(fd, size) < 0)
+    {
+        ::close(fd);
+        throw_system_error("Could not resize memfd");
+    }
+
+    // The consumer relies on the size not changing underneath its mapping.
+    if (::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0)
+    {
+        ::close(fd);
+        throw_system_error("Could not seal memfd");
+    }
+
+    auto mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        ::close(fd);
+        throw_system_error("Could not map memfd");
+    }
+
+    // The region is zero-filled, with that all indices start out at 0.
+    auto header = static_cast<Header*>(mapping);
+    header->magic = Header::expected_magic;
+    header->version = Header::expected_version;
+    header->capacity = capacity;
+
+    return Ptr{new SharedMemoryRing{fd, mapping, size}};
+}
+
+remote::SharedMemoryRing::Ptr remote::SharedMemoryRing::attach(int fd)
+{
+    auto fail = [fd](const std::string& what)
+    {
+        ::close(fd);
+        throw std::runtime_error{what};
+    };
+
+    auto seals = ::fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || not (seals & F_SEAL_SHRINK))
+        fail("Refusing to map an unsealed ring");
+
+    struct stat st;
+    if (::fstat(fd, &st) < 0 || st.st_size < static_cast<off_t>(sizeof(Header)))
+        fail("Ring is too small");
+
+    std::size_t size = st.st_size;
+    auto mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+        fail("Could not map ring");
+
+    auto header = static_cast<Header*>(mapping);
+    auto capacity = header->capacity;
+
+    if (header->magic != Header::expected_magic ||
+        header->version != Header::expected_version ||
+        capacity == 0 || (capacity & (capacity - 1)) != 0 ||
+        size_for_capacity(capacity) != size)
+    {
+        ::munmap(mapping, size);
+        fail("Ring has an unexpected layout");
+    }
+
+    return Ptr{new SharedMemoryRing{fd, mapping, size}};
+}
+
+remote::SharedMemoryRing::Record remote::SharedMemoryRing::encode(const cul::Update<cul::Position>& update)
+{
+    Record record;
+    std::memset(&record, 0, sizeof(record));
+
+    record.kind = Record::Kind::position;
+    record.when = update.when.time_since_epoch().count();
+    record.values[0] = update.value.latitude.value.value();
+    record.values[1] = update.value.longitude.value.value();
+
+    if (update.value.altitude)
+    {
+        record.flags |= Record::has_altitude;
+        record.values[2] = update.value.altitude->value.value();
+    }
+
+    if (update.value.accuracy.horizontal)
+    {
+        record.flags |= Record::has_horizontal_accuracy;
+        record.values[3] = update.value.accuracy.horizontal->value();
+    }
+
+    if (update.value.accuracy.vertical)
+    {
+        record.flags |= Record::has_vertical_accuracy;
+        record.values[4] = update.value.accuracy.vertical->value();
+    }
+
+    return record;
+}
+
+remote::SharedMemoryRing::Record remote::SharedMemoryRing::encode(const cul::Update<cul::Heading>& update)
+{
+    Record record;
+    std::memset(&record, 0, sizeof(record));
+
+    record.kind = Record::Kind::heading;
+    record.when = update.when.time_since_epoch().count();
+    record.values[0] = update.value.value();
+
+    return record;
+}
+
+remote::SharedMemoryRing::Record remote::SharedMemoryRing::encode(const cul::Update<cul::Velocity>& update)
+{
+    Record record;
+    std::memset(&record, 0, sizeof(record));
+
+    record.kind = Record::Kind::velocity;
+    record.when = update.when.time_since_epoch().count();
+    record.values[0] = update.value.value();
+
+    return record;
+}
+
+cul::Update<cul::Position> remote::SharedMemoryRing::decode_position(const Record& record)
+{
+    cul::Update<cul::Position> update
+    {
+        cul::Position{}, cul::Clock::Timestamp{cul::Clock::Duration{record.when}}
+    };
+
+    update.value.latitude = cul::wgs84::Latitude{record.values[0] * cul::units::Degrees};
+    update.value.longitude = cul::wgs84::Longitude{record.values[1] * cul::units::Degrees};
+
+    if (record.flags & Record::has_altitude)
+        update.value.altitude = cul::wgs84::Altitude{record.values[2] * cul::units::Meters};
+    if (record.flags & Record::has_horizontal_accuracy)
+        update.value.accuracy.horizontal = record.values[3] * cul::units::Meters;
+    if (record.flags & Record::has_vertical_accuracy)
+        update.value.accuracy.vertical = record.values[4] * cul::units::Meters;
+
+    return update;
+}
+
+cul::Update<cul::Heading> remote::SharedMemoryRing::decode_heading(const Record& record)
+{
+    return cul::Update<cul::Heading>
+    {
+        cul::Heading::from_value(record.values[0]),
+        cul::Clock::Timestamp{cul::Clock::Duration{record.when}}
+    };
+}
+
+cul::Update<cul::Velocity> remote::SharedMemoryRing::decode_velocity(const Record& record)
+{
+    return cul::Update<cul::Velocity>
+    {
+        cul::Velocity::from_value(record.values[0]),
+        cul::Clock::Timestamp{cul::Clock::Duration{record.when}}
+    };
+}
+
+remote::SharedMemoryRing::SharedMemoryRing(int fd, void* mapping, std::size_t size)
+    : memfd{fd},
+      mapping{mapping},
+      size{size},
+      header{static_cast<Header*>(mapping)},
+      slots{header->capacity},
+      records{reinterpret_cast<Record*>(static_cast<char*>(mapping) + sizeof(Header))}
+{
+}
+
+remote::SharedMemoryRing::~SharedMemoryRing()
+{
+    ::munmap(mapping, size);
+    ::close(memfd);
+}
+
+int remote::SharedMemoryRing::fd() const
+{
+    return memfd;
+}
+
+std::size_t remote::SharedMemoryRing::capacity() const
+{
+    return slots;
+}
+
+bool remote::SharedMemoryRing::push(const Record& record)
+{
+    auto head = header->head.load(std::memory_order_relaxed);
+    auto tail = header->tail.load(std::memory_order_acquire);
+
+    if (head - tail >= slots)
+    {
+        header->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    records[head & (slots - 1)] = record;
+    header->head.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool remote::SharedMemoryRing::pop(Record& record)
+{
+    auto tail = header->tail.load(std::memory_order_relaxed);
+    auto head = header->head.load(std::memory_order_acquire);
+
+    if (head == tail)
+        return false;
+
+    // The producer lives in a different process and we do not trust it blindly.
+    // The capacity we validated on attaching is used throughout for the same reason.
+    // If its index is off, we skip to its current position instead of reading garbage.
+    if (head - tail > slots)
+    {
+        header->tail.store(head, std::memory_order_release);
+        return false;
+    }
+
+    record = records[tail & (slots - 1)];
+    header->tail.store(tail + 1, std::memory_order_release);
+
+    return true;
+}
+
+std::uint64_t remote::SharedMemoryRing::dropped() const
+{
+    return header->dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LOCATION_SERVICE_COM_UBUNTU_LOCATION_PROVIDERS_REMOTE_SHARED_MEMORY_RING_H_
+#define LOCATION_SERVICE_COM_UBUNTU_LOCATION_PROVIDERS_REMOTE_SHARED_MEMORY_RING_H_
+
+#include <com/ubuntu/location/heading.h>
+#include <com/ubuntu/location/position.h>
+#include <com/ubuntu/location/update.h>
+#include <com/ubuntu/location/velocity.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace com
+{
+namespace ubuntu
+{
+namespace location
+{
+namespace providers
+{
+namespace remote
+{
+// A single-producer/single-consumer ring of fixed-layout update records,
+// living in a sealed memfd that is shared between a provider daemon and
+// the service. Samples travel without being marshalled through the bus daemon,
+// the bus is only used to hand over the file descriptors.
+class SharedMemoryRing
+{
+public:
+    typedef std::shared_ptr<SharedMemoryRing> Ptr;
+
+    // The fixed-layout representation of an update in the ring.
+    struct Record
+    {
+        enum class Kind : std::uint32_t
+        {
+            position = 0,
+            heading = 1,
+            velocity = 2
+        };
+
+        enum Flags : std::uint32_t
+        {
+            has_altitude = 1 << 0,
+            has_horizontal_accuracy = 1 << 1,
+            has_vertical_accuracy = 1 << 2
+        };
+
+        Kind kind;
+        std::uint32_t flags;
+        // Timestamp of the update in ticks of Clock::Duration.
+        std::int64_t when;
+        // Latitude, longitude, altitude, horizontal and vertical accuracy for positions,
+        // the raw value of the quantity in the first slot for headings and velocities.
+        double values[5];
+    };
+
+    // The number of records a ring has room for if not specified otherwise.
+    static constexpr std::size_t default_capacity{256};
+    // The number of records a ring handed out to a remote end has room for at most.
+    static constexpr std::size_t max_capacity{4096};
+
+    // Creates a new ring with room for at least capacity records.
+    // Throws if the ring cannot be set up, e.g., if the kernel lacks memfd support.
+    static Ptr create(std::size_t capacity = default_capacity);
+
+    // Maps the ring backed by fd, taking ownership of fd.
+    // Throws if fd does not refer to a sealed, valid ring.
+    static Ptr attach(int fd);
+
+    static Record encode(const Update<Position>& update);
+    static Record encode(const Update<Heading>& update);
+    static Record encode(const Update<Velocity>& update);
+
+    static Update<Position> decode_position(const Record& record);
+    static Update<Heading> decode_heading(const Record& record);
+    static Update<Velocity> decode_velocity(const Record& record);
+
+    SharedMemoryRing(const SharedMemoryRing&) = delete;
+    SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+    ~SharedMemoryRing();
+
+    // The memfd backing the ring, remaining owned by this instance.
+    int fd() const;
+
+    // The number of records the ring has room for.
+    std::size_t capacity() const;
+
+    // Appends record, returning false and dropping record if the ring is full.
+    // Must only be called by the producer.
+    bool push(const Record& record);
+
+    // Removes the oldest record into record, returning false if the ring is empty.
+    // Must only be called by the consumer.
+    bool pop(Record& record);
+
+    // The number of records that the producer dropped as the ring was full.
+    std::uint64_t dropped() const;
+
+private:
+    struct Header;
+
+    // The size of the shared memory region for a ring with room for capacity records.
+    static std::size_t size_for_capacity(std::size_t capacity);
+
+    SharedMemoryRing(int fd, void* mapping, std::size_t size);
+
+    int memfd;
+    void* mapping;
+    std::size_t size;
+    Header* header;
+    std::uint64_t slots;
+    Record* records;
+};
+}
+}
+}
+}
+}
+
+#endif // LOCATION_SERVICE_COM_UBUNTU_LOCATION_PROVIDERS_REMOTE_SHARED_MEMORY_RING_H_
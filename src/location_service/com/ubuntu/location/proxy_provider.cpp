@@ -19,19 +19,47 @@
 
 #include <bitset>
 #include <memory>
+#include <set>
 
 namespace cu = com::ubuntu;
 namespace cul = com::ubuntu::location;
 
+namespace
+{
+cul::ProviderSelection without_redundant_coarse_position_updates_provider(cul::ProviderSelection selection)
+{
+    if (selection.coarse_position_updates_provider == selection.position_updates_provider)
+        selection.coarse_position_updates_provider.reset();
+
+    return selection;
+}
+
+cul::ProviderSelection without_coarse_position_updates_provider(cul::ProviderSelection selection)
+{
+    selection.coarse_position_updates_provider.reset();
+    return selection;
+}
+}
+
 cul::ProxyProvider::ProxyProvider(const cul::ProviderSelection& selection)
+    : ProxyProvider(without_coarse_position_updates_provider(selection), cul::Criteria{})
+{
+}
+
+cul::ProxyProvider::ProxyProvider(const cul::ProviderSelection& selection,
+                                  const cul::Criteria& criteria)
     : Provider(selection.to_feature_flags()),
-      providers(selection),
+      providers(without_redundant_coarse_position_updates_provider(selection)),
+      target_accuracy(criteria.accuracy.horizontal),
       connections
       {
           providers.position_updates_provider->updates().position.connect(
               [this](const cul::Update<cul::Position>& u)
               {
                   mutable_updates().position(u);
+
+                  if (hedging && u.value.accuracy.horizontal && *u.value.accuracy.horizontal <= this->target_accuracy)
+                      stop_hedging();
               }),
           providers.heading_updates_provider->updates().heading.connect(
               [this](const cul::Update<cul::Heading>& u)
@@ -42,25 +70,54 @@ cul::ProxyProvider::ProxyProvider(const cul::ProviderSelection& selection)
               [this](const cul::Update<cul::Velocity>& u)
               {
                   mutable_updates().velocity(u);
-              })
+              }),
+          providers.position_updates_provider->updates().position_batch.connect(
+              [this](const std::vector<cul::Update<cul::Position>>& batch)
+              {
+                  mutable_updates().position_batch(batch);
+              }),
+          {}
       }
 {
+    // Without a coarse provider, hedging never starts.
+    if (not providers.coarse_position_updates_provider)
+        return;
+
+    connections.coarse_position_updates.push_back(providers.coarse_position_updates_provider->updates().position.connect(
+        [this](const cul::Update<cul::Position>& u)
+        {
+            // Coarse fixes are only of interest until the precise provider took over.
+            if (hedging)
+                mutable_updates().position(u);
+        }));
 }
 
 cul::ProxyProvider::~ProxyProvider() noexcept
 {
+    set_update_interval(Optional<std::chrono::milliseconds>{});
 }
 
 void cul::ProxyProvider::start_position_updates()
 {
+    if (providers.coarse_position_updates_provider && not hedging.exchange(true))
+        providers.coarse_position_updates_provider->state_controller()->start_position_updates();
+
     providers.position_updates_provider->state_controller()->start_position_updates();
 }
 
 void cul::ProxyProvider::stop_position_updates()
 {
+    stop_hedging();
     providers.position_updates_provider->state_controller()->stop_position_updates();
 }
 
+void cul::ProxyProvider::stop_hedging()
+{
+    // Both, a sufficiently accurate fix and stopping updates, might race to stop the coarse provider.
+    if (hedging.exchange(false))
+        providers.coarse_position_updates_provider->state_controller()->stop_position_updates();
+}
+
 void cul::ProxyProvider::start_velocity_updates()
 {
     providers.velocity_updates_provider->state_controller()->start_velocity_updates();
@@ -80,3 +137,22 @@ void cul::ProxyProvider::stop_heading_updates()
 {
     providers.heading_updates_provider->state_controller()->stop_heading_updates();
 }
+
+void cul::ProxyProvider::set_update_interval(const cul::Optional<std::chrono::milliseconds>& interval)
+{
+    // A provider might have been selected for more than one feature.
+    std::set<cul::Provider::Ptr> selected
+    {
+        providers.position_updates_provider,
+        providers.heading_updates_provider,
+        providers.velocity_updates_provider
+    };
+
+    if (providers.coarse_position_updates_provider)
+        selected.insert(providers.coarse_position_updates_provider);
+
+    for (const auto& provider : selected)
+        provider->state_controller()->replace_update_interval(update_interval, interval);
+
+    update_interval = interval;
+}
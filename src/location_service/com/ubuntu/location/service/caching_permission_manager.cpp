@@ -0,0 +1,196 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <com/ubuntu/location/service/caching_permission_manager.h>
+
+#include <com/ubuntu/location/logging.h>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace location = com::ubuntu::location;
+namespace service = com::ubuntu::location::service;
+
+namespace
+{
+// Reads the start time of pid in [clock ticks since boot], see man 5 proc.
+std::uint64_t start_time_for_pid(pid_t pid)
+{
+    std::stringstream fn; fn << "/proc/" << pid << "/stat";
+    std::ifstream in{fn.str()};
+
+    std::string stat;
+    if (not std::getline(in, stat)) throw std::runtime_error
+    {
+        "Could not read " + fn.str()
+    };
+
+    // The command name might contain spaces and parentheses, so we
+    // start parsing after its closing parenthesis.
+    auto pos = stat.rfind(')');
+    if (pos == std::string::npos) throw std::runtime_error
+    {
+        "Could not parse " + fn.str()
+    };
+
+    std::stringstream ss{stat.substr(pos + 1)};
+    std::string field;
+    // The start time is field 22, with the state being field 3.
+    for (unsigned int i = 3; i < 22; i++)
+        ss >> field;
+
+    std::uint64_t start_time{0};
+    if (not (ss >> start_time)) throw std::runtime_error
+    {
+        "Could not parse start time from " + fn.str()
+    };
+
+    return start_time;
+}
+
+// Reads the AppArmor profile of pid, returning an empty string if AppArmor is not available.
+std::string app_armor_profile_for_pid(pid_t pid)
+{
+    std::stringstream fn; fn << "/proc/" << pid << "/attr/current";
+    std::ifstream in{fn.str()};
+
+    std::string label;
+    if (not std::getline(in, label))
+        return std::string{};
+
+    // Confined processes carry their mode, e.g., "profile (enforce)".
+    auto pos = label.rfind(" (");
+    if (pos != std::string::npos)
+        label.erase(pos);
+
+    return label;
+}
+}
+
+const std::chrono::seconds service::CachingPermissionManager::default_lifetime{5 * 60};
+
+service::CachingPermissionManager::KeyResolver service::CachingPermissionManager::proc_key_resolver()
+{
+    return [](const service::Credentials& credentials)
+    {
+        return Key
+        {
+            credentials.uid,
+            start_time_for_pid(credentials.pid),
+            app_armor_profile_for_pid(credentials.pid)
+        };
+    };
+}
+
+service::CachingPermissionManager::CachingPermissionManager(
+        const service::PermissionManager::Ptr& impl,
+        const service::CachingPermissionManager::KeyResolver& key_resolver,
+        const std::chrono::milliseconds& lifetime)
+    : impl{impl},
+      key_resolver{key_resolver},
+      lifetime{lifetime}
+{
+    if (not impl) throw std::runtime_error
+    {
+        "Cannot decorate a null PermissionManager"
+    };
+}
+
+location::Optional<service::PermissionManager::Result> service::CachingPermissionManager::cached_permission_for_credentials(
+        const service::Credentials& credentials)
+{
+    auto key = key_for_credentials(credentials);
+
+    if (key)
+        return cached_permission_for_key(*key);
+
+    return location::Optional<Result>{};
+}
+
+service::PermissionManager::Result service::CachingPermissionManager::check_permission_for_credentials(
+        const location::Criteria& criteria,
+        const service::Credentials& credentials)
+{
+    auto before = key_for_credentials(credentials);
+
+    if (before)
+        if (auto result = cached_permission_for_key(*before))
+            return *result;
+
+    stats.misses++;
+
+    // We do not hold the lock while consulting impl, as it might end up prompting the user.
+    auto result = impl->check_permission_for_credentials(criteria, credentials);
+
+    // We resolve the key again, making sure that the process has not been replaced,
+    // e.g., by a new process reusing the pid, while the decision was pending.
+    auto after = key_for_credentials(credentials);
+    if (not before || not after || *before != *after)
+        return result;
+
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lg(guard);
+
+    // Expired decisions are dropped here, keeping the cache bounded by the
+    // number of distinct callers within one lifetime.
+    for (auto it = decisions.begin(); it != decisions.end();)
+    {
+        if (it->second.second <= now)
+            it = decisions.erase(it);
+        else
+            ++it;
+    }
+
+    decisions[*after] = std::make_pair(result, now + lifetime);
+
+    return result;
+}
+
+const service::CachingPermissionManager::Statistics& service::CachingPermissionManager::statistics() const
+{
+    return stats;
+}
+
+location::Optional<service::PermissionManager::Result> service::CachingPermissionManager::cached_permission_for_key(
+        const service::CachingPermissionManager::Key& key)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto it = decisions.find(key);
+    if (it != decisions.end() && std::chrono::steady_clock::now() < it->second.second)
+    {
+        stats.hits++;
+        return it->second.first;
+    }
+
+    return location::Optional<Result>{};
+}
+
+location::Optional<service::CachingPermissionManager::Key> service::CachingPermissionManager::key_for_credentials(
+        const service::Credentials& credentials)
+{
+    try
+    {
+        return key_resolver(credentials);
+    } catch(const std::exception& e)
+    {
+        VLOG(1) << "Could not resolve credentials of pid " << credentials.pid << ": " << e.what();
+    }
+
+    return location::Optional<Key>{};
+}
@@ -19,6 +19,7 @@
 #include <com/ubuntu/location/logging.h>
 #include <com/ubuntu/location/boost_ptree_settings.h>
 #include <com/ubuntu/location/provider_factory.h>
+#include <com/ubuntu/location/write_behind_settings.h>
 
 #include <com/ubuntu/location/logging.h>
 #include <com/ubuntu/location/connectivity/dummy_connectivity_manager.h>
@@ -45,6 +46,8 @@
 #include <boost/asio.hpp>
 #include <boost/filesystem.hpp>
 
+#include <chrono>
+#include <future>
 #include <system_error>
 #include <thread>
 
@@ -86,6 +89,7 @@ location::ProgramOptions init_daemon_options()
 
     options.add("help", "Produces this help message");
     options.add("testing", "Enables running the service without providers");
+    options.add("hedge-position-updates", "Bridges the time to an accurate satellite-based fix with coarse fixes");
     
     std::string config_path = location::service::SystemConfiguration::instance().runtime_persistent_data_dir().string();
     options.add("config-file",
@@ -121,6 +125,8 @@ location::service::Daemon::Configuration location::service::Daemon::Configuratio
     result.incoming = factory(mutable_daemon_options().bus());
     result.outgoing = factory(mutable_daemon_options().bus());
 
+    result.hedge_position_updates = mutable_daemon_options().value_count_for_key("hedge-position-updates") > 0;
+
     if (mutable_daemon_options().value_count_for_key("testing") == 0 && mutable_daemon_options().value_count_for_key("provider") == 0)
     {
         std::stringstream ss;
@@ -165,7 +171,7 @@ location::service::Daemon::Configuration location::service::Daemon::Configuratio
     }
 
     auto settings = std::make_shared<location::BoostPtreeSettings>(mutable_daemon_options().value_for_key<std::string>("config-file"));
-    result.settings = std::make_shared<location::SyncingSettings>(settings);
+    result.settings = std::make_shared<location::WriteBehindSettings>(settings);
 
     return result;
 }
@@ -175,30 +181,56 @@ void location::service::Daemon::print_help(std::ostream& out)
     mutable_daemon_options().print_help(out);
 }
 
-void location::service::Daemon::load_providers(const Configuration& config, std::shared_ptr<Engine> engine)
+std::vector<std::future<void>> location::service::Daemon::load_providers(const Configuration& config, std::shared_ptr<Engine> engine)
 {
+    std::vector<std::future<void>> result;
+
     for (const std::string& provider : config.providers)
     {
         std::cout << "Instantiating and configuring: " << provider << std::endl;
 
-        try
+        auto provider_config = config.provider_options.count(provider) > 0 ?
+                    config.provider_options.at(provider) : location::Configuration {};
+
+        // We instantiate all providers concurrently and hand each one of them to the engine
+        // as soon as it becomes available. With that, a slow provider (e.g., a remote provider
+        // waiting for its bus name to show up) does not hold up any of the other providers.
+        result.push_back(std::async(std::launch::async, [provider, provider_config, engine]()
         {
-            auto result = std::async(std::launch::async, [provider, config, engine] {
-                return location::ProviderFactory::instance().create_provider_for_name_with_config(
+            auto then = std::chrono::steady_clock::now();
+
+            try
+            {
+                bool added = false;
+                location::ProviderFactory::instance().create_provider_for_name_with_config(
                     provider,
-                    config.provider_options.count(provider) > 0 ?
-                        config.provider_options.at(provider) : location::Configuration {},
-                    [engine](Provider::Ptr provider)
+                    provider_config,
+                    [engine, &added](Provider::Ptr provider)
                     {
                         engine->add_provider(provider);
+                        added = true;
                     }
                 );
-            });
-        } catch(const std::runtime_error& e)
-        {
-            std::cerr << "Issue instantiating provider: " << e.what() << std::endl;
-        }
+
+                if (not added)
+                {
+                    LOG(WARNING) << "Unknown provider " << provider << ", skipping";
+                    return;
+                }
+
+                LOG(INFO) << "Instantiated and added provider " << provider << " in "
+                          << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - then).count()
+                          << " [ms]";
+            } catch(const std::exception& e)
+            {
+                LOG(ERROR) << "Issue instantiating provider " << provider << " after "
+                           << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - then).count()
+                           << " [ms]: " << e.what();
+            }
+        }));
     }
+
+    return result;
 }
 
 int location::service::Daemon::main(const location::service::Daemon::Configuration& config)
@@ -231,8 +263,16 @@ int location::service::Daemon::main(const location::service::Daemon::Configurati
     auto runtime = location::service::Runtime::create(4);
 
     location::service::DefaultConfiguration dc;
-    auto engine = dc.the_engine(std::set<location::Provider::Ptr>{}, dc.the_provider_selection_policy(), config.settings);
-    load_providers(config, engine);
+    // The engine handles all provider events on the runtime's strand and hands out provider
+    // updates to sessions from there, such that providers do not run the fan-out on their own threads.
+    auto engine = dc.the_engine(
+                std::set<location::Provider::Ptr>{},
+                dc.the_provider_selection_policy(config.hedge_position_updates),
+                config.settings,
+                runtime->to_dispatcher_functional());
+    // Providers are loaded in the background, we do not wait for them before exposing the
+    // service on the bus. We keep the pending loads around until we shut down.
+    auto pending_provider_loads = load_providers(config, engine);
 
     config.incoming->install_executor(dbus::asio::make_executor(config.incoming, runtime->service()));
     config.outgoing->install_executor(dbus::asio::make_executor(config.outgoing, runtime->service()));
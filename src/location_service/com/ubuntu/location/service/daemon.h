@@ -24,6 +24,7 @@
 
 #include <com/ubuntu/location/service/dbus_connection_factory.h>
 
+#include <future>
 #include <iosfwd>
 #include <string>
 #include <vector>
@@ -140,6 +141,8 @@ struct Daemon
          *   --testing             Enables executing the service without selected providers
          *   --provider arg        The providers that should be added to the engine
          *   --config-file arg     The config file we should read from/write to
+         *   --hedge-position-updates
+         *                         Bridges the time to an accurate satellite-based fix with coarse fixes
          */
         static Configuration from_command_line_args(
                 int argc,
@@ -157,6 +160,11 @@ struct Daemon
         {
             false
         };
+        /** @brief Hedges satellite-based position updates with coarse ones until an accurate fix. */
+        bool hedge_position_updates
+        {
+            false
+        };
         /** @brief Providers that have been requested on the command line. */
         std::vector<std::string> providers;
         /** @brief Provider-specific options keyed on the provider name. */
@@ -168,8 +176,15 @@ struct Daemon
     /** @brief Pretty-prints the CLI's help text to the given output stream. */
     static void print_help(std::ostream& out);
 
-    /** @brief Instantiates and configures each provider selected in the config */
-    static void load_providers(const Configuration& config, std::shared_ptr<location::Engine> engine);
+    /**
+     * @brief Instantiates and configures each provider selected in the config.
+     *
+     * Providers are instantiated concurrently and added to the engine as soon as
+     * they become available, the function does not wait for any of them. The returned
+     * futures become ready once the respective provider has been added to the engine
+     * or failed to load. Destroying the futures waits for outstanding instantiations.
+     */
+    static std::vector<std::future<void>> load_providers(const Configuration& config, std::shared_ptr<location::Engine> engine);
 
     /**
      * @brief Executes the daemon with the given configuration.
@@ -30,7 +30,16 @@ cul::Engine::Ptr culs::DefaultConfiguration::the_engine(
     const cul::ProviderSelectionPolicy::Ptr& provider_selection_policy,
     const cul::Settings::Ptr& settings)
 {
-    auto engine = std::make_shared<cul::Engine>(provider_selection_policy, settings);
+    return the_engine(provider_set, provider_selection_policy, settings, cul::Engine::Dispatcher{});
+}
+
+cul::Engine::Ptr culs::DefaultConfiguration::the_engine(
+    const std::set<cul::Provider::Ptr>& provider_set,
+    const cul::ProviderSelectionPolicy::Ptr& provider_selection_policy,
+    const cul::Settings::Ptr& settings,
+    const cul::Engine::Dispatcher& dispatcher)
+{
+    auto engine = std::make_shared<cul::Engine>(provider_selection_policy, settings, dispatcher);
     for (const auto& provider : provider_set)
         engine->add_provider(provider);
 
@@ -39,7 +48,12 @@ cul::Engine::Ptr culs::DefaultConfiguration::the_engine(
 
 cul::ProviderSelectionPolicy::Ptr culs::DefaultConfiguration::the_provider_selection_policy()
 {
-    return std::make_shared<cul::FusionProviderSelectionPolicy>();
+    return the_provider_selection_policy(false);
+}
+
+cul::ProviderSelectionPolicy::Ptr culs::DefaultConfiguration::the_provider_selection_policy(bool hedge_position_updates)
+{
+    return std::make_shared<cul::FusionProviderSelectionPolicy>(hedge_position_updates);
 }
 
 std::set<cul::Provider::Ptr> culs::DefaultConfiguration::the_provider_set(
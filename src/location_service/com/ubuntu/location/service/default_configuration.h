@@ -20,6 +20,7 @@
 
 #include <com/ubuntu/location/service/configuration.h>
 
+#include <com/ubuntu/location/engine.h>
 #include <com/ubuntu/location/settings.h>
 
 #include <set>
@@ -45,6 +46,10 @@ public:
     // as specified by a client application.
     virtual ProviderSelectionPolicy::Ptr the_provider_selection_policy();
 
+    // Creates a policy instance as above, hedging slow satellite-based position
+    // updates with coarse ones if hedge_position_updates is true.
+    virtual ProviderSelectionPolicy::Ptr the_provider_selection_policy(bool hedge_position_updates);
+
     // Returns a set of providers, seeded with the seed provider if it is not null.
     virtual std::set<Provider::Ptr> the_provider_set(const Provider::Ptr& seed = Provider::Ptr {});
 
@@ -55,6 +60,13 @@ public:
         const ProviderSelectionPolicy::Ptr& provider_selection_policy,
         const Settings::Ptr& settings);
 
+    // Creates an engine instance as above, handling all provider events on dispatcher.
+    virtual std::shared_ptr<Engine> the_engine(
+        const std::set<Provider::Ptr>& provider_set,
+        const ProviderSelectionPolicy::Ptr& provider_selection_policy,
+        const Settings::Ptr& settings,
+        const Engine::Dispatcher& dispatcher);
+
     // Instantiates an instance of the permission manager.
     virtual PermissionManager::Ptr the_permission_manager(const std::shared_ptr<core::dbus::Bus>& bus);
 };
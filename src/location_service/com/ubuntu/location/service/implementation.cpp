@@ -32,6 +32,7 @@
 #include <core/dbus/traits/service.h>
 #include <core/dbus/types/object_path.h>
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <sstream>
@@ -41,6 +42,8 @@ namespace culs = com::ubuntu::location::service;
 
 namespace dbus = core::dbus;
 
+const std::chrono::minutes culs::Implementation::statistics_report_period{15};
+
 culs::Implementation::Implementation(const culs::Implementation::Configuration& config)
     : Skeleton
       {
@@ -59,7 +62,8 @@ culs::Implementation::Implementation(const culs::Implementation::Configuration&
               {
                   new culs::Skeleton::ObjectPathGenerator{}
               },
-              config.permission_manager
+              config.permission_manager,
+              config.session_limits
           }
       },
       configuration(config),
@@ -166,6 +170,11 @@ culs::Implementation::Implementation(const culs::Implementation::Configuration&
     does_satellite_based_positioning() =
             configuration.engine->configuration.satellite_based_positioning_state ==
             cul::SatelliteBasedPositioningState::on;
+
+    statistics_report.schedule(statistics_report_period, [this]()
+    {
+        report_statistics();
+    });
 }
 
 culs::session::Interface::Ptr culs::Implementation::create_session_for_criteria(const cul::Criteria& criteria)
@@ -174,8 +183,60 @@ culs::session::Interface::Ptr culs::Implementation::create_session_for_criteria(
             = configuration.engine->determine_provider_selection_for_criteria(criteria);
     auto proxy_provider = ProxyProvider::Ptr
     {
-        new ProxyProvider{provider_selection}
+        new ProxyProvider{provider_selection, criteria}
+    };
+
+    session::Interface::Ptr session{new culs::session::Implementation(proxy_provider)};
+    // The session only delivers updates as often as requested by the client.
+    session->updates().filter = criteria.updates;
+
+    return session;
+}
+
+std::tuple<cul::Update<cul::Position>, std::chrono::milliseconds> culs::Implementation::last_known_position()
+{
+    cul::Optional<cul::Update<cul::Position>> update =
+            configuration.engine->updates.last_known_location.get();
+
+    if (not update) throw std::runtime_error
+    {
+        "No position fix known yet"
     };
 
-    return session::Interface::Ptr{new culs::session::Implementation(proxy_provider)};
+    auto age = std::chrono::duration_cast<std::chrono::milliseconds>(cul::Clock::now() - update->when);
+
+    return std::make_tuple(*update, std::max(std::chrono::milliseconds{0}, age));
+}
+
+std::map<cul::Provider::Ptr, cul::StateTrackingProvider::Statistics> culs::Implementation::provider_statistics() const
+{
+    return configuration.engine->provider_statistics();
+}
+
+void culs::Implementation::report_statistics()
+{
+    for (const auto& pair : provider_statistics())
+    {
+        const auto& stats = pair.second;
+
+        LOG(INFO) << "Provider " << pair.first.get() << ": "
+                  << "starts: " << stats.starts << ", "
+                  << "stops: " << stats.stops << ", "
+                  << "cancelled stops: " << stats.cancelled_stops << ", "
+                  << "first fixes: " << stats.first_fixes << ", "
+                  << "time to first fix p50: " << stats.time_to_first_fix_p50.count() << " [ms], "
+                  << "p90: " << stats.time_to_first_fix_p90.count() << " [ms], "
+                  << "p99: " << stats.time_to_first_fix_p99.count() << " [ms]";
+    }
+
+    const auto& permissions = permission_statistics();
+    auto hits = permissions.hits.load(), misses = permissions.misses.load();
+
+    LOG(INFO) << "Permission cache hits: " << hits << ", misses: " << misses << ", "
+              << "hit rate: " << (hits + misses > 0 ? 100. * hits / (hits + misses) : 0.) << " [%]";
+
+    statistics_report.schedule(statistics_report_period, [this]()
+    {
+        report_statistics();
+    });
 }
@@ -21,8 +21,10 @@
 #include <com/ubuntu/location/engine.h>
 #include <com/ubuntu/location/connectivity/manager.h>
 #include <com/ubuntu/location/service/harvester.h>
+#include <com/ubuntu/location/service/runtime.h>
 #include <com/ubuntu/location/service/skeleton.h>
 
+#include <map>
 #include <memory>
 
 namespace dbus = core::dbus;
@@ -53,6 +55,8 @@ public:
         PermissionManager::Ptr permission_manager;
         // All harvesting specific options.
         Harvester::Configuration harvester;
+        // Budget of every individual session.
+        session::Skeleton::Limits session_limits;
     };
 
     // Creates a new instance of the service with the given configuration.
@@ -62,7 +66,20 @@ public:
     // Creates a new session for the given criteria.
     session::Interface::Ptr create_session_for_criteria(const Criteria& criteria);
 
+    // Answers from the last known location cached by the engine.
+    std::tuple<Update<Position>, std::chrono::milliseconds> last_known_position();
+
+    // Returns the start/stop and time to first fix counters of all providers known to the engine.
+    std::map<Provider::Ptr, StateTrackingProvider::Statistics> provider_statistics() const;
+
+    // Statistics are logged this often.
+    static const std::chrono::minutes statistics_report_period;
+
   private:
+    // Logs provider_statistics() and the permission cache's hit rate, and
+    // schedules the next report.
+    void report_statistics();
+
     // The service configuration.
     Configuration configuration;
     // The harvester instance.
@@ -78,6 +95,9 @@ public:
         core::ScopedConnection visible_space_vehicles;
         core::ScopedConnection reference_position;
     } connections;
+    // Reports statistics periodically. Declared last, such that
+    // a running report finishes before any other member goes away.
+    Timer statistics_report;
 };
 }
 }
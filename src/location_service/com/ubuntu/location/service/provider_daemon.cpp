@@ -46,6 +46,12 @@ location::ProgramOptions init_daemon_options()
                              "The dbus object path under which the provider is known.");
     options.add<std::string>("provider",
                              "The provider that should be exposed to the bus");
+    options.add<std::uint64_t>("batch-interval",
+                               "Updates are sent out in batches held back for at most this many [ms], 0 disables batching.",
+                               0);
+    options.add<std::size_t>("batch-size",
+                             "Batches are sent out as soon as they contain this many updates.",
+                             16);
 
     return options;
 }
@@ -76,6 +82,12 @@ location::service::ProviderDaemon::Configuration location::service::ProviderDaem
         mutable_daemon_options().value_for_key<std::string>("service-path")
     });
 
+    result.batching.flush_interval = std::chrono::milliseconds
+    {
+        mutable_daemon_options().value_for_key<std::uint64_t>("batch-interval")
+    };
+    result.batching.max_size = mutable_daemon_options().value_for_key<std::size_t>("batch-size");
+
     auto provider_name = mutable_daemon_options().value_for_key<std::string>("provider");
     location::Configuration config;
 
@@ -135,7 +147,8 @@ int location::service::ProviderDaemon::main(const location::service::ProviderDae
     {
         config.object,
         config.connection,
-        config.provider
+        config.provider,
+        config.batching
     });
 
     runtime()->start();
@@ -20,6 +20,8 @@
 
 #include <com/ubuntu/location/provider.h>
 
+#include <com/ubuntu/location/providers/remote/skeleton.h>
+
 #include <com/ubuntu/location/service/dbus_connection_factory.h>
 
 #include <core/dbus/bus.h>
@@ -48,6 +50,8 @@ struct ProviderDaemon
         //   --service-name=name: The name of the service under which the provider should be exposed.
         //   --service-path=path: The dbus object path under which the provider is known.
         //   --provider=name: The name of the actual provider implementation.
+        //   --batch-interval=ms: Updates are held back for at most ms before being sent out, 0 disables batching.
+        //   --batch-size=n: Batches are sent out as soon as they contain n updates.
         static Configuration from_command_line_args(int argc, const char** argv, DBusConnectionFactory factory);
 
         // The bus connection that should be used by the remote::Provider::Skeleton instance.
@@ -56,6 +60,8 @@ struct ProviderDaemon
         core::dbus::Object::Ptr object;
         // The actual provider implementation.
         Provider::Ptr provider;
+        // How updates are coalesced before being sent out.
+        providers::remote::skeleton::Configuration::Batching batching;
     };
 
     // Executes the daemon with the given configuration.
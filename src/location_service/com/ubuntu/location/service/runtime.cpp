@@ -19,6 +19,10 @@
 
 #include <com/ubuntu/location/logging.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <set>
+
 namespace culs = com::ubuntu::location::service;
 
 namespace
@@ -58,6 +62,18 @@ std::shared_ptr<culs::Runtime> culs::Runtime::create(std::uint32_t pool_size)
     return std::shared_ptr<culs::Runtime>(new culs::Runtime(pool_size));
 }
 
+std::shared_ptr<culs::Runtime> culs::Runtime::shared()
+{
+    static const std::shared_ptr<culs::Runtime> runtime = []()
+    {
+        auto rt = culs::Runtime::create(1);
+        rt->start();
+        return rt;
+    }();
+
+    return runtime;
+}
+
 culs::Runtime::Runtime(std::uint32_t pool_size)
     : pool_size_{pool_size},
       service_{pool_size_},
@@ -107,3 +123,104 @@ boost::asio::io_service& culs::Runtime::service()
 {
     return service_;
 }
+
+struct culs::Timer::Private
+{
+    Private(const std::shared_ptr<culs::Runtime>& runtime)
+        : runtime{runtime},
+          timer{runtime->service()}
+    {
+    }
+
+    // Keeps the io_service executing timer alive.
+    std::shared_ptr<culs::Runtime> runtime;
+    std::mutex guard;
+    // Signaled whenever a task finished.
+    std::condition_variable idle;
+    bool stopped{false};
+    // Bumped for every task, such that a task replaced while
+    // already being due is not executed.
+    std::uint64_t generation{0};
+    // The threads executing a task.
+    std::set<std::thread::id> running;
+    boost::asio::steady_timer timer;
+};
+
+culs::Timer::Timer(const std::shared_ptr<culs::Runtime>& runtime)
+    : d{std::make_shared<Private>(runtime)}
+{
+}
+
+culs::Timer::~Timer() noexcept(true)
+{
+    stop();
+}
+
+void culs::Timer::stop()
+{
+    std::unique_lock<std::mutex> ul(d->guard);
+    d->stopped = true;
+    d->timer.cancel();
+
+    // A task tearing down its own timer does not wait for itself.
+    auto self = std::this_thread::get_id();
+    d->idle.wait(ul, [this, self]()
+    {
+        return d->running.empty() || (d->running.size() == 1 && d->running.count(self) > 0);
+    });
+}
+
+void culs::Timer::schedule(const std::chrono::milliseconds& delay, const std::function<void()>& task)
+{
+    std::lock_guard<std::mutex> lg(d->guard);
+
+    if (d->stopped)
+        return;
+
+    auto generation = ++d->generation;
+
+    d->timer.expires_from_now(delay);
+
+    std::weak_ptr<Private> wp{d};
+    d->timer.async_wait([wp, generation, task](const boost::system::error_code& ec)
+    {
+        if (ec == boost::asio::error::operation_aborted)
+            return;
+
+        auto d = wp.lock();
+        if (not d)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lg(d->guard);
+            if (d->stopped || generation != d->generation)
+                return;
+            d->running.insert(std::this_thread::get_id());
+        }
+
+        try
+        {
+            task();
+        } catch(const std::exception& e)
+        {
+            LOG(WARNING) << e.what();
+        } catch(...)
+        {
+            LOG(WARNING) << "Unknown exception caught while executing timer task";
+        }
+
+        {
+            std::lock_guard<std::mutex> lg(d->guard);
+            d->running.erase(std::this_thread::get_id());
+        }
+
+        d->idle.notify_all();
+    });
+}
+
+void culs::Timer::cancel()
+{
+    std::lock_guard<std::mutex> lg(d->guard);
+    d->generation++;
+    d->timer.cancel();
+}
@@ -20,6 +20,7 @@
 
 #include <boost/asio.hpp>
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <thread>
@@ -48,6 +49,10 @@ public:
     // executing the underlying service.
     static std::shared_ptr<Runtime> create(std::uint32_t pool_size = worker_threads);
 
+    // shared returns a process-wide, started Runtime with a single worker thread,
+    // for components that need to run timers instead of spinning up their own threads.
+    static std::shared_ptr<Runtime> shared();
+
     Runtime(const Runtime&) = delete;
     Runtime(Runtime&&) = delete;
     // Tears down the runtime, stopping all worker threads.
@@ -82,6 +87,34 @@ private:
     boost::asio::io_service::work keep_alive_;
     std::vector<std::thread> workers_;
 };
+
+// Timer executes a task once it is due on the io_service of a Runtime.
+// Tasks are never executed once the Timer is gone, with the destructor
+// waiting for a task that is already running.
+class Timer
+{
+public:
+    // Timer sets up a new instance executing tasks on runtime.
+    Timer(const std::shared_ptr<Runtime>& runtime = Runtime::shared());
+    Timer(const Timer&) = delete;
+    // Stops the timer, see stop().
+    ~Timer() noexcept(true);
+    Timer& operator=(const Timer&) = delete;
+
+    // schedule executes task once delay has elapsed, replacing a pending task.
+    void schedule(const std::chrono::milliseconds& delay, const std::function<void()>& task);
+
+    // cancel drops the pending task, if any.
+    void cancel();
+
+    // stop drops the pending task and waits for a running task to finish.
+    // Tasks scheduled afterwards are never executed.
+    void stop();
+
+private:
+    struct Private;
+    std::shared_ptr<Private> d;
+};
 }
 }
 }
@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <com/ubuntu/location/service/session/delivery_tracker.h>
+
+namespace culss = com::ubuntu::location::service::session;
+
+culss::DeliveryTracker::DeliveryTracker(
+        const culss::Skeleton::Limits& limits,
+        const std::shared_ptr<culss::Skeleton::Statistics>& statistics)
+    : limits(limits),
+      statistics(statistics)
+{
+}
+
+bool culss::DeliveryTracker::is_probe_due()
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (++untracked_updates < limits.probe_interval)
+        return false;
+
+    untracked_updates = 0;
+    return true;
+}
+
+culss::DeliveryTracker::Id culss::DeliveryTracker::sent(const std::function<void()>& cancel, const Timestamp& now)
+{
+    std::function<void()> drop;
+    Id id;
+
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        id = next_id++;
+        outstanding_updates[id] = Outstanding{now, cancel};
+
+        if (outstanding_updates.size() > limits.max_outstanding_updates)
+        {
+            auto oldest = outstanding_updates.begin();
+            drop = oldest->second.cancel;
+            outstanding_updates.erase(oldest);
+            statistics->dropped_updates++;
+        }
+    }
+
+    // We do not call out while holding the lock.
+    if (drop)
+        drop();
+
+    return id;
+}
+
+culss::DeliveryTracker::Verdict culss::DeliveryTracker::completed(Id id, bool succeeded, const Timestamp& now)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto it = outstanding_updates.find(id);
+    // The update might have been dropped in the meantime.
+    if (it == outstanding_updates.end())
+        return Verdict::keep;
+
+    auto sample = now - it->second.when;
+    outstanding_updates.erase(it);
+
+    if (not succeeded)
+    {
+        statistics->failed_updates++;
+        consecutive_failures++;
+    } else
+    {
+        consecutive_failures = 0;
+        // We smooth the latency with a gain of 1/8, similar to the round-trip
+        // estimation in TCP. A single slow reply thus does not evict a session.
+        latency = latency ? *latency + (sample - *latency) / 8 : sample;
+    }
+
+    if (evicted)
+        return Verdict::keep;
+
+    if (consecutive_failures >= limits.max_consecutive_failures)
+    {
+        evicted = true;
+        statistics->evicted_for_failures++;
+        return Verdict::evict_for_failures;
+    }
+
+    if (latency && *latency > limits.max_latency)
+    {
+        evicted = true;
+        statistics->evicted_for_latency++;
+        return Verdict::evict_for_latency;
+    }
+
+    return Verdict::keep;
+}
+
+std::size_t culss::DeliveryTracker::outstanding() const
+{
+    std::lock_guard<std::mutex> lg(guard);
+    return outstanding_updates.size();
+}
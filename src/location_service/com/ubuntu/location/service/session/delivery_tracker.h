@@ -0,0 +1,105 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_SESSION_DELIVERY_TRACKER_H_
+#define LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_SESSION_DELIVERY_TRACKER_H_
+
+#include <com/ubuntu/location/optional.h>
+#include <com/ubuntu/location/service/session/skeleton.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace com
+{
+namespace ubuntu
+{
+namespace location
+{
+namespace service
+{
+namespace session
+{
+// DeliveryTracker accounts for the updates sent to a client that are awaiting
+// a reply. It bounds their number by dropping the oldest one, and decides whether
+// the client exceeded its failure or latency budget and should thus be evicted.
+class DeliveryTracker
+{
+public:
+    // Identifies a tracked update.
+    typedef std::uint64_t Id;
+    // We measure latencies with a monotonic clock.
+    typedef std::chrono::steady_clock::time_point Timestamp;
+
+    // Summarizes the decision on the fate of a session.
+    enum class Verdict
+    {
+        keep,                   // The client is within its budget.
+        evict_for_failures,     // The client failed too many updates in a row.
+        evict_for_latency       // The client takes too long to reply to updates.
+    };
+
+    // Sets up a tracker for the given limits, accounting into statistics.
+    DeliveryTracker(const Skeleton::Limits& limits, const std::shared_ptr<Skeleton::Statistics>& statistics);
+    DeliveryTracker(const DeliveryTracker&) = delete;
+    DeliveryTracker& operator=(const DeliveryTracker&) = delete;
+
+    // Returns true iff the next update delivered without reply should be
+    // tracked instead to probe the client's responsiveness.
+    bool is_probe_due();
+
+    // Records an update awaiting a reply, sent at now. If more than the maximum
+    // number of updates are outstanding, the oldest one is dropped and cancelled
+    // by invoking its cancel functor.
+    Id sent(const std::function<void()>& cancel, const Timestamp& now = std::chrono::steady_clock::now());
+
+    // Records the reply to the update with the given id, received at now.
+    // Returns Verdict::keep if the session is within its budget. An eviction
+    // verdict is only handed out once.
+    Verdict completed(Id id, bool succeeded, const Timestamp& now = std::chrono::steady_clock::now());
+
+    // Returns the number of updates awaiting a reply.
+    std::size_t outstanding() const;
+
+private:
+    // Replies arrive on the bus thread, updates are sent from provider threads.
+    mutable std::mutex guard;
+    Skeleton::Limits limits;
+    std::shared_ptr<Skeleton::Statistics> statistics;
+    // Outstanding updates, ordered by age as ids are handed out incrementally.
+    struct Outstanding
+    {
+        Timestamp when;
+        std::function<void()> cancel;
+    };
+    std::map<Id, Outstanding> outstanding_updates;
+    Id next_id{0};
+    std::size_t untracked_updates{0};
+    std::size_t consecutive_failures{0};
+    // Smoothed latency of the client's replies.
+    Optional<std::chrono::steady_clock::duration> latency;
+    bool evicted{false};
+};
+}
+}
+}
+}
+}
+
+#endif // LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_SESSION_DELIVERY_TRACKER_H_
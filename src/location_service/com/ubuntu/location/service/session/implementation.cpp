@@ -19,13 +19,27 @@ struct culss::Implementation::Private
         core::ScopedConnection position_updates;
         core::ScopedConnection velocity_updates;
         core::ScopedConnection heading_updates;
+        core::ScopedConnection position_batch_updates;
 
         core::ScopedConnection position_status_updates;
         core::ScopedConnection heading_status_updates;
         core::ScopedConnection velocity_status_updates;
+
+        core::ScopedConnection filter_updates;
     } connections;
+    // The update interval requested from the provider while position updates are running.
+    Optional<std::chrono::milliseconds> update_interval;
 };
 
+namespace
+{
+// Sessions without an interval ask for updates as often as possible.
+std::chrono::milliseconds requested_update_interval_for_filter(const cul::Criteria::Updates& filter)
+{
+    return filter.interval ? *filter.interval : std::chrono::milliseconds{0};
+}
+}
+
 culss::Implementation::Implementation(const cul::Provider::Ptr& provider)
         : Interface(),
           d(new Private
@@ -47,6 +61,11 @@ culss::Implementation::Implementation(const cul::Provider::Ptr& provider)
                         {
                             updates().velocity = update;
                         }),
+                    provider->updates().position_batch.connect(
+                        [this](const std::vector<Update<Position>>& batch)
+                        {
+                            updates().position_batch(batch);
+                        }),
                     updates().position_status.changed().connect(
                         [this](const Interface::Updates::Status& status)
                         {
@@ -79,8 +98,19 @@ culss::Implementation::Implementation(const cul::Provider::Ptr& provider)
                             case Interface::Updates::Status::disabled:
                                 stop_heading_updates(); break;
                             }
+                        }),
+                    updates().filter.changed().connect(
+                        [this](const Criteria::Updates& filter)
+                        {
+                            if (not d->update_interval)
+                                return;
+
+                            auto interval = requested_update_interval_for_filter(filter);
+                            d->provider->state_controller()->replace_update_interval(d->update_interval, interval);
+                            d->update_interval = interval;
                         })
-                }
+                },
+                Optional<std::chrono::milliseconds>{}
             })
 {
 }
@@ -95,6 +125,12 @@ culss::Implementation::~Implementation() noexcept
 void culss::Implementation::start_position_updates()
 {
     VLOG(10) << __PRETTY_FUNCTION__;
+
+    // We request the interval first, such that the provider starts at the right pace.
+    auto interval = requested_update_interval_for_filter(updates().filter.get());
+    d->provider->state_controller()->replace_update_interval(d->update_interval, interval);
+    d->update_interval = interval;
+
     d->provider->state_controller()->start_position_updates();
 }
 
@@ -102,6 +138,12 @@ void culss::Implementation::stop_position_updates() noexcept
 {
     VLOG(10) << __PRETTY_FUNCTION__;
     d->provider->state_controller()->stop_position_updates();
+
+    if (d->update_interval)
+    {
+        d->provider->state_controller()->release_update_interval(*d->update_interval);
+        d->update_interval.reset();
+    }
 }
 
 void culss::Implementation::start_velocity_updates()
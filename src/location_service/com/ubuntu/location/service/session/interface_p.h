@@ -77,6 +77,24 @@ struct com::ubuntu::location::service::session::Interface::UpdateHeading
     inline static const std::chrono::milliseconds default_timeout() { return std::chrono::seconds{1}; }
 };
 
+struct com::ubuntu::location::service::session::Interface::UpdatePositionBatch
+{
+    typedef com::ubuntu::location::service::session::Interface Interface;
+
+    inline static const std::string& name()
+    {
+        static const std::string s
+        {
+            "UpdatePositionBatch"
+        };
+        return s;
+    }
+
+    typedef void ResultType;
+
+    inline static const std::chrono::milliseconds default_timeout() { return std::chrono::seconds{1}; }
+};
+
 struct com::ubuntu::location::service::session::Interface::StartPositionUpdates
 {
     typedef com::ubuntu::location::service::session::Interface Interface;
@@ -185,6 +203,60 @@ struct com::ubuntu::location::service::session::Interface::StopHeadingUpdates
     inline static const std::chrono::milliseconds default_timeout() { return std::chrono::seconds{5}; }
 };
 
+struct com::ubuntu::location::service::session::Interface::StartPositionBatches
+{
+    typedef com::ubuntu::location::service::session::Interface Interface;
+
+    inline static const std::string& name()
+    {
+        static const std::string s
+        {
+            "StartPositionBatches"
+        };
+        return s;
+    }
+
+    typedef void ResultType;
+
+    inline static const std::chrono::milliseconds default_timeout() { return std::chrono::seconds{5}; }
+};
+
+struct com::ubuntu::location::service::session::Interface::StopPositionBatches
+{
+    typedef com::ubuntu::location::service::session::Interface Interface;
+
+    inline static const std::string& name()
+    {
+        static const std::string s
+        {
+            "StopPositionBatches"
+        };
+        return s;
+    }
+
+    typedef void ResultType;
+
+    inline static const std::chrono::milliseconds default_timeout() { return std::chrono::seconds{5}; }
+};
+
+struct com::ubuntu::location::service::session::Interface::SetUpdateFilter
+{
+    typedef com::ubuntu::location::service::session::Interface Interface;
+
+    inline static const std::string& name()
+    {
+        static const std::string s
+        {
+            "SetUpdateFilter"
+        };
+        return s;
+    }
+
+    typedef void ResultType;
+
+    inline static const std::chrono::milliseconds default_timeout() { return std::chrono::seconds{5}; }
+};
+
 struct com::ubuntu::location::service::session::Interface::Errors::ErrorParsingUpdate
 {
     inline static std::string name()
@@ -201,6 +273,14 @@ struct com::ubuntu::location::service::session::Interface::Errors::ErrorStarting
     }
 };
 
+struct com::ubuntu::location::service::session::Interface::Errors::ErrorSettingUpdateFilter
+{
+    inline static std::string name()
+    {
+        return "com.ubuntu.location.Service.Session.ErrorSettingUpdateFilter";
+    }
+};
+
 namespace core
 {
 namespace dbus
@@ -16,8 +16,12 @@
  * Authored by: Thomas Voß <thomas.voss@canonical.com>
  */
 #include <com/ubuntu/location/service/session/skeleton.h>
+#include <com/ubuntu/location/service/session/delivery_tracker.h>
+#include <com/ubuntu/location/service/session/update_encoder.h>
+#include <com/ubuntu/location/service/session/update_filter.h>
 
 #include <com/ubuntu/location/logging.h>
+#include <com/ubuntu/location/service/runtime.h>
 
 #include "interface_p.h"
 
@@ -25,6 +29,9 @@
 #include <core/dbus/object.h>
 #include <core/dbus/skeleton.h>
 
+#include <dbus/dbus.h>
+
+#include <algorithm>
 #include <functional>
 
 namespace cul = com::ubuntu::location;
@@ -39,12 +46,24 @@ dbus::Message::Ptr the_empty_reply()
 {
     return dbus::Message::Ptr{};
 }
+
+// Makes sure that a session always has statistics to account into.
+culss::Skeleton::Configuration with_statistics(culss::Skeleton::Configuration config)
+{
+    if (not config.local.statistics)
+        config.local.statistics = std::make_shared<culss::Skeleton::Statistics>();
+
+    return config;
+}
 }
 
 culss::Skeleton::Skeleton(const culss::Skeleton::Configuration& config)
         : dbus::Skeleton<Interface>{config.local.bus},
-          configuration(config),
+          configuration(with_statistics(config)),
           object(access_service()->add_object_for_path(configuration.path)),
+          filter(std::make_shared<UpdateFilter>()),
+          tracker(std::make_shared<DeliveryTracker>(configuration.limits, configuration.local.statistics)),
+          held_back(std::make_shared<culs::Timer>()),
           connections
           {
               configuration.local.impl->updates().position.changed().connect(
@@ -61,9 +80,23 @@ culss::Skeleton::Skeleton(const culss::Skeleton::Configuration& config)
                   [this](const cul::Update<cul::Velocity>& velocity)
                   {
                       on_velocity_changed(velocity);
+                  }),
+              configuration.local.impl->updates().position_batch.connect(
+                  [this](const std::vector<cul::Update<cul::Position>>& batch)
+                  {
+                      on_position_batch(batch);
+                  }),
+              configuration.local.impl->updates().filter.changed().connect(
+                  [this](const cul::Criteria::Updates& criteria)
+                  {
+                      filter->configure(criteria);
+                      // Updates held back might be due earlier, or right away.
+                      schedule_held_back_updates();
                   })
           }
 {
+    filter->configure(configuration.local.impl->updates().filter.get());
+
     object->install_method_handler<Interface::StartPositionUpdates>([this](const dbus::Message::Ptr& msg)
     {
         on_start_position_updates(msg);
@@ -93,16 +126,37 @@ culss::Skeleton::Skeleton(const culss::Skeleton::Configuration& config)
     {
         on_stop_heading_updates(msg);
     });
+
+    object->install_method_handler<Interface::StartPositionBatches>([this](const dbus::Message::Ptr& msg)
+    {
+        on_start_position_batches(msg);
+    });
+
+    object->install_method_handler<Interface::StopPositionBatches>([this](const dbus::Message::Ptr& msg)
+    {
+        on_stop_position_batches(msg);
+    });
+
+    object->install_method_handler<Interface::SetUpdateFilter>([this](const dbus::Message::Ptr& msg)
+    {
+        on_set_update_filter(msg);
+    });
 }
 
 culss::Skeleton::~Skeleton() noexcept
 {
+    // A delivery that is already running refers to us, so we wait for it to finish.
+    held_back->stop();
+
     object->uninstall_method_handler<Interface::StartPositionUpdates>();
     object->uninstall_method_handler<Interface::StopPositionUpdates>();
     object->uninstall_method_handler<Interface::StartVelocityUpdates>();
     object->uninstall_method_handler<Interface::StopVelocityUpdates>();
     object->uninstall_method_handler<Interface::StartHeadingUpdates>();
     object->uninstall_method_handler<Interface::StopHeadingUpdates>();
+    object->uninstall_method_handler<Interface::StartPositionBatches>();
+    object->uninstall_method_handler<Interface::StopPositionBatches>();
+    object->uninstall_method_handler<Interface::SetUpdateFilter>();
 }
 
 void culss::Skeleton::on_start_position_updates(const core::dbus::Message::Ptr& msg)
@@ -277,26 +331,242 @@ void culss::Skeleton::on_stop_velocity_updates(const core::dbus::Message::Ptr& m
     }
 }
 
+void culss::Skeleton::on_start_position_batches(const core::dbus::Message::Ptr& msg)
+{
+    VLOG(10) << "MethodHandler for Interface::StartPositionBatches";
+    auto reply = the_empty_reply();
+    try
+    {
+        configuration.local.impl->updates().position_batch_status = culss::Interface::Updates::Status::enabled;
+        reply = dbus::Message::make_method_return(msg);
+    } catch(const std::runtime_error& e)
+    {
+        // We only provide a generic error message to avoid leaking
+        // any sort of private data to unprivileged clients.
+        reply = core::dbus::Message::make_error(
+                    msg,
+                    Interface::Errors::ErrorStartingUpdate::name(),
+                    "Could not enable position batches");
+        SYSLOG(ERROR) << e.what();
+    }
+
+    try
+    {
+        configuration.local.bus->send(reply);
+    } catch(const std::exception& e)
+    {
+        SYSLOG(ERROR) << e.what();
+    }
+}
+
+void culss::Skeleton::on_stop_position_batches(const core::dbus::Message::Ptr& msg)
+{
+    VLOG(10) << "MethodHandler for Interface::StopPositionBatches";
+    auto reply = the_empty_reply();
+    try
+    {
+        configuration.local.impl->updates().position_batch_status = culss::Interface::Updates::Status::disabled;
+        reply = dbus::Message::make_method_return(msg);
+    } catch(const std::runtime_error& e)
+    {
+        // We only provide a generic error message to avoid leaking
+        // any sort of private data to unprivileged clients.
+        reply = core::dbus::Message::make_error(
+                    msg,
+                    Interface::Errors::ErrorStartingUpdate::name(),
+                    "Could not disable position batches");
+        SYSLOG(ERROR) << e.what();
+    }
+
+    try
+    {
+        configuration.local.bus->send(reply);
+    } catch(const std::exception& e)
+    {
+        SYSLOG(ERROR) << e.what();
+    }
+}
+
+void culss::Skeleton::on_set_update_filter(const core::dbus::Message::Ptr& msg)
+{
+    VLOG(10) << "MethodHandler for Interface::SetUpdateFilter";
+    auto reply = the_empty_reply();
+    try
+    {
+        cul::Criteria::Updates criteria; msg->reader() >> criteria;
+        configuration.local.impl->updates().filter = criteria;
+        reply = dbus::Message::make_method_return(msg);
+    } catch(const std::runtime_error& e)
+    {
+        // We only provide a generic error message to avoid leaking
+        // any sort of private data to unprivileged clients.
+        reply = core::dbus::Message::make_error(
+                    msg,
+                    Interface::Errors::ErrorSettingUpdateFilter::name(),
+                    "Could not adjust update filter");
+        SYSLOG(ERROR) << e.what();
+    }
+
+    try
+    {
+        configuration.local.bus->send(reply);
+    } catch(const std::exception& e)
+    {
+        SYSLOG(ERROR) << e.what();
+    }
+}
+
+template<typename Method, typename T>
+void culss::Skeleton::send_update(const cul::Update<T>& update)
+{
+    // Updates delivered via the shared encoder are not tracked, except for
+    // regular probes of the client's responsiveness.
+    auto tracked = not configuration.local.encoder || tracker->is_probe_due();
+
+    dbus::Message::Ptr msg;
+
+    if (configuration.local.encoder)
+    {
+        msg = configuration.local.encoder->message_for(
+                    update,
+                    configuration.remote.name,
+                    configuration.path,
+                    tracked);
+    } else
+    {
+        msg = dbus::Message::make_method_call(
+                    configuration.remote.name,
+                    configuration.path,
+                    dbus::traits::Service<Interface>::interface_name(),
+                    Method::name());
+        msg->writer() << update;
+    }
+
+    deliver<Method>(msg, tracked);
+}
+
+template<typename Method, typename T>
+void culss::Skeleton::send_batch(const std::vector<cul::Update<T>>& batch)
+{
+    // Batches are specific to a session as the update filter applies to the
+    // individual samples, thus we do not route them via the shared encoder.
+    auto tracked = not configuration.local.encoder || tracker->is_probe_due();
+
+    auto msg = dbus::Message::make_method_call(
+                configuration.remote.name,
+                configuration.path,
+                dbus::traits::Service<Interface>::interface_name(),
+                Method::name());
+    msg->writer() << batch;
+
+    if (not tracked)
+        dbus_message_set_no_reply(msg->get(), true);
+
+    deliver<Method>(msg, tracked);
+}
+
+template<typename Method>
+void culss::Skeleton::deliver(const dbus::Message::Ptr& msg, bool tracked)
+{
+    if (not tracked)
+    {
+        configuration.remote.bus->send(msg);
+        return;
+    }
+
+    auto call = configuration.remote.bus->send_with_reply_and_timeout(msg, Method::default_timeout());
+    auto id = tracker->sent([call]() { call->cancel(); });
+
+    std::weak_ptr<DeliveryTracker> wt{tracker};
+    auto on_session_died = configuration.local.on_session_died;
+
+    call->then([wt, id, on_session_died](const dbus::Message::Ptr& reply)
+    {
+        auto tracker = wt.lock();
+        if (not tracker)
+            return;
+
+        auto succeeded = reply->type() != dbus::Message::Type::error;
+        if (not succeeded)
+            VLOG(10) << "Failed to communicate " << Method::name() << " to client: " << reply->error().print();
+
+        switch (tracker->completed(id, succeeded))
+        {
+        case DeliveryTracker::Verdict::keep:
+            break;
+        case DeliveryTracker::Verdict::evict_for_failures:
+            LOG(WARNING) << "Evicting session as the client failed to reply to updates.";
+            if (on_session_died) on_session_died();
+            break;
+        case DeliveryTracker::Verdict::evict_for_latency:
+            LOG(WARNING) << "Evicting session as the client takes too long to reply to updates.";
+            if (on_session_died) on_session_died();
+            break;
+        }
+    });
+}
+
 // Invoked whenever the actual session impl. for the session reports a position update.
 void culss::Skeleton::on_position_changed(const cul::Update<cul::Position>& position)
 {
     VLOG(10) << __PRETTY_FUNCTION__;
+
+    if (not filter->accept(position))
+    {
+        VLOG(20) << "Holding back position update as requested by the client's update filter.";
+        schedule_held_back_updates();
+        return;
+    }
+
     try
     {
-        configuration.remote.object->invoke_method_asynchronously_with_callback<culs::session::Interface::UpdatePosition, void>([](const core::dbus::Result<void>& result)
-        {
-            if (result.is_error())
-            {
-                VLOG(10) << "Failed to communicate position update to client: " << result.error().print();
-            }
-        }, position);
-    } catch(const std::exception&)
-    {
-        // We consider the session to be dead once we hit an exception here.
-        // We thus remove it from the central and end its lifetime.
-        // on_session_died();
-    } catch(...)
+        send_update<culs::session::Interface::UpdatePosition>(position);
+    } catch(const std::exception& e)
     {
+        // We do not tear down the session from within the update emission.
+        // The failure is accounted for, and a client that stopped responding is
+        // evicted once its tracked updates fail or time out.
+        configuration.local.statistics->failed_updates++;
+        VLOG(10) << "Failed to communicate position update to client: " << e.what();
+    }
+}
+
+// Invoked whenever the actual session impl. reports a batch of position updates.
+void culss::Skeleton::on_position_batch(const std::vector<cul::Update<cul::Position>>& batch)
+{
+    VLOG(10) << __PRETTY_FUNCTION__;
+
+    std::vector<cul::Update<cul::Position>> accepted;
+    accepted.reserve(batch.size());
+
+    for (const auto& position : batch)
+        if (filter->accept(position))
+            accepted.push_back(position);
+
+    if (accepted.size() < batch.size())
+        schedule_held_back_updates();
+
+    if (accepted.empty())
+    {
+        VLOG(20) << "Dropping position batch as requested by the client's update filter.";
+        return;
+    }
+
+    try
+    {
+        // Clients that did not opt in to batches only understand individual updates.
+        if (configuration.local.impl->updates().position_batch_status.get() == culss::Interface::Updates::Status::enabled)
+            send_batch<culs::session::Interface::UpdatePositionBatch>(accepted);
+        else
+            for (const auto& position : accepted)
+                send_update<culs::session::Interface::UpdatePosition>(position);
+    } catch(const std::exception& e)
+    {
+        // We do not tear down the session from within the update emission.
+        // The failure is accounted for, and a client that stopped responding is
+        // evicted once its tracked updates fail or time out.
+        configuration.local.statistics->failed_updates++;
+        VLOG(10) << "Failed to communicate position batch to client: " << e.what();
     }
 }
 
@@ -304,22 +574,24 @@ void culss::Skeleton::on_position_changed(const cul::Update<cul::Position>& posi
 void culss::Skeleton::on_heading_changed(const cul::Update<cul::Heading>& heading)
 {
     VLOG(10) << __PRETTY_FUNCTION__;
+
+    if (not filter->accept(heading))
+    {
+        VLOG(20) << "Holding back heading update as requested by the client's update filter.";
+        schedule_held_back_updates();
+        return;
+    }
+
     try
     {
-        configuration.remote.object->invoke_method_asynchronously_with_callback<culs::session::Interface::UpdateHeading, void>([](const core::dbus::Result<void>& result)
-        {
-            if (result.is_error())
-            {
-                VLOG(10) << "Failed to communicate heading update to client: " << result.error().print();
-            }
-        }, heading);
-    } catch(const std::exception&)
-    {
-        // We consider the session to be dead once we hit an exception here.
-        // We thus remove it from the central and end its lifetime.
-        //on_session_died();
-    } catch(...)
+        send_update<culs::session::Interface::UpdateHeading>(heading);
+    } catch(const std::exception& e)
     {
+        // We do not tear down the session from within the update emission.
+        // The failure is accounted for, and a client that stopped responding is
+        // evicted once its tracked updates fail or time out.
+        configuration.local.statistics->failed_updates++;
+        VLOG(10) << "Failed to communicate heading update to client: " << e.what();
     }
 }
 
@@ -327,22 +599,61 @@ void culss::Skeleton::on_heading_changed(const cul::Update<cul::Heading>& headin
 void culss::Skeleton::on_velocity_changed(const cul::Update<cul::Velocity>& velocity)
 {
     VLOG(10) << __PRETTY_FUNCTION__;
+
+    if (not filter->accept(velocity))
+    {
+        VLOG(20) << "Holding back velocity update as requested by the client's update filter.";
+        schedule_held_back_updates();
+        return;
+    }
+
     try
     {
-        configuration.remote.object->invoke_method_asynchronously_with_callback<culs::session::Interface::UpdateVelocity, void>([](const core::dbus::Result<void>& result)
-        {
-            if (result.is_error())
-            {
-                VLOG(10) << "Failed to communicate velocity update to client: " << result.error().print();
-            }
-        }, velocity);
-    } catch(const std::exception&)
-    {
-        // We consider the session to be dead once we hit an exception here.
-        // We thus remove it from the central and end its lifetime.
-        // on_session_died();
-    } catch(...)
+        send_update<culs::session::Interface::UpdateVelocity>(velocity);
+    } catch(const std::exception& e)
+    {
+        // We do not tear down the session from within the update emission.
+        // The failure is accounted for, and a client that stopped responding is
+        // evicted once its tracked updates fail or time out.
+        configuration.local.statistics->failed_updates++;
+        VLOG(10) << "Failed to communicate velocity update to client: " << e.what();
+    }
+}
+
+void culss::Skeleton::schedule_held_back_updates()
+{
+    auto due = filter->next_flush();
+
+    if (not due)
+        return;
+
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(*due - cul::Clock::now());
+
+    // Rescheduling replaces a pending delivery, such that there is at most one.
+    held_back->schedule(std::max(std::chrono::milliseconds{0}, delay), [this]()
+    {
+        deliver_held_back_updates();
+        // Updates that were not quite due yet are picked up by the next round.
+        schedule_held_back_updates();
+    });
+}
+
+void culss::Skeleton::deliver_held_back_updates()
+{
+    auto pending = filter->flush();
+
+    try
+    {
+        if (pending.position)
+            send_update<culs::session::Interface::UpdatePosition>(*pending.position);
+        if (pending.heading)
+            send_update<culs::session::Interface::UpdateHeading>(*pending.heading);
+        if (pending.velocity)
+            send_update<culs::session::Interface::UpdateVelocity>(*pending.velocity);
+    } catch(const std::exception& e)
     {
+        configuration.local.statistics->failed_updates++;
+        VLOG(10) << "Failed to communicate held back update to client: " << e.what();
     }
 }
 
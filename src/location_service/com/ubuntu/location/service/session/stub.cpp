@@ -24,6 +24,8 @@
 
 #include <core/dbus/stub.h>
 
+#include <dbus/dbus.h>
+
 #include <functional>
 
 namespace cul = com::ubuntu::location;
@@ -32,6 +34,15 @@ namespace culss = com::ubuntu::location::service::session;
 
 namespace dbus = core::dbus;
 
+namespace
+{
+// Updates delivered via the service's shared encoder do not expect a reply.
+bool expects_reply(const dbus::Message::Ptr& msg)
+{
+    return not dbus_message_get_no_reply(msg->get());
+}
+}
+
 struct culss::Stub::Private
 {
     Private(Stub* parent,
@@ -39,19 +50,27 @@ struct culss::Stub::Private
             const dbus::Object::Ptr& object,
             const core::Connection& position,
             const core::Connection& velocity,
-            const core::Connection& heading)
+            const core::Connection& heading,
+            const core::Connection& filter,
+            const core::Connection& position_batch_status)
         : parent(parent),
           session_path(path),
           object(object),
           position(position),
           velocity(velocity),
-          heading(heading)
+          heading(heading),
+          filter(filter),
+          position_batch_status(position_batch_status)
     {
     }
 
+    void set_update_filter(const Criteria::Updates& criteria);
+    void set_position_batch_status(const Interface::Updates::Status& status);
+
     void update_heading(const dbus::Message::Ptr& msg);
     void update_position(const dbus::Message::Ptr& msg);
     void update_velocity(const dbus::Message::Ptr& msg);
+    void update_position_batch(const dbus::Message::Ptr& msg);
 
     Stub* parent;
     dbus::types::ObjectPath session_path;
@@ -59,7 +78,8 @@ struct culss::Stub::Private
     core::ScopedConnection position;
     core::ScopedConnection velocity;
     core::ScopedConnection heading;
-
+    core::ScopedConnection filter;
+    core::ScopedConnection position_batch_status;
 };
 
 culss::Stub::Stub(const dbus::Bus::Ptr& bus,
@@ -91,6 +111,14 @@ culss::Stub::Stub(const dbus::Bus::Ptr& bus,
                           case Interface::Updates::Status::enabled: start_heading_updates(); break;
                           case Interface::Updates::Status::disabled: stop_heading_updates(); break;
                           }
+                      }),
+                      updates().filter.changed().connect([this](const Criteria::Updates& criteria)
+                      {
+                          d->set_update_filter(criteria);
+                      }),
+                      updates().position_batch_status.changed().connect([this](const Interface::Updates::Status& status)
+                      {
+                          d->set_position_batch_status(status);
                       })
                       ))
 {
@@ -106,6 +134,10 @@ culss::Stub::Stub(const dbus::Bus::Ptr& bus,
         std::bind(&Stub::Private::update_velocity,
                   std::ref(d),
                   std::placeholders::_1));
+    d->object->install_method_handler<culss::Interface::UpdatePositionBatch>(
+        std::bind(&Stub::Private::update_position_batch,
+                  std::ref(d),
+                  std::placeholders::_1));
 }
 
 culss::Stub::~Stub() noexcept
@@ -119,6 +151,7 @@ culss::Stub::~Stub() noexcept
     d->object->uninstall_method_handler<culss::Interface::UpdatePosition>();
     d->object->uninstall_method_handler<culss::Interface::UpdateHeading>();
     d->object->uninstall_method_handler<culss::Interface::UpdateVelocity>();
+    d->object->uninstall_method_handler<culss::Interface::UpdatePositionBatch>();
 }
 
 const dbus::types::ObjectPath& culss::Stub::path() const
@@ -220,6 +253,34 @@ void culss::Stub::stop_heading_updates() noexcept
     }
 }
 
+void culss::Stub::Private::set_update_filter(const cul::Criteria::Updates& criteria)
+{
+    VLOG(10) << __PRETTY_FUNCTION__;
+
+    auto result = object->transact_method<Interface::SetUpdateFilter, void>(criteria);
+
+    if (result.is_error())
+    {
+        std::stringstream ss; ss << __PRETTY_FUNCTION__ << ": " << result.error().print();
+        throw std::runtime_error(ss.str());
+    }
+}
+
+void culss::Stub::Private::set_position_batch_status(const Interface::Updates::Status& status)
+{
+    VLOG(10) << __PRETTY_FUNCTION__;
+
+    auto result = status == Interface::Updates::Status::enabled ?
+                object->transact_method<Interface::StartPositionBatches, void>() :
+                object->transact_method<Interface::StopPositionBatches, void>();
+
+    if (result.is_error())
+    {
+        std::stringstream ss; ss << __PRETTY_FUNCTION__ << ": " << result.error().print();
+        throw std::runtime_error(ss.str());
+    }
+}
+
 void culss::Stub::Private::update_heading(const dbus::Message::Ptr& incoming)
 {
     VLOG(10) << __PRETTY_FUNCTION__;
@@ -228,14 +289,18 @@ void culss::Stub::Private::update_heading(const dbus::Message::Ptr& incoming)
     {
         Update<Heading> update; incoming->reader() >> update;
         parent->updates().heading = update;
-        parent->access_bus()->send(dbus::Message::make_method_return(incoming));
+        if (expects_reply(incoming))
+            parent->access_bus()->send(dbus::Message::make_method_return(incoming));
     } catch(const std::runtime_error& e)
     {
-        parent->access_bus()->send(
-                    dbus::Message::make_error(
-                        incoming,
-                        Interface::Errors::ErrorParsingUpdate::name(),
-                        e.what()));
+        VLOG(10) << "Failed to parse update: " << e.what();
+
+        if (expects_reply(incoming))
+            parent->access_bus()->send(
+                        dbus::Message::make_error(
+                            incoming,
+                            Interface::Errors::ErrorParsingUpdate::name(),
+                            e.what()));
     }
 }
 
@@ -247,14 +312,18 @@ void culss::Stub::Private::update_position(const dbus::Message::Ptr& incoming)
     {
         Update<Position> update; incoming->reader() >> update;
         parent->updates().position = update;
-        parent->access_bus()->send(dbus::Message::make_method_return(incoming));
+        if (expects_reply(incoming))
+            parent->access_bus()->send(dbus::Message::make_method_return(incoming));
     } catch(const std::runtime_error& e)
     {
-        parent->access_bus()->send(
-                    dbus::Message::make_error(
-                        incoming,
-                        Interface::Errors::ErrorParsingUpdate::name(),
-                        e.what()));
+        VLOG(10) << "Failed to parse update: " << e.what();
+
+        if (expects_reply(incoming))
+            parent->access_bus()->send(
+                        dbus::Message::make_error(
+                            incoming,
+                            Interface::Errors::ErrorParsingUpdate::name(),
+                            e.what()));
     }
 }
 
@@ -266,13 +335,45 @@ void culss::Stub::Private::update_velocity(const dbus::Message::Ptr& incoming)
     {
         Update<Velocity> update; incoming->reader() >> update;
         parent->updates().velocity = update;
-        parent->access_bus()->send(dbus::Message::make_method_return(incoming));
+        if (expects_reply(incoming))
+            parent->access_bus()->send(dbus::Message::make_method_return(incoming));
+    } catch(const std::runtime_error& e)
+    {
+        VLOG(10) << "Failed to parse update: " << e.what();
+
+        if (expects_reply(incoming))
+            parent->access_bus()->send(
+                        dbus::Message::make_error(
+                            incoming,
+                            Interface::Errors::ErrorParsingUpdate::name(),
+                            e.what()));
+    }
+}
+
+void culss::Stub::Private::update_position_batch(const dbus::Message::Ptr& incoming)
+{
+    VLOG(10) << __PRETTY_FUNCTION__;
+
+    try
+    {
+        std::vector<Update<Position>> batch; incoming->reader() >> batch;
+        if (not batch.empty())
+        {
+            parent->updates().position_batch(batch);
+            // Clients only observing position see the most recent sample.
+            parent->updates().position = batch.back();
+        }
+        if (expects_reply(incoming))
+            parent->access_bus()->send(dbus::Message::make_method_return(incoming));
     } catch(const std::runtime_error& e)
     {
-        parent->access_bus()->send(
-                    dbus::Message::make_error(
-                        incoming,
-                        Interface::Errors::ErrorParsingUpdate::name(),
-                        e.what()));
+        VLOG(10) << "Failed to parse update: " << e.what();
+
+        if (expects_reply(incoming))
+            parent->access_bus()->send(
+                        dbus::Message::make_error(
+                            incoming,
+                            Interface::Errors::ErrorParsingUpdate::name(),
+                            e.what()));
     }
 }
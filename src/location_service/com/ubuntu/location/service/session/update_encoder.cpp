@@ -0,0 +1,95 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <com/ubuntu/location/service/session/update_encoder.h>
+
+#include "interface_p.h"
+
+#include <dbus/dbus.h>
+
+namespace culss = com::ubuntu::location::service::session;
+
+namespace dbus = core::dbus;
+
+template<typename Method, typename T>
+dbus::Message::Ptr culss::UpdateEncoder::message_for(
+        culss::UpdateEncoder::Cache<T>& cache,
+        const Update<T>& update,
+        const std::string& destination,
+        const dbus::types::ObjectPath& path,
+        bool expects_reply)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (not cache.update || *cache.update != update)
+    {
+        auto prototype = dbus::Message::make_method_call(
+                    destination,
+                    path,
+                    dbus::traits::Service<Interface>::interface_name(),
+                    Method::name());
+        prototype->writer() << update;
+
+        cache.update = update;
+        cache.prototype = prototype;
+        stats.encoded++;
+    } else
+    {
+        stats.reused++;
+    }
+
+    // dbus_message_copy duplicates the already marshalled body without
+    // going through the codecs again. The copy is unlocked and can thus be
+    // readdressed to the session it is meant for.
+    auto msg = cache.prototype->clone();
+    dbus_message_set_destination(msg->get(), destination.c_str());
+    dbus_message_set_path(msg->get(), path.as_string().c_str());
+    dbus_message_set_no_reply(msg->get(), not expects_reply);
+
+    return msg;
+}
+
+dbus::Message::Ptr culss::UpdateEncoder::message_for(
+        const Update<Position>& update,
+        const std::string& destination,
+        const dbus::types::ObjectPath& path,
+        bool expects_reply)
+{
+    return message_for<Interface::UpdatePosition>(position, update, destination, path, expects_reply);
+}
+
+dbus::Message::Ptr culss::UpdateEncoder::message_for(
+        const Update<Heading>& update,
+        const std::string& destination,
+        const dbus::types::ObjectPath& path,
+        bool expects_reply)
+{
+    return message_for<Interface::UpdateHeading>(heading, update, destination, path, expects_reply);
+}
+
+dbus::Message::Ptr culss::UpdateEncoder::message_for(
+        const Update<Velocity>& update,
+        const std::string& destination,
+        const dbus::types::ObjectPath& path,
+        bool expects_reply)
+{
+    return message_for<Interface::UpdateVelocity>(velocity, update, destination, path, expects_reply);
+}
+
+culss::UpdateEncoder::Statistics culss::UpdateEncoder::statistics() const
+{
+    std::lock_guard<std::mutex> lg(guard);
+    return stats;
+}
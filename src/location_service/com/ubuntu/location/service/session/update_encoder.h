@@ -0,0 +1,119 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_SESSION_UPDATE_ENCODER_H_
+#define LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_SESSION_UPDATE_ENCODER_H_
+
+#include <com/ubuntu/location/heading.h>
+#include <com/ubuntu/location/optional.h>
+#include <com/ubuntu/location/position.h>
+#include <com/ubuntu/location/update.h>
+#include <com/ubuntu/location/velocity.h>
+
+#include <core/dbus/message.h>
+#include <core/dbus/types/object_path.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace com
+{
+namespace ubuntu
+{
+namespace location
+{
+namespace service
+{
+namespace session
+{
+// UpdateEncoder is shared by all sessions of a service instance and makes sure
+// that an update fanned out to n sessions is only serialized once. The encoded
+// payload is kept in a prototype message that is copied and readdressed for every
+// session. By default, the resulting messages do not expect a reply, saving the
+// bookkeeping of n pending calls per update.
+class UpdateEncoder
+{
+public:
+    typedef std::shared_ptr<UpdateEncoder> Ptr;
+
+    // Summarizes the work done by an UpdateEncoder instance.
+    struct Statistics
+    {
+        // Number of updates that have been serialized.
+        std::uint64_t encoded;
+        // Number of messages that reused an already serialized update.
+        std::uint64_t reused;
+    };
+
+    UpdateEncoder() = default;
+    UpdateEncoder(const UpdateEncoder&) = delete;
+    UpdateEncoder& operator=(const UpdateEncoder&) = delete;
+
+    // Returns a message carrying update to the session object at path, owned by destination.
+    // The message only asks for a reply if expects_reply is true.
+    core::dbus::Message::Ptr message_for(
+            const Update<Position>& update,
+            const std::string& destination,
+            const core::dbus::types::ObjectPath& path,
+            bool expects_reply = false);
+    core::dbus::Message::Ptr message_for(
+            const Update<Heading>& update,
+            const std::string& destination,
+            const core::dbus::types::ObjectPath& path,
+            bool expects_reply = false);
+    core::dbus::Message::Ptr message_for(
+            const Update<Velocity>& update,
+            const std::string& destination,
+            const core::dbus::types::ObjectPath& path,
+            bool expects_reply = false);
+
+    // Returns a snapshot of the statistics of this instance.
+    Statistics statistics() const;
+
+private:
+    // The most recently encoded update of type T, together with its prototype message.
+    template<typename T>
+    struct Cache
+    {
+        Optional<Update<T>> update;
+        core::dbus::Message::Ptr prototype;
+    };
+
+    // Hands out a readdressed copy of the prototype in cache, encoding update
+    // as Method invocation if it differs from the cached one.
+    template<typename Method, typename T>
+    core::dbus::Message::Ptr message_for(
+            Cache<T>& cache,
+            const Update<T>& update,
+            const std::string& destination,
+            const core::dbus::types::ObjectPath& path,
+            bool expects_reply);
+
+    // Updates are delivered from different threads.
+    mutable std::mutex guard;
+    Cache<Position> position;
+    Cache<Heading> heading;
+    Cache<Velocity> velocity;
+    Statistics stats{0, 0};
+};
+}
+}
+}
+}
+}
+
+#endif // LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_SESSION_UPDATE_ENCODER_H_
@@ -0,0 +1,158 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <com/ubuntu/location/service/session/update_filter.h>
+
+namespace cul = com::ubuntu::location;
+namespace culss = com::ubuntu::location::service::session;
+
+void culss::UpdateFilter::configure(const cul::Criteria::Updates& c)
+{
+    std::lock_guard<std::mutex> lg(guard);
+    criteria = c;
+}
+
+bool culss::UpdateFilter::accept(const cul::Update<cul::Position>& update, const cul::Clock::Timestamp& now)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    // The latest update supersedes the one held back. The displacement is
+    // checked once the update is due.
+    if (not has_interval_elapsed(last_delivered.position_time, now))
+    {
+        pending.position = update;
+        return false;
+    }
+
+    pending.position.reset();
+
+    if (criteria.displacement && last_delivered.position)
+    {
+        if (cul::haversine_distance(last_delivered.position->value, update.value) < *criteria.displacement)
+            return false;
+    }
+
+    last_delivered.position = update;
+    last_delivered.position_time = now;
+
+    return true;
+}
+
+bool culss::UpdateFilter::accept(const cul::Update<cul::Heading>& update, const cul::Clock::Timestamp& now)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (not has_interval_elapsed(last_delivered.heading_time, now))
+    {
+        pending.heading = update;
+        return false;
+    }
+
+    pending.heading.reset();
+    last_delivered.heading_time = now;
+    return true;
+}
+
+bool culss::UpdateFilter::accept(const cul::Update<cul::Velocity>& update, const cul::Clock::Timestamp& now)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (not has_interval_elapsed(last_delivered.velocity_time, now))
+    {
+        pending.velocity = update;
+        return false;
+    }
+
+    pending.velocity.reset();
+    last_delivered.velocity_time = now;
+    return true;
+}
+
+cul::Optional<cul::Clock::Timestamp> culss::UpdateFilter::next_flush()
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    cul::Optional<cul::Clock::Timestamp> result;
+
+    auto consider = [&result](const cul::Clock::Timestamp& when)
+    {
+        if (not result || when < *result)
+            result = when;
+    };
+
+    if (pending.position)
+        consider(due(last_delivered.position_time));
+    if (pending.heading)
+        consider(due(last_delivered.heading_time));
+    if (pending.velocity)
+        consider(due(last_delivered.velocity_time));
+
+    return result;
+}
+
+culss::UpdateFilter::Pending culss::UpdateFilter::flush(const cul::Clock::Timestamp& now)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    Pending result;
+
+    if (pending.position && has_interval_elapsed(last_delivered.position_time, now))
+    {
+        auto update = *pending.position;
+        pending.position.reset();
+
+        bool displaced = not criteria.displacement || not last_delivered.position ||
+                cul::haversine_distance(last_delivered.position->value, update.value) >= *criteria.displacement;
+
+        if (displaced)
+        {
+            last_delivered.position = update;
+            last_delivered.position_time = now;
+            result.position = update;
+        }
+    }
+
+    if (pending.heading && has_interval_elapsed(last_delivered.heading_time, now))
+    {
+        result.heading = pending.heading;
+        pending.heading.reset();
+        last_delivered.heading_time = now;
+    }
+
+    if (pending.velocity && has_interval_elapsed(last_delivered.velocity_time, now))
+    {
+        result.velocity = pending.velocity;
+        pending.velocity.reset();
+        last_delivered.velocity_time = now;
+    }
+
+    return result;
+}
+
+bool culss::UpdateFilter::has_interval_elapsed(const cul::Optional<cul::Clock::Timestamp>& last, const cul::Clock::Timestamp& now) const
+{
+    if (not criteria.interval || not last)
+        return true;
+
+    return now - *last >= *criteria.interval;
+}
+
+cul::Clock::Timestamp culss::UpdateFilter::due(const cul::Optional<cul::Clock::Timestamp>& last) const
+{
+    if (not criteria.interval || not last)
+        return cul::Clock::beginning_of_time();
+
+    return *last + *criteria.interval;
+}
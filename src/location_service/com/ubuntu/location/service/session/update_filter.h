@@ -0,0 +1,102 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_SESSION_UPDATE_FILTER_H_
+#define LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_SESSION_UPDATE_FILTER_H_
+
+#include <com/ubuntu/location/clock.h>
+#include <com/ubuntu/location/criteria.h>
+#include <com/ubuntu/location/heading.h>
+#include <com/ubuntu/location/optional.h>
+#include <com/ubuntu/location/position.h>
+#include <com/ubuntu/location/update.h>
+#include <com/ubuntu/location/velocity.h>
+
+#include <mutex>
+
+namespace com
+{
+namespace ubuntu
+{
+namespace location
+{
+namespace service
+{
+namespace session
+{
+// UpdateFilter decides whether an update should be delivered to a session,
+// honoring the minimum update interval and the minimum displacement the session
+// asked for. Updates arriving within the interval are held back, and the latest
+// one is handed out by flush once the interval has elapsed. A session thus
+// always ends up with the most recent fix, even if no further update arrives.
+class UpdateFilter
+{
+public:
+    // Updates held back by the filter, one per kind at most.
+    struct Pending
+    {
+        Optional<Update<Position>> position;
+        Optional<Update<Heading>> heading;
+        Optional<Update<Velocity>> velocity;
+    };
+
+    // Sets up a filter that lets all updates pass.
+    UpdateFilter() = default;
+    UpdateFilter(const UpdateFilter&) = delete;
+    UpdateFilter& operator=(const UpdateFilter&) = delete;
+
+    // configure adjusts the filter to the given interval and displacement.
+    void configure(const Criteria::Updates& criteria);
+
+    // accept returns true iff the given update should be delivered at time now,
+    // recording it as the last delivered update in that case. Updates arriving
+    // within the interval replace the update held back for their kind.
+    bool accept(const Update<Position>& update, const Clock::Timestamp& now = Clock::now());
+    bool accept(const Update<Heading>& update, const Clock::Timestamp& now = Clock::now());
+    bool accept(const Update<Velocity>& update, const Clock::Timestamp& now = Clock::now());
+
+    // next_flush returns the point in time when the first update held back
+    // becomes due, or an empty Optional if no update is held back.
+    Optional<Clock::Timestamp> next_flush();
+
+    // flush returns all updates held back that are due at time now, recording
+    // them as the last delivered updates.
+    Pending flush(const Clock::Timestamp& now = Clock::now());
+
+private:
+    // Returns true iff the configured interval has elapsed since last at now.
+    bool has_interval_elapsed(const Optional<Clock::Timestamp>& last, const Clock::Timestamp& now) const;
+    // Returns the point in time when the interval started at last elapses.
+    Clock::Timestamp due(const Optional<Clock::Timestamp>& last) const;
+
+    // Updates are delivered from different threads.
+    std::mutex guard;
+    Criteria::Updates criteria;
+    struct
+    {
+        Optional<Update<Position>> position;
+        Optional<Clock::Timestamp> position_time;
+        Optional<Clock::Timestamp> heading_time;
+        Optional<Clock::Timestamp> velocity_time;
+    } last_delivered;
+    Pending pending;
+};
+}
+}
+}
+}
+}
+
+#endif // LOCATION_SERVICE_COM_UBUNTU_LOCATION_SERVICE_SESSION_UPDATE_FILTER_H_
@@ -16,11 +16,21 @@
  * Authored by: Thomas Voß <thomas.voss@canonical.com>
  */
 #include <com/ubuntu/location/service/skeleton.h>
+#include <com/ubuntu/location/service/runtime.h>
 #include <com/ubuntu/location/service/session/skeleton.h>
+#include <com/ubuntu/location/service/session/update_encoder.h>
 
 #include <com/ubuntu/location/logging.h>
 
+#include <core/dbus/service.h>
+#include <core/dbus/traits/service.h>
 #include <core/dbus/types/object_path.h>
+#include <core/dbus/types/variant.h>
+#include <core/dbus/types/stl/map.h>
+#include <core/dbus/types/stl/string.h>
+
+#include <algorithm>
+#include <future>
 
 namespace cul = com::ubuntu::location;
 namespace culs = com::ubuntu::location::service;
@@ -28,6 +38,75 @@ namespace culss = com::ubuntu::location::service::session;
 
 namespace dbus = core::dbus;
 
+namespace
+{
+// The part of org.freedesktop.DBus that is not covered by core::dbus::DBus.
+struct BusDaemon
+{
+    static const std::string& name()
+    {
+        static const std::string s{"org.freedesktop.DBus"};
+        return s;
+    }
+
+    static const dbus::types::ObjectPath& path()
+    {
+        static const dbus::types::ObjectPath p{"/org/freedesktop/DBus"};
+        return p;
+    }
+
+    // Resolves a bus name to all credentials known to the dbus daemon in one go.
+    struct GetConnectionCredentials
+    {
+        typedef BusDaemon Interface;
+
+        inline static const std::string& name()
+        {
+            static const std::string s{"GetConnectionCredentials"};
+            return s;
+        }
+
+        typedef std::map<std::string, dbus::types::Variant> ResultType;
+
+        inline static const std::chrono::milliseconds default_timeout()
+        {
+            return std::chrono::seconds{1};
+        }
+    };
+};
+}
+
+// Announces changes to the owner of a bus name as (name, old owner, new owner).
+// The new owner is empty if the name vanished from the bus.
+struct culs::Skeleton::DBusDaemonCredentialsResolver::NameOwnerChanged
+{
+    inline static std::string name()
+    {
+        return "NameOwnerChanged";
+    }
+
+    typedef BusDaemon Interface;
+    typedef std::tuple<std::string, std::string, std::string> ArgumentType;
+};
+
+namespace core
+{
+namespace dbus
+{
+namespace traits
+{
+template<>
+struct Service<BusDaemon>
+{
+    inline static const std::string& interface_name()
+    {
+        return BusDaemon::name();
+    }
+};
+}
+}
+}
+
 namespace
 {
 const std::vector<std::string>& the_empty_array_of_invalidated_properties()
@@ -39,20 +118,185 @@ dbus::Message::Ptr the_empty_reply()
 {
     return dbus::Message::Ptr{};
 }
+
+// Changes to the visible space vehicles arriving faster than this are
+// coalesced into the next announcement.
+constexpr std::chrono::milliseconds minimum_space_vehicle_announcement_interval{1000};
+// Permission checks missing the cache are executed by at most this many workers.
+constexpr std::size_t maximum_permission_check_workers{4};
+
+// Collects the space vehicles in svs that are new or changed compared to announced,
+// and the keys of the space vehicles in announced that are gone in svs.
+void diff_space_vehicles(
+        const std::map<cul::SpaceVehicle::Key, cul::SpaceVehicle>& announced,
+        const std::map<cul::SpaceVehicle::Key, cul::SpaceVehicle>& svs,
+        std::map<cul::SpaceVehicle::Key, cul::SpaceVehicle>& updated,
+        std::vector<cul::SpaceVehicle::Key>& removed)
+{
+    for (const auto& sv : svs)
+    {
+        auto it = announced.find(sv.first);
+        if (it == announced.end() || not (it->second == sv.second))
+            updated.insert(sv);
+    }
+
+    for (const auto& sv : announced)
+        if (svs.count(sv.first) == 0)
+            removed.push_back(sv.first);
+}
+
+// Returns true if the horizontal accuracy of the update is known and within accuracy.
+bool is_accurate_enough(const cul::Update<cul::Position>& update, const cul::units::Quantity<cul::units::Length>& accuracy)
+{
+    return update.value.accuracy.horizontal && *update.value.accuracy.horizontal <= accuracy;
+}
+
+// Returns true if update should replace best as the best fix seen so far. Fixes with
+// unknown accuracy lose against fixes of known accuracy, newer fixes win ties.
+bool is_better_fix(const cul::Update<cul::Position>& update, const cul::Optional<cul::Update<cul::Position>>& best)
+{
+    if (not best)
+        return true;
+
+    const auto& lhs = update.value.accuracy.horizontal;
+    const auto& rhs = best->value.accuracy.horizontal;
+
+    if (lhs && rhs)
+        return *lhs <= *rhs;
+
+    return lhs || not rhs;
+}
 }
 
 culs::Skeleton::DBusDaemonCredentialsResolver::DBusDaemonCredentialsResolver(const dbus::Bus::Ptr& bus)
-    : daemon(bus)
+    : bus(bus),
+      daemon(bus),
+      object(dbus::Service::use_service(bus, BusDaemon::name())->object_for_path(BusDaemon::path())),
+      name_owner_changed(object->get_signal<NameOwnerChanged>())
 {
+    // Unique names are never reused, an entry is stale once its name loses its owner.
+    name_owner_changed_token = name_owner_changed->connect([this](const NameOwnerChanged::ArgumentType& args)
+    {
+        if (not std::get<2>(args).empty())
+            return;
+
+        std::lock_guard<std::mutex> lg(guard);
+        cache.erase(std::get<0>(args));
+    });
+}
+
+culs::Skeleton::DBusDaemonCredentialsResolver::~DBusDaemonCredentialsResolver()
+{
+    name_owner_changed->disconnect(name_owner_changed_token);
 }
 
 culs::Credentials
 culs::Skeleton::DBusDaemonCredentialsResolver::resolve_credentials_for_incoming_message(const dbus::Message::Ptr& msg)
 {
+    auto sender = msg->sender();
+
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        auto it = cache.find(sender);
+        if (it != cache.end() && not it->second.pending)
+        {
+            stats.hits++;
+            return it->second.credentials;
+        }
+    }
+
+    stats.misses++;
+
+    // The pending entry is in place before we talk to the dbus daemon. If the peer
+    // leaves from here on, NameOwnerChanged evicts the entry and we do not cache.
+    // If it left before, the dbus daemon fails to resolve its credentials.
+    auto generation = reserve_cache_entry_for_name(sender);
+
+    try
+    {
+        auto credentials = resolve_credentials_for_name(sender);
+        cache_credentials_for_name(sender, generation, credentials);
+        return credentials;
+    } catch(...)
+    {
+        release_cache_entry_for_name(sender, generation);
+        throw;
+    }
+}
+
+std::uint64_t culs::Skeleton::DBusDaemonCredentialsResolver::reserve_cache_entry_for_name(const std::string& name)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    cache[name] = CacheEntry{++last_generation, true, Credentials{}};
+    return last_generation;
+}
+
+bool culs::Skeleton::DBusDaemonCredentialsResolver::cache_credentials_for_name(
+        const std::string& name,
+        std::uint64_t generation,
+        const culs::Credentials& credentials)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto it = cache.find(name);
+    if (it == cache.end() || it->second.generation != generation)
+        return false;
+
+    it->second.pending = false;
+    it->second.credentials = credentials;
+
+    return true;
+}
+
+void culs::Skeleton::DBusDaemonCredentialsResolver::release_cache_entry_for_name(const std::string& name, std::uint64_t generation)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto it = cache.find(name);
+    if (it != cache.end() && it->second.generation == generation)
+        cache.erase(it);
+}
+
+bool culs::Skeleton::DBusDaemonCredentialsResolver::has_cached_credentials_for_name(const std::string& name)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto it = cache.find(name);
+    return it != cache.end() && not it->second.pending;
+}
+
+culs::Credentials
+culs::Skeleton::DBusDaemonCredentialsResolver::resolve_credentials_for_name(const std::string& name)
+{
+    auto op = object->transact_method<
+            BusDaemon::GetConnectionCredentials,
+            BusDaemon::GetConnectionCredentials::ResultType
+            >(name);
+
+    if (not op.is_error())
+    {
+        auto credentials = op.value();
+
+        auto pid = credentials.find("ProcessID");
+        auto uid = credentials.find("UnixUserID");
+
+        if (pid != credentials.end() && uid != credentials.end())
+            return culs::Credentials
+            {
+                static_cast<pid_t>(pid->second.as<std::uint32_t>()),
+                static_cast<uid_t>(uid->second.as<std::uint32_t>())
+            };
+    }
+
+    // Older dbus daemons do not know about GetConnectionCredentials.
+    VLOG(1) << "Falling back to individual calls for resolving credentials of " << name;
+
     return culs::Credentials
     {
-        static_cast<pid_t>(daemon.get_connection_unix_process_id(msg->sender())),
-        static_cast<uid_t>(daemon.get_connection_unix_user(msg->sender()))
+        static_cast<pid_t>(daemon.get_connection_unix_process_id(name)),
+        static_cast<uid_t>(daemon.get_connection_unix_user(name))
     };
 }
 
@@ -71,6 +315,7 @@ culs::Skeleton::Skeleton(const culs::Skeleton::Configuration& configuration)
       daemon(configuration.incoming),
       object(access_service()->add_object_for_path(culs::Interface::path())),
       properties_changed(object->get_signal<core::dbus::interfaces::Properties::Signals::PropertiesChanged>()),
+      visible_space_vehicles_changed(object->get_signal<culs::Interface::Signals::VisibleSpaceVehiclesChanged>()),
       properties
       {
           object->get_property<culs::Interface::Properties::State>(),
@@ -96,18 +341,90 @@ culs::Skeleton::Skeleton(const culs::Skeleton::Configuration& configuration)
           properties.is_online->changed().connect([this](bool value)
           {
               on_is_online_changed(value);
+          }),
+          properties.visible_space_vehicles->changed().connect([this](const std::map<cul::SpaceVehicle::Key, cul::SpaceVehicle>& svs)
+          {
+              on_visible_space_vehicles_changed(svs);
           })
-      }
+      },
+      single_fixes(std::make_shared<SingleFixes>()),
+      permission_cache(std::make_shared<culs::CachingPermissionManager>(configuration.permission_manager)),
+      permission_checks(std::make_shared<PermissionChecks>()),
+      update_encoder(std::make_shared<culss::UpdateEncoder>()),
+      statistics(std::make_shared<culss::Skeleton::Statistics>())
 {
+    announced_space_vehicles.timer = std::make_shared<culs::Timer>();
+
     object->install_method_handler<culs::Interface::CreateSessionForCriteria>([this](const dbus::Message::Ptr& msg)
     {
         handle_create_session_for_criteria(msg);
     });
+
+    object->install_method_handler<culs::Interface::RequestSingleFix>([this](const dbus::Message::Ptr& msg)
+    {
+        handle_request_single_fix(msg);
+    });
+
+    object->install_method_handler<culs::Interface::LastKnownPosition>([this](const dbus::Message::Ptr& msg)
+    {
+        handle_last_known_position(msg);
+    });
 }
 
 culs::Skeleton::~Skeleton() noexcept
 {
     object->uninstall_method_handler<culs::Interface::CreateSessionForCriteria>();
+    object->uninstall_method_handler<culs::Interface::RequestSingleFix>();
+    object->uninstall_method_handler<culs::Interface::LastKnownPosition>();
+
+    announced_space_vehicles.timer->stop();
+
+    {
+        std::lock_guard<std::mutex> lg(permission_checks->guard);
+        permission_checks->stopped = true;
+        // Checks still pending are dropped, clients see their calls time out.
+        permission_checks->queue.clear();
+    }
+
+    permission_checks->wakeup.notify_all();
+
+    for (auto& worker : permission_checks->workers)
+    {
+        // We might be destroyed by a continuation running on one of the workers,
+        // which then winds down on its own.
+        if (worker.get_id() == std::this_thread::get_id())
+            worker.detach();
+        else if (worker.joinable())
+            worker.join();
+    }
+
+    VLOG(1) << "Permission cache hits: " << permission_cache->statistics().hits
+            << ", misses: " << permission_cache->statistics().misses;
+
+    {
+        std::lock_guard<std::mutex> lg(single_fixes->guard);
+        single_fixes->stopped = true;
+    }
+
+    single_fixes->wakeup.notify_all();
+
+    if (single_fixes->worker.joinable())
+        single_fixes->worker.join();
+
+    // Requests still pending are answered with what we have got so far.
+    std::set<std::shared_ptr<SingleFixRequest>> pending;
+    {
+        std::lock_guard<std::mutex> lg(single_fixes->guard);
+        std::swap(pending, single_fixes->pending);
+        for (const auto& request : pending)
+            request->done = true;
+    }
+
+    for (const auto& request : pending)
+    {
+        request->connections.clear();
+        request->then(request->best);
+    }
 }
 
 core::Property<culs::State>& culs::Skeleton::mutable_state()
@@ -119,9 +436,29 @@ void culs::Skeleton::handle_create_session_for_criteria(const dbus::Message::Ptr
 {
     VLOG(1) << __PRETTY_FUNCTION__;
 
-    auto sender = in->sender();
-    auto reply = the_empty_reply();
-    auto thiz = shared_from_this();
+    std::weak_ptr<culs::Skeleton> weak_thiz{shared_from_this()};
+    auto incoming = configuration.incoming;
+
+    auto reply_with_error = [in, incoming](const std::string& what)
+    {
+        // We only send a very generic error message to the client to avoid
+        // leaking any sort of internal error handling details to untrusted
+        // apps.
+        auto reply = dbus::Message::make_error(
+                    in,
+                    culs::Interface::Errors::CreatingSession::name(),
+                    "Error creating session");
+        // We log the error for debugging purposes.
+        SYSLOG(ERROR) << "Error creating session: " << what;
+
+        try
+        {
+            incoming->send(reply);
+        } catch(const std::exception& e)
+        {
+            SYSLOG(ERROR) << "Error sending reply to session creation request: " << e.what();
+        }
+    };
 
     try
     {
@@ -131,14 +468,37 @@ void culs::Skeleton::handle_create_session_for_criteria(const dbus::Message::Ptr
         auto credentials =
             configuration.credentials_resolver->resolve_credentials_for_incoming_message(in);
 
-        auto result =
-            configuration.permission_manager->check_permission_for_credentials(criteria, credentials);
-
-        if (PermissionManager::Result::rejected == result) throw std::runtime_error
+        // The remainder of the request is handled once a decision is available,
+        // without blocking the bus thread while the user is prompted.
+        check_permission_for_credentials(criteria, credentials, [weak_thiz, in, criteria, credentials, reply_with_error](PermissionManager::Result result)
         {
-            "Client lacks permissions to access the service with the given criteria"
-        };
+            auto thiz = weak_thiz.lock();
+            if (not thiz)
+                return;
 
+            if (PermissionManager::Result::rejected == result)
+            {
+                reply_with_error("Client lacks permissions to access the service with the given criteria");
+                return;
+            }
+
+            thiz->create_session_for_caller(in, criteria, credentials);
+        });
+    } catch(const std::exception& e)
+    {
+        reply_with_error(e.what());
+    }
+}
+
+void culs::Skeleton::create_session_for_caller(const dbus::Message::Ptr& in, const cul::Criteria& criteria, const culs::Credentials& credentials)
+{
+    auto sender = in->sender();
+    auto reply = the_empty_reply();
+    auto thiz = shared_from_this();
+    std::weak_ptr<culs::Skeleton> weak_thiz{thiz};
+
+    try
+    {
         auto path =
             configuration.object_path_generator->object_path_for_caller_credentials(credentials);
 
@@ -151,12 +511,22 @@ void culs::Skeleton::handle_create_session_for_criteria(const dbus::Message::Ptr
             culss::Skeleton::Local
             {
                 create_session_for_criteria(criteria),
-                configuration.incoming
+                configuration.incoming,
+                update_encoder,
+                statistics,
+                [weak_thiz, path]()
+                {
+                    if (auto thiz = weak_thiz.lock())
+                        thiz->remove_from_session_store_for_path(path);
+                }
             },
             culss::Skeleton::Remote
             {
-                stub->object_for_path(path)
-            }
+                stub->object_for_path(path),
+                sender,
+                configuration.outgoing
+            },
+            configuration.session_limits
         };
 
         auto watcher = daemon.make_service_watcher(sender);
@@ -201,6 +571,332 @@ void culs::Skeleton::handle_create_session_for_criteria(const dbus::Message::Ptr
     }
 }
 
+void culs::Skeleton::handle_request_single_fix(const dbus::Message::Ptr& in)
+{
+    VLOG(1) << __PRETTY_FUNCTION__;
+
+    std::weak_ptr<culs::Skeleton> weak_thiz{shared_from_this()};
+    auto incoming = configuration.incoming;
+
+    auto reply_with_error = [in, incoming](const std::string& what)
+    {
+        // Just as for sessions, we do not leak any details to untrusted apps.
+        SYSLOG(ERROR) << "Error requesting single fix: " << what;
+
+        try
+        {
+            incoming->send(dbus::Message::make_error(
+                               in,
+                               culs::Interface::Errors::RequestingSingleFix::name(),
+                               "Error requesting single fix"));
+        } catch(const std::exception& e)
+        {
+            SYSLOG(ERROR) << "Error sending reply to single fix request: " << e.what();
+        }
+    };
+
+    try
+    {
+        Criteria criteria;
+        units::Quantity<units::Length> accuracy;
+        std::int64_t timeout{0};
+
+        auto reader = in->reader();
+        reader >> criteria >> accuracy >> timeout;
+
+        auto credentials =
+            configuration.credentials_resolver->resolve_credentials_for_incoming_message(in);
+
+        check_permission_for_credentials(criteria, credentials, [weak_thiz, in, incoming, criteria, accuracy, timeout, reply_with_error](PermissionManager::Result result)
+        {
+            auto thiz = weak_thiz.lock();
+            if (not thiz)
+                return;
+
+            if (PermissionManager::Result::rejected == result)
+            {
+                reply_with_error("Client lacks permissions to access the service with the given criteria");
+                return;
+            }
+
+            try
+            {
+                thiz->acquire_single_fix(criteria, accuracy, std::chrono::milliseconds{timeout}, [in, incoming](const cul::Optional<cul::Update<cul::Position>>& fix)
+                {
+                    auto reply = fix ?
+                                dbus::Message::make_method_return(in) :
+                                dbus::Message::make_error(
+                                    in,
+                                    culs::Interface::Errors::RequestingSingleFix::name(),
+                                    "No position fix within timeout");
+
+                    if (fix)
+                        reply->writer() << *fix;
+
+                    try
+                    {
+                        incoming->send(reply);
+                    } catch(const std::exception& e)
+                    {
+                        SYSLOG(ERROR) << "Error sending reply to single fix request: " << e.what();
+                    }
+                });
+            } catch(const std::exception& e)
+            {
+                reply_with_error(e.what());
+            }
+        });
+    } catch(const std::exception& e)
+    {
+        reply_with_error(e.what());
+    }
+}
+
+void culs::Skeleton::handle_last_known_position(const dbus::Message::Ptr& in)
+{
+    VLOG(1) << __PRETTY_FUNCTION__;
+
+    std::weak_ptr<culs::Skeleton> weak_thiz{shared_from_this()};
+    auto incoming = configuration.incoming;
+
+    // Replies with the last known position, or with an error if error is not empty.
+    auto respond = [in, incoming](const std::shared_ptr<culs::Skeleton>& thiz, const std::string& error)
+    {
+        auto reply = the_empty_reply();
+
+        try
+        {
+            if (not error.empty()) throw std::runtime_error
+            {
+                error
+            };
+
+            auto result = thiz->last_known_position();
+
+            reply = dbus::Message::make_method_return(in);
+            reply->writer()
+                    << std::get<0>(result)
+                    << static_cast<std::int64_t>(std::get<1>(result).count());
+        } catch(const std::exception& e)
+        {
+            reply = dbus::Message::make_error(
+                        in,
+                        culs::Interface::Errors::QueryingLastKnownPosition::name(),
+                        "Error querying last known position");
+            SYSLOG(ERROR) << "Error querying last known position: " << e.what();
+        }
+
+        try
+        {
+            incoming->send(reply);
+        } catch(const std::exception& e)
+        {
+            SYSLOG(ERROR) << "Error sending reply to last known position query: " << e.what();
+        }
+    };
+
+    try
+    {
+        auto credentials =
+            configuration.credentials_resolver->resolve_credentials_for_incoming_message(in);
+
+        check_permission_for_credentials(cul::Criteria{}, credentials, [weak_thiz, respond](PermissionManager::Result result)
+        {
+            auto thiz = weak_thiz.lock();
+            if (not thiz)
+                return;
+
+            respond(thiz, PermissionManager::Result::rejected == result ?
+                        "Client lacks permissions to access the service" : "");
+        });
+    } catch(const std::exception& e)
+    {
+        respond(std::shared_ptr<culs::Skeleton>{}, e.what());
+    }
+}
+
+void culs::Skeleton::check_permission_for_credentials(
+        const cul::Criteria& criteria,
+        const culs::Credentials& credentials,
+        const std::function<void(PermissionManager::Result)>& then)
+{
+    if (auto result = permission_cache->cached_permission_for_credentials(credentials))
+    {
+        then(*result);
+        return;
+    }
+
+    auto cache = permission_cache;
+    auto task = [cache, criteria, credentials, then]()
+    {
+        then(cache->check_permission_for_credentials(criteria, credentials));
+    };
+
+    auto checks = permission_checks;
+
+    {
+        std::lock_guard<std::mutex> lg(checks->guard);
+        checks->queue.push_back(task);
+
+        // Every pending check might block on a prompt, so we grow the pool
+        // up to its maximum size instead of queueing behind a blocked worker.
+        if (checks->workers.size() < maximum_permission_check_workers && checks->queue.size() > checks->idle)
+            checks->workers.emplace_back([checks]() { run_permission_checks(checks); });
+    }
+
+    checks->wakeup.notify_one();
+}
+
+void culs::Skeleton::run_permission_checks(const std::shared_ptr<PermissionChecks>& checks)
+{
+    std::unique_lock<std::mutex> ul(checks->guard);
+
+    while (true)
+    {
+        checks->idle++;
+        checks->wakeup.wait(ul, [&checks]()
+        {
+            return checks->stopped || not checks->queue.empty();
+        });
+        checks->idle--;
+
+        if (checks->stopped)
+            return;
+
+        auto task = checks->queue.front();
+        checks->queue.pop_front();
+
+        ul.unlock();
+
+        try
+        {
+            task();
+        } catch(const std::exception& e)
+        {
+            SYSLOG(ERROR) << "Error checking permissions: " << e.what();
+        }
+
+        ul.lock();
+    }
+}
+
+void culs::Skeleton::acquire_single_fix(
+        const cul::Criteria& criteria,
+        const cul::units::Quantity<cul::units::Length>& accuracy,
+        const std::chrono::milliseconds& timeout,
+        const std::function<void(const cul::Optional<cul::Update<cul::Position>>&)>& then)
+{
+    auto clamped_timeout = std::max(
+                std::chrono::milliseconds{0},
+                std::min(timeout, culs::Interface::RequestSingleFix::max_timeout()));
+
+    auto request = std::make_shared<SingleFixRequest>();
+    request->accuracy = accuracy;
+    request->deadline = std::chrono::steady_clock::now() + clamped_timeout;
+    request->then = then;
+    request->session = create_session_for_criteria(criteria);
+    request->done = false;
+
+    std::weak_ptr<SingleFixRequest> wp{request};
+    std::weak_ptr<SingleFixes> wf{single_fixes};
+
+    // Runs on the providers' threads, and must not refer to us.
+    auto on_fix = [wf, wp](const cul::Update<cul::Position>& update)
+    {
+        auto fixes = wf.lock();
+        auto sp = wp.lock();
+        if (not fixes || not sp)
+            return;
+
+        std::lock_guard<std::mutex> lg(fixes->guard);
+        if (sp->done)
+            return;
+
+        if (is_better_fix(update, sp->best))
+            sp->best = update;
+
+        if (is_accurate_enough(update, sp->accuracy))
+        {
+            sp->done = true;
+            fixes->wakeup.notify_all();
+        }
+    };
+
+    request->connections.emplace_back(request->session->updates().position.changed().connect(on_fix));
+    request->connections.emplace_back(request->session->updates().position_batch.connect(
+        [on_fix](const std::vector<cul::Update<cul::Position>>& batch)
+        {
+            for (const auto& update : batch)
+                on_fix(update);
+        }));
+
+    {
+        std::lock_guard<std::mutex> lg(single_fixes->guard);
+        single_fixes->pending.insert(request);
+
+        if (not single_fixes->worker.joinable())
+            single_fixes->worker = std::thread{[this]() { run_single_fix_requests(); }};
+    }
+
+    single_fixes->wakeup.notify_all();
+
+    // Providers might deliver synchronously, so we must not hold the lock here.
+    request->session->updates().position_status = culss::Interface::Updates::Status::enabled;
+}
+
+void culs::Skeleton::run_single_fix_requests()
+{
+    std::unique_lock<std::mutex> ul(single_fixes->guard);
+
+    while (not single_fixes->stopped)
+    {
+        auto now = std::chrono::steady_clock::now();
+
+        std::vector<std::shared_ptr<SingleFixRequest>> completed;
+        cul::Optional<std::chrono::steady_clock::time_point> next;
+
+        for (auto it = single_fixes->pending.begin(); it != single_fixes->pending.end();)
+        {
+            if ((*it)->done || (*it)->deadline <= now)
+            {
+                (*it)->done = true;
+                completed.push_back(*it);
+                it = single_fixes->pending.erase(it);
+                continue;
+            }
+
+            if (not next || (*it)->deadline < *next)
+                next = (*it)->deadline;
+
+            ++it;
+        }
+
+        if (completed.empty())
+        {
+            if (next)
+                single_fixes->wakeup.wait_until(ul, *next);
+            else
+                single_fixes->wakeup.wait(ul);
+
+            continue;
+        }
+
+        ul.unlock();
+
+        for (const auto& request : completed)
+        {
+            request->connections.clear();
+            request->then(request->best);
+            // Releasing the session stops the providers right away.
+            request->session.reset();
+        }
+
+        completed.clear();
+
+        ul.lock();
+    }
+}
+
 bool culs::Skeleton::add_to_session_store_for_path(
         const core::dbus::types::ObjectPath& path,
         std::unique_ptr<core::dbus::ServiceWatcher> watcher,
@@ -286,6 +982,66 @@ void culs::Skeleton::on_is_online_changed(bool value)
                 the_empty_array_of_invalidated_properties()));
 }
 
+void culs::Skeleton::on_visible_space_vehicles_changed(const std::map<cul::SpaceVehicle::Key, cul::SpaceVehicle>& svs)
+{
+    std::map<cul::SpaceVehicle::Key, cul::SpaceVehicle> updated;
+    std::vector<cul::SpaceVehicle::Key> removed;
+
+    {
+        std::lock_guard<std::mutex> lg(announced_space_vehicles.guard);
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - announced_space_vehicles.when < minimum_space_vehicle_announcement_interval)
+        {
+            announced_space_vehicles.pending = svs;
+
+            auto due = announced_space_vehicles.when + minimum_space_vehicle_announcement_interval;
+            announced_space_vehicles.timer->schedule(
+                        std::chrono::duration_cast<std::chrono::milliseconds>(due - now),
+                        [this]() { announce_held_back_space_vehicles(); });
+            return;
+        }
+
+        // We are announcing a more recent set right away.
+        announced_space_vehicles.pending.reset();
+
+        diff_space_vehicles(announced_space_vehicles.svs, svs, updated, removed);
+
+        if (updated.empty() && removed.empty())
+            return;
+
+        announced_space_vehicles.svs = svs;
+        announced_space_vehicles.when = now;
+    }
+
+    visible_space_vehicles_changed->emit(std::tie(updated, removed));
+}
+
+void culs::Skeleton::announce_held_back_space_vehicles()
+{
+    std::map<cul::SpaceVehicle::Key, cul::SpaceVehicle> updated;
+    std::vector<cul::SpaceVehicle::Key> removed;
+
+    {
+        std::lock_guard<std::mutex> lg(announced_space_vehicles.guard);
+
+        if (not announced_space_vehicles.pending)
+            return;
+
+        diff_space_vehicles(announced_space_vehicles.svs, *announced_space_vehicles.pending, updated, removed);
+
+        announced_space_vehicles.svs = *announced_space_vehicles.pending;
+        announced_space_vehicles.pending.reset();
+
+        if (updated.empty() && removed.empty())
+            return;
+
+        announced_space_vehicles.when = std::chrono::steady_clock::now();
+    }
+
+    visible_space_vehicles_changed->emit(std::tie(updated, removed));
+}
+
 const core::Property<culs::State>& culs::Skeleton::state() const
 {
     return *properties.state;
@@ -310,3 +1066,36 @@ core::Property<std::map<cul::SpaceVehicle::Key, cul::SpaceVehicle>>& culs::Skele
 {
     return *properties.visible_space_vehicles;
 }
+
+cul::Update<cul::Position> culs::Skeleton::request_single_fix(
+        const cul::Criteria& criteria,
+        const cul::units::Quantity<cul::units::Length>& accuracy,
+        const std::chrono::milliseconds& timeout)
+{
+    auto promise = std::make_shared<std::promise<cul::Optional<cul::Update<cul::Position>>>>();
+    auto future = promise->get_future();
+
+    acquire_single_fix(criteria, accuracy, timeout, [promise](const cul::Optional<cul::Update<cul::Position>>& fix)
+    {
+        promise->set_value(fix);
+    });
+
+    auto fix = future.get();
+
+    if (not fix) throw std::runtime_error
+    {
+        "No position fix within timeout"
+    };
+
+    return *fix;
+}
+
+const culs::CachingPermissionManager::Statistics& culs::Skeleton::permission_statistics() const
+{
+    return permission_cache->statistics();
+}
+
+const culss::Skeleton::Statistics& culs::Skeleton::session_statistics() const
+{
+    return *statistics;
+}
@@ -76,6 +76,43 @@ culss::Interface::Ptr culs::Stub::create_session_for_criteria(const cul::Criteri
     return culss::Interface::Ptr(new culss::Stub{d->bus, op.value()});
 }
 
+cul::Update<cul::Position> culs::Stub::request_single_fix(
+        const cul::Criteria& criteria,
+        const cul::units::Quantity<cul::units::Length>& accuracy,
+        const std::chrono::milliseconds& timeout)
+{
+    auto op = d->object->transact_method<
+            culs::Interface::RequestSingleFix,
+            culs::Interface::RequestSingleFix::ResultType
+            >(criteria, accuracy, static_cast<std::int64_t>(timeout.count()));
+
+    if (op.is_error())
+    {
+        std::stringstream ss; ss << __PRETTY_FUNCTION__ << ": " << op.error().print();
+        throw std::runtime_error(ss.str());
+    }
+
+    return op.value();
+}
+
+std::tuple<cul::Update<cul::Position>, std::chrono::milliseconds> culs::Stub::last_known_position()
+{
+    auto op = d->object->transact_method<
+            culs::Interface::LastKnownPosition,
+            culs::Interface::LastKnownPosition::ResultType
+            >();
+
+    if (op.is_error())
+    {
+        std::stringstream ss; ss << __PRETTY_FUNCTION__ << ": " << op.error().print();
+        throw std::runtime_error(ss.str());
+    }
+
+    return std::make_tuple(
+                std::get<0>(op.value()),
+                std::chrono::milliseconds{std::get<1>(op.value())});
+}
+
 const core::Property<culs::State>& culs::Stub::state() const
 {
     return *d->state;
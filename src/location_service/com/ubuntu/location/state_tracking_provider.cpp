@@ -0,0 +1,328 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <com/ubuntu/location/state_tracking_provider.h>
+
+#include <com/ubuntu/location/logging.h>
+
+#include <algorithm>
+
+namespace cul = com::ubuntu::location;
+
+namespace
+{
+// Returns the p-th percentile of samples according to the nearest-rank method.
+std::chrono::milliseconds percentile(std::vector<std::chrono::milliseconds> samples, unsigned int p)
+{
+    if (samples.empty())
+        return std::chrono::milliseconds{0};
+
+    std::size_t rank = (p * samples.size() + 99) / 100;
+    auto nth = samples.begin() + (rank > 0 ? rank - 1 : 0);
+    std::nth_element(samples.begin(), nth, samples.end());
+
+    return *nth;
+}
+}
+
+const std::size_t cul::StateTrackingProvider::time_to_first_fix_window;
+
+cul::StateTrackingProvider::StateTrackingProvider(const cul::Provider::Ptr& impl, const Dispatcher& dispatcher)
+    : impl_{impl},
+      dispatcher_{dispatcher},
+      connections
+      {
+          impl_->updates().position.connect(
+              [this](const Update<Position>& u)
+              {
+                  on_position_fix();
+                  deliver([this, u]() { mutable_updates().position(u); });
+              }),
+          impl_->updates().heading.connect(
+              [this](const Update<Heading>& u)
+              {
+                  deliver([this, u]() { mutable_updates().heading(u); });
+              }),
+          impl_->updates().velocity.connect(
+              [this](const Update<Velocity>& u)
+              {
+                  deliver([this, u]() { mutable_updates().velocity(u); });
+              }),
+          impl_->updates().svs.connect(
+              [this](const Update<std::set<SpaceVehicle>>& u)
+              {
+                  deliver([this, u]() { mutable_updates().svs(u); });
+              }),
+          impl_->updates().position_batch.connect(
+              [this](const std::vector<Update<Position>>& batch)
+              {
+                  if (not batch.empty())
+                      on_position_fix();
+                  deliver([this, batch]() { mutable_updates().position_batch(batch); });
+              })
+      },
+      state_{State::enabled}
+{
+}
+
+cul::StateTrackingProvider::~StateTrackingProvider() noexcept
+{
+    linger_timer.stop();
+
+    // We do not leave impl running once we are gone.
+    std::vector<Feature> features;
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        features = expire_locked(std::chrono::steady_clock::time_point::max());
+    }
+
+    for (auto feature : features)
+    {
+        switch (feature)
+        {
+        case Feature::position: impl_->state_controller()->stop_position_updates(); break;
+        case Feature::heading: impl_->state_controller()->stop_heading_updates(); break;
+        case Feature::velocity: impl_->state_controller()->stop_velocity_updates(); break;
+        }
+    }
+}
+
+void cul::StateTrackingProvider::set_linger_period(const std::chrono::milliseconds& period)
+{
+    std::vector<Feature> features;
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        linger_period = period;
+
+        // Without a linger period, nothing should be pending.
+        if (linger_period.count() == 0)
+            features = expire_locked(std::chrono::steady_clock::time_point::max());
+    }
+
+    stop_impl(features);
+}
+
+cul::StateTrackingProvider::Statistics cul::StateTrackingProvider::statistics() const
+{
+    std::lock_guard<std::mutex> lg(guard);
+    return stats;
+}
+
+void cul::StateTrackingProvider::start(Feature feature)
+{
+    bool needs_start = false;
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        auto& l = lingering[static_cast<std::size_t>(feature)];
+
+        if (l.stop_at)
+        {
+            // impl is still warm, we just forget about stopping it.
+            l.stop_at.reset();
+            stats.cancelled_stops++;
+        }
+        else if (not l.running)
+        {
+            l.running = true;
+            stats.starts++;
+            needs_start = true;
+        }
+
+        if (feature == Feature::position && not first_fix_requested_at)
+            first_fix_requested_at = std::chrono::steady_clock::now();
+    }
+
+    update_state();
+
+    // We call out to impl without holding the lock, impl might synchronously deliver
+    // updates. impl's controller counts starts and stops, so order does not matter here.
+    if (needs_start)
+    {
+        switch (feature)
+        {
+        case Feature::position: impl_->state_controller()->start_position_updates(); break;
+        case Feature::heading: impl_->state_controller()->start_heading_updates(); break;
+        case Feature::velocity: impl_->state_controller()->start_velocity_updates(); break;
+        }
+    }
+}
+
+void cul::StateTrackingProvider::stop(Feature feature)
+{
+    std::vector<Feature> features;
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        auto& l = lingering[static_cast<std::size_t>(feature)];
+
+        if (not l.running || l.stop_at)
+            return;
+
+        // Controller::disable() stops updates while its counters are still positive. A
+        // disabled provider must not keep on running, so we stop immediately and take
+        // all other lingering updates down with us.
+        bool disabling = false;
+        switch (feature)
+        {
+        case Feature::position: disabling = state_controller()->are_position_updates_running(); break;
+        case Feature::heading: disabling = state_controller()->are_heading_updates_running(); break;
+        case Feature::velocity: disabling = state_controller()->are_velocity_updates_running(); break;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+
+        if (not disabling && linger_period.count() > 0)
+        {
+            l.stop_at = now + linger_period;
+            schedule_pending_stops_locked();
+            return;
+        }
+
+        l.stop_at = now;
+        features = expire_locked(disabling ? std::chrono::steady_clock::time_point::max() : now);
+    }
+
+    stop_impl(features);
+}
+
+void cul::StateTrackingProvider::stop_impl(const std::vector<Feature>& features)
+{
+    if (features.empty())
+        return;
+
+    // Other kinds of updates might still be running.
+    update_state();
+
+    for (auto feature : features)
+    {
+        switch (feature)
+        {
+        case Feature::position: impl_->state_controller()->stop_position_updates(); break;
+        case Feature::heading: impl_->state_controller()->stop_heading_updates(); break;
+        case Feature::velocity: impl_->state_controller()->stop_velocity_updates(); break;
+        }
+    }
+}
+
+void cul::StateTrackingProvider::update_state()
+{
+    std::lock_guard<std::mutex> sg(state_guard);
+
+    bool any_running = false;
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        for (const auto& l : lingering)
+            any_running = any_running || l.running;
+    }
+
+    state_ = any_running ? State::active : State::enabled;
+}
+
+std::vector<cul::StateTrackingProvider::Feature> cul::StateTrackingProvider::expire_locked(
+        const std::chrono::steady_clock::time_point& deadline)
+{
+    std::vector<Feature> result;
+
+    for (auto feature : {Feature::position, Feature::heading, Feature::velocity})
+    {
+        auto& l = lingering[static_cast<std::size_t>(feature)];
+
+        if (not l.stop_at || *l.stop_at > deadline)
+            continue;
+
+        l.running = false;
+        l.stop_at.reset();
+        stats.stops++;
+
+        if (feature == Feature::position)
+            first_fix_requested_at.reset();
+
+        result.push_back(feature);
+    }
+
+    return result;
+}
+
+void cul::StateTrackingProvider::on_position_fix()
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (not first_fix_requested_at)
+        return;
+
+    auto ttff = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - *first_fix_requested_at);
+    first_fix_requested_at.reset();
+
+    stats.first_fixes++;
+    stats.total_time_to_first_fix += ttff;
+    stats.last_time_to_first_fix = ttff;
+
+    times_to_first_fix.push_back(ttff);
+    if (times_to_first_fix.size() > time_to_first_fix_window)
+        times_to_first_fix.pop_front();
+
+    std::vector<std::chrono::milliseconds> samples(times_to_first_fix.begin(), times_to_first_fix.end());
+    stats.time_to_first_fix_p50 = percentile(samples, 50);
+    stats.time_to_first_fix_p90 = percentile(samples, 90);
+    stats.time_to_first_fix_p99 = percentile(samples, 99);
+
+    LOG(INFO) << "Time to first fix of provider " << impl_.get() << ": " << ttff.count() << " [ms], "
+              << "p50: " << stats.time_to_first_fix_p50.count() << " [ms], "
+              << "p90: " << stats.time_to_first_fix_p90.count() << " [ms], "
+              << "p99: " << stats.time_to_first_fix_p99.count() << " [ms]";
+}
+
+void cul::StateTrackingProvider::deliver(const std::function<void()>& task)
+{
+    if (not dispatcher_)
+    {
+        task();
+        return;
+    }
+
+    dispatcher_(task);
+}
+
+void cul::StateTrackingProvider::schedule_pending_stops_locked()
+{
+    Optional<std::chrono::steady_clock::time_point> next;
+    for (const auto& l : lingering)
+        if (l.stop_at && (not next || *l.stop_at < *next))
+            next = l.stop_at;
+
+    if (not next)
+        return;
+
+    // We round up, such that the timer does not fire before the stop is due.
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(*next - std::chrono::steady_clock::now());
+    linger_timer.schedule(std::max(std::chrono::milliseconds{0}, delay + std::chrono::milliseconds{1}), [this]()
+    {
+        execute_pending_stops();
+    });
+}
+
+void cul::StateTrackingProvider::execute_pending_stops()
+{
+    std::vector<Feature> features;
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        features = expire_locked(std::chrono::steady_clock::now());
+        schedule_pending_stops_locked();
+    }
+
+    stop_impl(features);
+}
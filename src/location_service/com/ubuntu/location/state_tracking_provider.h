@@ -19,8 +19,16 @@
 #define LOCATION_SERVICE_COM_UBUNTU_LOCATION_STATE_TRACKING_PROVIDER_H_
 
 #include <com/ubuntu/location/provider.h>
+#include <com/ubuntu/location/service/runtime.h>
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace com
 {
@@ -45,35 +53,60 @@ public:
         enabled // The provider is enabled but not actively delivering updates.
     };
 
-    StateTrackingProvider(const Provider::Ptr& impl)
-        : impl_{impl},
-          connections
-          {
-              impl_->updates().position.connect(
-                  [this](const Update<Position>& u)
-                  {
-                      mutable_updates().position(u);
-                  }),
-              impl_->updates().heading.connect(
-                  [this](const Update<Heading>& u)
-                  {
-                      mutable_updates().heading(u);
-                  }),
-              impl_->updates().velocity.connect(
-                  [this](const Update<Velocity>& u)
-                  {
-                      mutable_updates().velocity(u);
-                  })
-           },
-          state_{State::enabled}
-    {
-    }
+    // Statistics about starting and stopping impl, helping to tune the linger period.
+    struct Statistics
+    {
+        // Number of times impl has been asked to start updates.
+        std::uint64_t starts{0};
+        // Number of times impl has been asked to stop updates.
+        std::uint64_t stops{0};
+        // Number of pending stops that were cancelled as updates were requested again
+        // within the linger period.
+        std::uint64_t cancelled_stops{0};
+        // Number of times the time to first fix has been measured.
+        std::uint64_t first_fixes{0};
+        // Sum of all times to first fix, measured from requesting position updates
+        // to receiving the first position update.
+        std::chrono::milliseconds total_time_to_first_fix{0};
+        // The most recently measured time to first fix.
+        std::chrono::milliseconds last_time_to_first_fix{0};
+        // Percentiles over the most recently measured times to first fix.
+        std::chrono::milliseconds time_to_first_fix_p50{0};
+        std::chrono::milliseconds time_to_first_fix_p90{0};
+        std::chrono::milliseconds time_to_first_fix_p99{0};
+    };
+
+    // Executes tasks in order, e.g., on a service::Runtime strand.
+    typedef std::function<void(std::function<void()>)> Dispatcher;
+
+    // Number of recent times to first fix that percentiles are calculated from.
+    static constexpr const std::size_t time_to_first_fix_window{100};
+
+    // Updates of impl are handed out on dispatcher, or inline if dispatcher is empty.
+    // dispatcher must not run tasks handed to it once this instance is gone.
+    StateTrackingProvider(const Provider::Ptr& impl, const Dispatcher& dispatcher = Dispatcher{});
+    // Stops all updates that are still lingering.
+    ~StateTrackingProvider() noexcept;
+
+    // Keeps impl running for period after the last consumer stopped updates, such that
+    // consumers coming back within period do not pay for a full restart. Updates are
+    // stopped immediately if period is zero, or if the provider is disabled. Setting
+    // period to zero carries out all pending stops.
+    void set_linger_period(const std::chrono::milliseconds& period);
+
+    // Returns a snapshot of the statistics collected so far.
+    Statistics statistics() const;
 
     const core::Property<State>& state() const
     {
         return state_;
     }
 
+    const core::Property<bool>& available() const override
+    {
+        return impl_->available();
+    }
+
     bool supports(const Features& f) const override
     {
         return impl_->supports(f);
@@ -111,49 +144,101 @@ public:
 
     void start_position_updates() override
     {
-        state_ = State::active;
-        impl_->state_controller()->start_position_updates();
+        start(Feature::position);
     }
 
     void stop_position_updates() override
     {
-        state_ = State::enabled;
-        impl_->state_controller()->stop_position_updates();
+        stop(Feature::position);
     }
 
     void start_velocity_updates() override
     {
-        state_ = State::active;
-        impl_->state_controller()->start_velocity_updates();
+        start(Feature::velocity);
     }
 
     void stop_velocity_updates() override
     {
-        state_ = State::enabled;
-        impl_->state_controller()->stop_velocity_updates();
+        stop(Feature::velocity);
     }
 
     void start_heading_updates() override
     {
-        state_ = State::active;
-        impl_->state_controller()->start_heading_updates();
+        start(Feature::heading);
     }
 
     void stop_heading_updates() override
     {
-        state_ = State::enabled;
-        impl_->state_controller()->stop_heading_updates();
+        stop(Feature::heading);
+    }
+
+    void set_update_interval(const Optional<std::chrono::milliseconds>& interval) override
+    {
+        impl_->state_controller()->replace_update_interval(update_interval_, interval);
+        update_interval_ = interval;
     }
 
 private:
+    // The kinds of updates we track individually.
+    enum class Feature
+    {
+        position = 0,
+        heading = 1,
+        velocity = 2
+    };
+
+    // Lingering tracks whether impl runs a specific kind of updates, and when we are
+    // going to stop it if no consumer requests the updates again.
+    struct Lingering
+    {
+        bool running{false};
+        Optional<std::chrono::steady_clock::time_point> stop_at;
+    };
+
+    // Starts updates on impl, or cancels a pending stop.
+    void start(Feature feature);
+    // Stops updates on impl, either immediately or after the linger period.
+    void stop(Feature feature);
+    // Stops the given updates on impl, bypassing the linger period.
+    void stop_impl(const std::vector<Feature>& features);
+    // Derives state_ from the updates impl is running.
+    void update_state();
+    // Marks all updates with a pending stop before deadline as stopped and returns them.
+    std::vector<Feature> expire_locked(const std::chrono::steady_clock::time_point& deadline);
+    // Measures the time to first fix if a fix has been requested.
+    void on_position_fix();
+    // Arms linger_timer for the earliest pending stop, called with guard held.
+    void schedule_pending_stops_locked();
+    // Executes pending stops that are due, run on linger_timer.
+    void execute_pending_stops();
+    // Hands task to dispatcher_, or executes it inline if no dispatcher is configured.
+    void deliver(const std::function<void()>& task);
+
     Provider::Ptr impl_;
+    Dispatcher dispatcher_;
+    mutable std::mutex guard;
+    std::chrono::milliseconds linger_period{0};
+    std::array<Lingering, 3> lingering;
+    // Set when position updates are requested, reset on the first position update.
+    Optional<std::chrono::steady_clock::time_point> first_fix_requested_at;
+    Statistics stats;
+    // The most recently measured times to first fix, oldest first.
+    std::deque<std::chrono::milliseconds> times_to_first_fix;
+    // Carries out lingering stops once they are due.
+    service::Timer linger_timer;
     struct
     {
         core::ScopedConnection position_updates;
         core::ScopedConnection heading_updates;
         core::ScopedConnection velocity_updates;
+        core::ScopedConnection space_vehicle_updates;
+        core::ScopedConnection position_batch_updates;
     } connections;
+    // Serializes updates of state_, such that the last update reflects the latest lingering.
+    std::mutex state_guard;
     core::Property<State> state_;
+    // The update interval we requested from impl_.
+    Optional<std::chrono::milliseconds> update_interval_;
 };
 }
 }
@@ -82,6 +82,11 @@ const location::Update<location::Heading>& TimeBasedUpdatePolicy::verify_update(
     {
         use_new_update = false;
     }
+    else
+    {
+        // Within the time bracket we just prefer the more recent update.
+        use_new_update = update.when >= last_heading_update.when;
+    }
     if (use_new_update)
     {
         last_heading_update = update;
@@ -105,6 +110,11 @@ const location::Update<location::Velocity>& TimeBasedUpdatePolicy::verify_update
     {
         use_new_update = false;
     }
+    else
+    {
+        // Within the time bracket we just prefer the more recent update.
+        use_new_update = update.when >= last_velocity_update.when;
+    }
 
     if (use_new_update)
     {
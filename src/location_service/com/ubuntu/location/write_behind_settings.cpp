@@ -0,0 +1,189 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <com/ubuntu/location/write_behind_settings.h>
+
+#include <com/ubuntu/location/logging.h>
+
+namespace location = com::ubuntu::location;
+
+const std::chrono::milliseconds location::WriteBehindSettings::default_debounce{500};
+
+location::WriteBehindSettings::WriteBehindSettings(const location::Settings::Ptr& impl, const std::chrono::milliseconds& debounce)
+    : impl{impl},
+      debounce{debounce},
+      worker{[this]() { run(); }}
+{
+}
+
+location::WriteBehindSettings::~WriteBehindSettings()
+{
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        stopped = true;
+    }
+
+    wakeup.notify_all();
+
+    if (worker.joinable())
+        worker.join();
+
+    flush();
+}
+
+void location::WriteBehindSettings::sync()
+{
+    flush();
+}
+
+void location::WriteBehindSettings::sync_if_due(const std::chrono::steady_clock::time_point& now)
+{
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        if (not dirty || now < due)
+            return;
+    }
+
+    flush();
+}
+
+bool location::WriteBehindSettings::has_value_for_key(const std::string& key) const
+{
+    return lookup(key).is_initialized();
+}
+
+std::string location::WriteBehindSettings::get_string_for_key_or_throw(const std::string& key)
+{
+    auto value = lookup(key);
+
+    if (not value)
+        throw Settings::Error::NoValueForKey{key};
+
+    return *value;
+}
+
+bool location::WriteBehindSettings::set_string_for_key(const std::string& key, const std::string& value)
+{
+    // Makes sure that values is populated from impl for key.
+    lookup(key);
+
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        // Setting a value to what it already is does not need to hit the disk.
+        auto it = values.find(key);
+        if (it != values.end() && it->second == value)
+        {
+            stats.saved_syncs++;
+            return true;
+        }
+
+        values[key] = value;
+        pending[key] = value;
+
+        stats.changes++;
+
+        // The change is picked up by the sync that is already pending.
+        if (dirty)
+        {
+            stats.saved_syncs++;
+            return true;
+        }
+
+        dirty = true;
+        due = std::chrono::steady_clock::now() + debounce;
+    }
+
+    wakeup.notify_all();
+    return true;
+}
+
+const location::WriteBehindSettings::Statistics& location::WriteBehindSettings::statistics() const
+{
+    return stats;
+}
+
+void location::WriteBehindSettings::run()
+{
+    std::unique_lock<std::mutex> ul(guard);
+
+    while (not stopped)
+    {
+        if (not dirty)
+        {
+            wakeup.wait(ul, [this]() { return dirty || stopped; });
+            continue;
+        }
+
+        if (wakeup.wait_until(ul, due, [this]() { return stopped; }))
+            break;
+
+        ul.unlock();
+        sync_if_due(std::chrono::steady_clock::now());
+        ul.lock();
+    }
+}
+
+location::Optional<std::string> location::WriteBehindSettings::lookup(const std::string& key) const
+{
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        auto it = values.find(key);
+        if (it != values.end())
+            return it->second;
+    }
+
+    std::lock_guard<std::mutex> io(io_guard);
+
+    if (not impl->has_value_for_key(key))
+        return Optional<std::string>{};
+
+    auto value = impl->get_string_for_key_or_throw(key);
+
+    // A value set in the meantime takes precedence.
+    std::lock_guard<std::mutex> lg(guard);
+    return values.insert(std::make_pair(key, value)).first->second;
+}
+
+void location::WriteBehindSettings::flush()
+{
+    // Taken before snapshotting, such that concurrent flushes hand changes to impl in order.
+    std::lock_guard<std::mutex> io(io_guard);
+
+    std::map<std::string, std::string> changes;
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        if (not dirty)
+            return;
+
+        dirty = false;
+        std::swap(changes, pending);
+        stats.syncs++;
+    }
+
+    for (const auto& change : changes)
+        if (not impl->set_string_for_key(change.first, change.second))
+            LOG(WARNING) << "Could not store value for " << change.first;
+
+    try
+    {
+        impl->sync();
+    }
+    catch (const std::exception& e)
+    {
+        LOG(WARNING) << "Could not sync settings: " << e.what();
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LOCATION_SERVICE_COM_UBUNTU_LOCATION_WRITE_BEHIND_SETTINGS_H_
+#define LOCATION_SERVICE_COM_UBUNTU_LOCATION_WRITE_BEHIND_SETTINGS_H_
+
+#include <com/ubuntu/location/optional.h>
+#include <com/ubuntu/location/settings.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace com
+{
+namespace ubuntu
+{
+namespace location
+{
+// A decorator that syncs changed values to the decorated settings instance
+// in the background. All changes within a debounce window are coalesced into
+// a single sync, and pending changes are synced on destruction. Changes are
+// kept in memory and only handed to the decorated instance when syncing, such
+// that callers never wait for the disk.
+class WriteBehindSettings : public Settings
+{
+public:
+    // Counts the changes handed to us and the syncs they resulted in.
+    struct Statistics
+    {
+        // Number of changes to values.
+        std::atomic<std::uint64_t> changes{0};
+        // Number of syncs to the decorated settings instance.
+        std::atomic<std::uint64_t> syncs{0};
+        // Number of syncs that we saved by skipping unchanged values
+        // and coalescing changes within the debounce window.
+        std::atomic<std::uint64_t> saved_syncs{0};
+    };
+
+    // The default debounce window.
+    static const std::chrono::milliseconds default_debounce;
+
+    // Sets up a new instance decorating impl, syncing changes at most once per debounce.
+    WriteBehindSettings(const Settings::Ptr& impl, const std::chrono::milliseconds& debounce = default_debounce);
+    // Syncs pending changes and stops the background worker.
+    ~WriteBehindSettings();
+
+    // Syncs pending changes right away.
+    void sync() override;
+
+    // Syncs pending changes iff their debounce window has passed at now.
+    // Invoked by the background worker, and exposed for testing purposes.
+    void sync_if_due(const std::chrono::steady_clock::time_point& now);
+
+    // Returns true iff a value is known for the given key.
+    bool has_value_for_key(const std::string& key) const override;
+
+    // Gets a string value known for the given key, or throws Error::NoValueForKey.
+    std::string get_string_for_key_or_throw(const std::string& key) override;
+
+    // Sets values known for the given key, scheduling a sync if the value changed.
+    // Values the decorated instance refuses to store are logged when syncing.
+    bool set_string_for_key(const std::string& key, const std::string& value) override;
+
+    // Returns the counters of changes and syncs.
+    const Statistics& statistics() const;
+
+private:
+    // Syncs pending changes when the debounce window has passed.
+    void run();
+    // Returns the value known for key, consulting impl if we have not seen key before.
+    Optional<std::string> lookup(const std::string& key) const;
+    // Hands pending changes to impl and syncs it.
+    void flush();
+
+    Settings::Ptr impl;
+    std::chrono::milliseconds debounce;
+    // Serializes all accesses to impl, including the disk I/O of syncs.
+    // Acquired before guard if both are needed.
+    mutable std::mutex io_guard;
+    // Guards the values below, never held while accessing impl.
+    mutable std::mutex guard;
+    std::condition_variable wakeup;
+    // All values we know about, the ones not synced yet included.
+    mutable std::map<std::string, std::string> values;
+    // Changes not handed to impl yet.
+    std::map<std::string, std::string> pending;
+    // True iff changes have not been synced yet.
+    bool dirty{false};
+    // Point in time when pending changes are due to be synced.
+    std::chrono::steady_clock::time_point due;
+    bool stopped{false};
+    Statistics stats;
+    std::thread worker;
+};
+}
+}
+}
+
+#endif // LOCATION_SERVICE_COM_UBUNTU_LOCATION_WRITE_BEHIND_SETTINGS_H_
@@ -52,6 +52,7 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <bitset>
 #include <chrono>
 #include <iostream>
@@ -666,6 +667,394 @@ TEST_F(LocationServiceStandalone, VisibleSpaceVehiclesCanBeQueried)
     EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(server, client));
 }
 
+TEST_F(LocationServiceStandalone, SingleFixIsAnsweredWithTheBestFixOnceTheTimeoutExpires)
+{
+    EXPECT_TRUE(trust_store_is_set_up_for_testing);
+
+    core::testing::CrossProcessSync sync_start;
+
+    static const std::chrono::milliseconds timeout{1000};
+
+    // Never satisfies the accuracy requested by the client.
+    cul::Update<cul::Position> inaccurate_fix = reference_position_update;
+    inaccurate_fix.value.accuracy.horizontal = 100. * cul::units::Meters;
+
+    auto server = [this, &sync_start, inaccurate_fix]()
+    {
+        SCOPED_TRACE("Server");
+
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        auto incoming = session_bus();
+        auto outgoing = session_bus();
+
+        incoming->install_executor(core::dbus::asio::make_executor(incoming));
+        outgoing->install_executor(core::dbus::asio::make_executor(outgoing));
+
+        auto dummy = new DummyProvider();
+        cul::Provider::Ptr helper(dummy);
+
+        cul::service::DefaultConfiguration config;
+        cul::service::Implementation::Configuration configuration
+        {
+            incoming,
+            outgoing,
+            config.the_engine(config.the_provider_set(helper), config.the_provider_selection_policy(), null_settings()),
+            config.the_permission_manager(incoming),
+            cul::service::Harvester::Configuration
+            {
+                cul::connectivity::platform_default_manager(),
+                std::make_shared<NullReporter>()
+            }
+        };
+        auto location_service = std::make_shared<cul::service::Implementation>(configuration);
+
+        std::thread t1{[incoming](){incoming->run();}};
+        std::thread t2{[outgoing](){outgoing->run();}};
+
+        std::atomic<bool> injecting{true};
+        std::thread injector{[dummy, &injecting, inaccurate_fix]()
+        {
+            while (injecting)
+            {
+                auto fix = inaccurate_fix;
+                fix.when = cul::Clock::now();
+                dummy->inject_update(fix);
+                std::this_thread::sleep_for(std::chrono::milliseconds{50});
+            }
+        }};
+
+        sync_start.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        trap->run();
+
+        injecting = false;
+        if (injector.joinable())
+            injector.join();
+
+        incoming->stop();
+        outgoing->stop();
+
+        if (t1.joinable())
+            t1.join();
+
+        if (t2.joinable())
+            t2.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure : core::posix::exit::Status::success;
+    };
+
+    auto client = [this, &sync_start]()
+    {
+        SCOPED_TRACE("Client");
+
+        EXPECT_EQ(1, sync_start.wait_for_signal_ready_for(std::chrono::milliseconds{500}));
+
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+        std::thread t{[bus](){bus->run();}};
+
+        auto location_service = dbus::resolve_service_on_bus<
+            cul::service::Interface,
+            cul::service::Stub>(bus);
+
+        auto then = std::chrono::steady_clock::now();
+        auto fix = location_service->request_single_fix(cul::Criteria{}, 10. * cul::units::Meters, timeout);
+        auto elapsed = std::chrono::steady_clock::now() - then;
+
+        // No fix satisfied the accuracy, the service held on to the session until the timeout expired.
+        EXPECT_GE(elapsed, timeout);
+        EXPECT_TRUE(fix.value.accuracy.horizontal);
+        if (fix.value.accuracy.horizontal)
+            EXPECT_EQ(100. * cul::units::Meters, *fix.value.accuracy.horizontal);
+
+        bus->stop();
+
+        if (t.joinable())
+            t.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure : core::posix::exit::Status::success;
+    };
+
+    EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(server, client));
+}
+
+TEST_F(LocationServiceStandalone, SingleFixFailsIfNoFixArrivesWithinTheTimeout)
+{
+    EXPECT_TRUE(trust_store_is_set_up_for_testing);
+
+    core::testing::CrossProcessSync sync_start;
+
+    auto server = [this, &sync_start]()
+    {
+        SCOPED_TRACE("Server");
+
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        auto incoming = session_bus();
+        auto outgoing = session_bus();
+
+        incoming->install_executor(core::dbus::asio::make_executor(incoming));
+        outgoing->install_executor(core::dbus::asio::make_executor(outgoing));
+
+        // The provider never delivers a fix.
+        cul::Provider::Ptr helper(new DummyProvider());
+
+        cul::service::DefaultConfiguration config;
+        cul::service::Implementation::Configuration configuration
+        {
+            incoming,
+            outgoing,
+            config.the_engine(config.the_provider_set(helper), config.the_provider_selection_policy(), null_settings()),
+            config.the_permission_manager(incoming),
+            cul::service::Harvester::Configuration
+            {
+                cul::connectivity::platform_default_manager(),
+                std::make_shared<NullReporter>()
+            }
+        };
+        auto location_service = std::make_shared<cul::service::Implementation>(configuration);
+
+        std::thread t1{[incoming](){incoming->run();}};
+        std::thread t2{[outgoing](){outgoing->run();}};
+
+        sync_start.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        trap->run();
+
+        incoming->stop();
+        outgoing->stop();
+
+        if (t1.joinable())
+            t1.join();
+
+        if (t2.joinable())
+            t2.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure : core::posix::exit::Status::success;
+    };
+
+    auto client = [this, &sync_start]()
+    {
+        SCOPED_TRACE("Client");
+
+        EXPECT_EQ(1, sync_start.wait_for_signal_ready_for(std::chrono::milliseconds{500}));
+
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+        std::thread t{[bus](){bus->run();}};
+
+        auto location_service = dbus::resolve_service_on_bus<
+            cul::service::Interface,
+            cul::service::Stub>(bus);
+
+        EXPECT_THROW(location_service->request_single_fix(
+                         cul::Criteria{},
+                         10. * cul::units::Meters,
+                         std::chrono::milliseconds{500}),
+                     std::runtime_error);
+
+        bus->stop();
+
+        if (t.joinable())
+            t.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure : core::posix::exit::Status::success;
+    };
+
+    EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(server, client));
+}
+
+TEST_F(LocationServiceStandalone, LastKnownPositionIsAnsweredWithItsAge)
+{
+    EXPECT_TRUE(trust_store_is_set_up_for_testing);
+
+    core::testing::CrossProcessSync sync_start;
+
+    static const std::chrono::seconds age{2};
+
+    auto server = [this, &sync_start]()
+    {
+        SCOPED_TRACE("Server");
+
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        auto incoming = session_bus();
+        auto outgoing = session_bus();
+
+        incoming->install_executor(core::dbus::asio::make_executor(incoming));
+        outgoing->install_executor(core::dbus::asio::make_executor(outgoing));
+
+        cul::Provider::Ptr helper(new DummyProvider());
+
+        cul::service::DefaultConfiguration config;
+        cul::service::Implementation::Configuration configuration
+        {
+            incoming,
+            outgoing,
+            config.the_engine(config.the_provider_set(helper), config.the_provider_selection_policy(), null_settings()),
+            config.the_permission_manager(incoming),
+            cul::service::Harvester::Configuration
+            {
+                cul::connectivity::platform_default_manager(),
+                std::make_shared<NullReporter>()
+            }
+        };
+        auto location_service = std::make_shared<cul::service::Implementation>(configuration);
+
+        // The service answers from the engine's cache, no provider is started.
+        auto fix = reference_position_update;
+        fix.when = cul::Clock::now() - age;
+        configuration.engine->updates.last_known_location.set(fix);
+
+        std::thread t1{[incoming](){incoming->run();}};
+        std::thread t2{[outgoing](){outgoing->run();}};
+
+        sync_start.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        trap->run();
+
+        incoming->stop();
+        outgoing->stop();
+
+        if (t1.joinable())
+            t1.join();
+
+        if (t2.joinable())
+            t2.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure : core::posix::exit::Status::success;
+    };
+
+    auto client = [this, &sync_start]()
+    {
+        SCOPED_TRACE("Client");
+
+        EXPECT_EQ(1, sync_start.wait_for_signal_ready_for(std::chrono::milliseconds{500}));
+
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+        std::thread t{[bus](){bus->run();}};
+
+        auto location_service = dbus::resolve_service_on_bus<
+            cul::service::Interface,
+            cul::service::Stub>(bus);
+
+        auto result = location_service->last_known_position();
+
+        EXPECT_EQ(reference_position_update.value, std::get<0>(result).value);
+        // The age is measured when answering, and thus at least as old as the fix was when set.
+        EXPECT_LE(std::chrono::duration_cast<std::chrono::milliseconds>(age).count(), std::get<1>(result).count());
+        EXPECT_GT(std::chrono::duration_cast<std::chrono::milliseconds>(age + std::chrono::seconds{10}).count(), std::get<1>(result).count());
+
+        bus->stop();
+
+        if (t.joinable())
+            t.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure : core::posix::exit::Status::success;
+    };
+
+    EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(server, client));
+}
+
+TEST_F(LocationServiceStandalone, LastKnownPositionFailsIfNoFixIsKnown)
+{
+    EXPECT_TRUE(trust_store_is_set_up_for_testing);
+
+    core::testing::CrossProcessSync sync_start;
+
+    auto server = [this, &sync_start]()
+    {
+        SCOPED_TRACE("Server");
+
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        auto incoming = session_bus();
+        auto outgoing = session_bus();
+
+        incoming->install_executor(core::dbus::asio::make_executor(incoming));
+        outgoing->install_executor(core::dbus::asio::make_executor(outgoing));
+
+        cul::Provider::Ptr helper(new DummyProvider());
+
+        cul::service::DefaultConfiguration config;
+        cul::service::Implementation::Configuration configuration
+        {
+            incoming,
+            outgoing,
+            config.the_engine(config.the_provider_set(helper), config.the_provider_selection_policy(), null_settings()),
+            config.the_permission_manager(incoming),
+            cul::service::Harvester::Configuration
+            {
+                cul::connectivity::platform_default_manager(),
+                std::make_shared<NullReporter>()
+            }
+        };
+        auto location_service = std::make_shared<cul::service::Implementation>(configuration);
+
+        std::thread t1{[incoming](){incoming->run();}};
+        std::thread t2{[outgoing](){outgoing->run();}};
+
+        sync_start.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        trap->run();
+
+        incoming->stop();
+        outgoing->stop();
+
+        if (t1.joinable())
+            t1.join();
+
+        if (t2.joinable())
+            t2.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure : core::posix::exit::Status::success;
+    };
+
+    auto client = [this, &sync_start]()
+    {
+        SCOPED_TRACE("Client");
+
+        EXPECT_EQ(1, sync_start.wait_for_signal_ready_for(std::chrono::milliseconds{500}));
+
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+        std::thread t{[bus](){bus->run();}};
+
+        auto location_service = dbus::resolve_service_on_bus<
+            cul::service::Interface,
+            cul::service::Stub>(bus);
+
+        EXPECT_THROW(location_service->last_known_position(), std::runtime_error);
+
+        bus->stop();
+
+        if (t.joinable())
+            t.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure : core::posix::exit::Status::success;
+    };
+
+    EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(server, client));
+}
+
 namespace
 {
 struct LocationServiceStandaloneLoad : public LocationServiceStandalone
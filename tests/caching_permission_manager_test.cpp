@@ -0,0 +1,184 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <com/ubuntu/location/service/caching_permission_manager.h>
+
+#include <com/ubuntu/location/criteria.h>
+
+#include <gmock/gmock.h>
+
+#include <thread>
+
+#include <unistd.h>
+
+namespace location = com::ubuntu::location;
+namespace service = com::ubuntu::location::service;
+
+namespace
+{
+struct MockPermissionManager : public service::PermissionManager
+{
+    MOCK_METHOD2(check_permission_for_credentials,
+                 service::PermissionManager::Result(const location::Criteria&, const service::Credentials&));
+};
+
+// Resolves credentials to a key with a start time of pid, for simulating recycled pids.
+service::CachingPermissionManager::KeyResolver start_time_of_pid_key_resolver()
+{
+    return [](const service::Credentials& credentials)
+    {
+        return service::CachingPermissionManager::Key
+        {
+            credentials.uid,
+            static_cast<std::uint64_t>(credentials.pid),
+            "com.ubuntu.test_app"
+        };
+    };
+}
+}
+
+TEST(CachingPermissionManager, cannot_decorate_null_permission_manager)
+{
+    EXPECT_ANY_THROW(service::CachingPermissionManager{service::PermissionManager::Ptr{}});
+}
+
+TEST(CachingPermissionManager, decisions_are_remembered_for_the_same_process)
+{
+    using namespace ::testing;
+
+    auto impl = std::make_shared<MockPermissionManager>();
+    EXPECT_CALL(*impl, check_permission_for_credentials(_, _))
+            .Times(1)
+            .WillRepeatedly(Return(service::PermissionManager::Result::granted));
+
+    service::CachingPermissionManager pm{impl, start_time_of_pid_key_resolver()};
+    service::Credentials credentials{42, 1000};
+
+    EXPECT_FALSE(pm.cached_permission_for_credentials(credentials).is_initialized());
+
+    for (unsigned int i = 0; i < 3; i++)
+        EXPECT_EQ(service::PermissionManager::Result::granted,
+                  pm.check_permission_for_credentials(location::Criteria{}, credentials));
+
+    EXPECT_EQ(service::PermissionManager::Result::granted,
+              *pm.cached_permission_for_credentials(credentials));
+
+    EXPECT_EQ(3u, pm.statistics().hits.load());
+    EXPECT_EQ(1u, pm.statistics().misses.load());
+}
+
+TEST(CachingPermissionManager, decisions_are_not_shared_across_processes)
+{
+    using namespace ::testing;
+
+    auto impl = std::make_shared<MockPermissionManager>();
+    EXPECT_CALL(*impl, check_permission_for_credentials(_, _))
+            .Times(2)
+            .WillOnce(Return(service::PermissionManager::Result::granted))
+            .WillOnce(Return(service::PermissionManager::Result::rejected));
+
+    service::CachingPermissionManager pm{impl, start_time_of_pid_key_resolver()};
+
+    EXPECT_EQ(service::PermissionManager::Result::granted,
+              pm.check_permission_for_credentials(location::Criteria{}, service::Credentials{42, 1000}));
+    EXPECT_EQ(service::PermissionManager::Result::rejected,
+              pm.check_permission_for_credentials(location::Criteria{}, service::Credentials{43, 1000}));
+}
+
+TEST(CachingPermissionManager, decisions_expire_after_lifetime)
+{
+    using namespace ::testing;
+
+    auto impl = std::make_shared<MockPermissionManager>();
+    EXPECT_CALL(*impl, check_permission_for_credentials(_, _))
+            .Times(2)
+            .WillRepeatedly(Return(service::PermissionManager::Result::granted));
+
+    service::CachingPermissionManager pm{impl, start_time_of_pid_key_resolver(), std::chrono::milliseconds{10}};
+    service::Credentials credentials{42, 1000};
+
+    pm.check_permission_for_credentials(location::Criteria{}, credentials);
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+
+    EXPECT_FALSE(pm.cached_permission_for_credentials(credentials).is_initialized());
+    pm.check_permission_for_credentials(location::Criteria{}, credentials);
+}
+
+TEST(CachingPermissionManager, decisions_are_not_cached_for_unresolvable_processes)
+{
+    using namespace ::testing;
+
+    auto impl = std::make_shared<MockPermissionManager>();
+    EXPECT_CALL(*impl, check_permission_for_credentials(_, _))
+            .Times(2)
+            .WillRepeatedly(Return(service::PermissionManager::Result::rejected));
+
+    service::CachingPermissionManager pm
+    {
+        impl,
+        [](const service::Credentials&) -> service::CachingPermissionManager::Key
+        {
+            throw std::runtime_error{"No such process"};
+        }
+    };
+
+    service::Credentials credentials{42, 1000};
+    pm.check_permission_for_credentials(location::Criteria{}, credentials);
+    pm.check_permission_for_credentials(location::Criteria{}, credentials);
+}
+
+TEST(CachingPermissionManager, decisions_are_not_cached_if_the_process_is_replaced_while_pending)
+{
+    using namespace ::testing;
+
+    auto impl = std::make_shared<MockPermissionManager>();
+    EXPECT_CALL(*impl, check_permission_for_credentials(_, _))
+            .Times(2)
+            .WillRepeatedly(Return(service::PermissionManager::Result::granted));
+
+    // The process exits and a new one reuses its pid while the decision is pending.
+    unsigned int resolutions{0};
+    service::CachingPermissionManager pm
+    {
+        impl,
+        [&resolutions](const service::Credentials& credentials)
+        {
+            return service::CachingPermissionManager::Key
+            {
+                credentials.uid,
+                resolutions++ == 0 ? 1 : 2,
+                "com.ubuntu.test_app"
+            };
+        }
+    };
+
+    service::Credentials credentials{42, 1000};
+    pm.check_permission_for_credentials(location::Criteria{}, credentials);
+    pm.check_permission_for_credentials(location::Criteria{}, credentials);
+
+    EXPECT_EQ(0u, pm.statistics().hits.load());
+}
+
+TEST(CachingPermissionManager, proc_key_resolver_resolves_own_process)
+{
+    auto resolver = service::CachingPermissionManager::proc_key_resolver();
+
+    auto key = resolver(service::Credentials{getpid(), getuid()});
+
+    EXPECT_EQ(getuid(), std::get<0>(key));
+    EXPECT_LT(0u, std::get<1>(key));
+    EXPECT_EQ(std::get<1>(key), std::get<1>(resolver(service::Credentials{getpid(), getuid()})));
+}
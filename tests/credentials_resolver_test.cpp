@@ -0,0 +1,187 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <com/ubuntu/location/service/skeleton.h>
+
+#include <core/dbus/bus.h>
+#include <core/dbus/fixture.h>
+#include <core/dbus/message.h>
+
+#include <core/dbus/asio/executor.h>
+
+#include <dbus/dbus.h>
+
+#include <gtest/gtest.h>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace culs = com::ubuntu::location::service;
+
+namespace
+{
+struct DBusDaemonCredentialsResolver : public core::dbus::testing::Fixture
+{
+};
+
+// Executes the given bus on a background thread for the lifetime of the instance.
+struct RunningBus
+{
+    RunningBus(const core::dbus::Bus::Ptr& bus) : bus{bus}
+    {
+        bus->install_executor(core::dbus::asio::make_executor(bus));
+        worker = std::thread{[bus]() { bus->run(); }};
+    }
+
+    ~RunningBus()
+    {
+        bus->stop();
+
+        if (worker.joinable())
+            worker.join();
+    }
+
+    core::dbus::Bus::Ptr bus;
+    std::thread worker;
+};
+
+std::string unique_name_of(const core::dbus::Bus::Ptr& bus)
+{
+    return dbus_bus_get_unique_name(bus->raw());
+}
+
+// Creates a message that looks like it has been sent by sender.
+core::dbus::Message::Ptr message_from(const std::string& sender)
+{
+    auto msg = core::dbus::Message::make_method_call(
+                "com.ubuntu.location.Service",
+                core::dbus::types::ObjectPath{"/com/ubuntu/location/Service"},
+                "com.ubuntu.location.Service",
+                "CreateSessionForCriteria");
+    dbus_message_set_sender(msg->get(), sender.c_str());
+    return msg;
+}
+
+// Returns true iff predicate becomes true within timeout.
+bool becomes_true_within(const std::function<bool()>& predicate, const std::chrono::milliseconds& timeout)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        if (predicate())
+            return true;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    return predicate();
+}
+}
+
+TEST_F(DBusDaemonCredentialsResolver, credentials_are_resolved_once_per_peer)
+{
+    auto bus = session_bus();
+    RunningBus running{bus};
+
+    auto peer = session_bus();
+    auto msg = message_from(unique_name_of(peer));
+
+    culs::Skeleton::DBusDaemonCredentialsResolver resolver{bus};
+
+    auto first = resolver.resolve_credentials_for_incoming_message(msg);
+    auto second = resolver.resolve_credentials_for_incoming_message(msg);
+
+    EXPECT_EQ(::getpid(), first.pid);
+    EXPECT_EQ(::getuid(), first.uid);
+    EXPECT_EQ(first.pid, second.pid);
+    EXPECT_EQ(first.uid, second.uid);
+
+    EXPECT_EQ(1u, resolver.stats.misses.load());
+    EXPECT_EQ(1u, resolver.stats.hits.load());
+    EXPECT_TRUE(resolver.has_cached_credentials_for_name(unique_name_of(peer)));
+}
+
+TEST_F(DBusDaemonCredentialsResolver, cached_credentials_are_evicted_once_the_peer_leaves_the_bus)
+{
+    auto bus = session_bus();
+    RunningBus running{bus};
+
+    auto peer = session_bus();
+    auto name = unique_name_of(peer);
+
+    culs::Skeleton::DBusDaemonCredentialsResolver resolver{bus};
+    resolver.resolve_credentials_for_incoming_message(message_from(name));
+    ASSERT_TRUE(resolver.has_cached_credentials_for_name(name));
+
+    dbus_connection_close(peer->raw());
+
+    EXPECT_TRUE(becomes_true_within([&resolver, name]()
+    {
+        return not resolver.has_cached_credentials_for_name(name);
+    }, std::chrono::seconds{5}));
+}
+
+TEST_F(DBusDaemonCredentialsResolver, credentials_of_a_peer_leaving_while_being_resolved_are_not_cached)
+{
+    auto bus = session_bus();
+    RunningBus running{bus};
+
+    auto peer = session_bus();
+    auto name = unique_name_of(peer);
+    // Leaves the bus after peer, and the dbus daemon announces both in order.
+    auto sentinel = session_bus();
+    auto sentinel_name = unique_name_of(sentinel);
+
+    culs::Skeleton::DBusDaemonCredentialsResolver resolver{bus};
+    resolver.resolve_credentials_for_incoming_message(message_from(sentinel_name));
+    ASSERT_TRUE(resolver.has_cached_credentials_for_name(sentinel_name));
+
+    auto generation = resolver.reserve_cache_entry_for_name(name);
+
+    // The peer leaves while we are still resolving its credentials.
+    dbus_connection_close(peer->raw());
+    dbus_connection_close(sentinel->raw());
+    ASSERT_TRUE(becomes_true_within([&resolver, sentinel_name]()
+    {
+        return not resolver.has_cached_credentials_for_name(sentinel_name);
+    }, std::chrono::seconds{5}));
+
+    EXPECT_FALSE(resolver.cache_credentials_for_name(name, generation, culs::Credentials{::getpid(), ::getuid()}));
+    EXPECT_FALSE(resolver.has_cached_credentials_for_name(name));
+}
+
+TEST_F(DBusDaemonCredentialsResolver, only_the_most_recent_pending_entry_is_cached)
+{
+    auto bus = session_bus();
+    RunningBus running{bus};
+
+    auto peer = session_bus();
+    auto name = unique_name_of(peer);
+
+    culs::Skeleton::DBusDaemonCredentialsResolver resolver{bus};
+
+    auto first = resolver.reserve_cache_entry_for_name(name);
+    auto second = resolver.reserve_cache_entry_for_name(name);
+
+    EXPECT_FALSE(resolver.has_cached_credentials_for_name(name));
+    EXPECT_FALSE(resolver.cache_credentials_for_name(name, first, culs::Credentials{::getpid(), ::getuid()}));
+    EXPECT_TRUE(resolver.cache_credentials_for_name(name, second, culs::Credentials{::getpid(), ::getuid()}));
+    EXPECT_TRUE(resolver.has_cached_credentials_for_name(name));
+}
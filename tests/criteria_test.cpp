@@ -48,3 +48,22 @@ TEST(Criteria, AddedUpCriteriaSatisfiesAllIndividualCriteria)
     // EXPECT_TRUE(added_up_criteria.satisfies(c2));
     // EXPECT_TRUE(added_up_criteria.satisfies(c3));
 }
+
+TEST(Criteria, AddingUpCriteriaKeepsTheLeastRestrictiveUpdateFilter)
+{
+    location::Criteria c1, c2, c3;
+
+    c1.updates.interval = std::chrono::milliseconds{5000};
+    c1.updates.displacement = 100 * location::units::Meters;
+    c2.updates.interval = std::chrono::milliseconds{1000};
+    c2.updates.displacement = 500 * location::units::Meters;
+
+    auto c = c1 + c2;
+    EXPECT_EQ(std::chrono::milliseconds{1000}, *c.updates.interval);
+    EXPECT_EQ(100 * location::units::Meters, *c.updates.displacement);
+
+    // c3 wants all updates.
+    c = c1 + c3;
+    EXPECT_FALSE(c.updates.interval);
+    EXPECT_FALSE(c.updates.displacement);
+}
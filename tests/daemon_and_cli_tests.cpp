@@ -34,6 +34,7 @@
 
 #include "mock_engine.h"
 
+#include <chrono>
 #include <ctime>
 
 #include <thread>
@@ -313,3 +314,28 @@ TEST(Daemon, MultipleProviderLoadingWorks)
 
     location::service::Daemon::load_providers(config, engine);
 }
+
+TEST(Daemon, ProviderLoadingDoesNotBlockOnSlowProviders)
+{
+    const char* args[] =
+    {
+        "--bus", "session",
+        "--provider", "dummy::Provider",
+        "--provider", "dummy::DelayedProvider",
+        "--dummy::DelayedProvider::DelayInMs=1000"
+    };
+
+    auto config = location::service::Daemon::Configuration::from_command_line_args(7, args, null_dbus_connection_factory);
+    location::service::DefaultConfiguration dc;
+    auto engine = std::make_shared<MockEngine>(dc.the_provider_selection_policy(), config.settings);
+
+    EXPECT_CALL(*engine, add_provider(::testing::_)).Times(2);
+
+    auto then = std::chrono::steady_clock::now();
+    auto pending = location::service::Daemon::load_providers(config, engine);
+    EXPECT_LT(std::chrono::steady_clock::now() - then, std::chrono::milliseconds{500});
+
+    EXPECT_EQ(2u, pending.size());
+    for (auto& load : pending)
+        load.wait();
+}
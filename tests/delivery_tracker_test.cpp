@@ -0,0 +1,101 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <com/ubuntu/location/service/session/delivery_tracker.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace culss = com::ubuntu::location::service::session;
+
+namespace
+{
+culss::Skeleton::Limits limits()
+{
+    culss::Skeleton::Limits limits;
+    limits.max_outstanding_updates = 2;
+    limits.max_consecutive_failures = 2;
+    limits.max_latency = std::chrono::milliseconds{100};
+    limits.probe_interval = 3;
+    return limits;
+}
+}
+
+TEST(DeliveryTracker, drops_oldest_update_if_too_many_are_outstanding)
+{
+    auto statistics = std::make_shared<culss::Skeleton::Statistics>();
+    culss::DeliveryTracker tracker{limits(), statistics};
+
+    std::vector<int> cancelled;
+    auto first = tracker.sent([&cancelled]() { cancelled.push_back(0); });
+    tracker.sent([&cancelled]() { cancelled.push_back(1); });
+    EXPECT_TRUE(cancelled.empty());
+
+    tracker.sent([&cancelled]() { cancelled.push_back(2); });
+    EXPECT_EQ(std::vector<int>{0}, cancelled);
+    EXPECT_EQ(2u, tracker.outstanding());
+    EXPECT_EQ(1u, statistics->dropped_updates.load());
+
+    // A late reply to a dropped update is ignored.
+    EXPECT_EQ(culss::DeliveryTracker::Verdict::keep, tracker.completed(first, false));
+    EXPECT_EQ(0u, statistics->failed_updates.load());
+}
+
+TEST(DeliveryTracker, evicts_session_exceeding_failure_budget_once)
+{
+    auto statistics = std::make_shared<culss::Skeleton::Statistics>();
+    culss::DeliveryTracker tracker{limits(), statistics};
+
+    EXPECT_EQ(culss::DeliveryTracker::Verdict::keep, tracker.completed(tracker.sent([](){}), false));
+    EXPECT_EQ(culss::DeliveryTracker::Verdict::keep, tracker.completed(tracker.sent([](){}), true));
+    EXPECT_EQ(culss::DeliveryTracker::Verdict::keep, tracker.completed(tracker.sent([](){}), false));
+    EXPECT_EQ(culss::DeliveryTracker::Verdict::evict_for_failures, tracker.completed(tracker.sent([](){}), false));
+    EXPECT_EQ(culss::DeliveryTracker::Verdict::keep, tracker.completed(tracker.sent([](){}), false));
+
+    EXPECT_EQ(4u, statistics->failed_updates.load());
+    EXPECT_EQ(1u, statistics->evicted_for_failures.load());
+    EXPECT_EQ(0u, statistics->evicted_for_latency.load());
+}
+
+TEST(DeliveryTracker, evicts_session_exceeding_latency_budget)
+{
+    auto statistics = std::make_shared<culss::Skeleton::Statistics>();
+    culss::DeliveryTracker tracker{limits(), statistics};
+
+    auto t = std::chrono::steady_clock::now();
+
+    // A single slow reply is smoothed out.
+    EXPECT_EQ(culss::DeliveryTracker::Verdict::keep, tracker.completed(tracker.sent([](){}, t), true, t + std::chrono::milliseconds{10}));
+    EXPECT_EQ(culss::DeliveryTracker::Verdict::keep, tracker.completed(tracker.sent([](){}, t), true, t + std::chrono::milliseconds{500}));
+
+    auto verdict = culss::DeliveryTracker::Verdict::keep;
+    for (int i = 0; i < 20 && verdict == culss::DeliveryTracker::Verdict::keep; i++)
+        verdict = tracker.completed(tracker.sent([](){}, t), true, t + std::chrono::milliseconds{500});
+
+    EXPECT_EQ(culss::DeliveryTracker::Verdict::evict_for_latency, verdict);
+    EXPECT_EQ(1u, statistics->evicted_for_latency.load());
+}
+
+TEST(DeliveryTracker, probes_every_nth_update)
+{
+    auto statistics = std::make_shared<culss::Skeleton::Statistics>();
+    culss::DeliveryTracker tracker{limits(), statistics};
+
+    EXPECT_FALSE(tracker.is_probe_due());
+    EXPECT_FALSE(tracker.is_probe_due());
+    EXPECT_TRUE(tracker.is_probe_due());
+    EXPECT_FALSE(tracker.is_probe_due());
+}
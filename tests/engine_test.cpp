@@ -17,6 +17,7 @@
  */
 
 #include <com/ubuntu/location/engine.h>
+#include <com/ubuntu/location/fusion_provider_selection_policy.h>
 #include <com/ubuntu/location/provider.h>
 #include <com/ubuntu/location/provider_selection_policy.h>
 
@@ -25,6 +26,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <condition_variable>
+#include <mutex>
+
 namespace location = com::ubuntu::location;
 
 namespace
@@ -35,6 +39,10 @@ struct MockProvider : public location::Provider
     {
     }
 
+    explicit MockProvider(const location::Provider::Features& features) : location::Provider(features)
+    {
+    }
+
     MOCK_CONST_METHOD1(requires, bool(const location::Provider::Requirements&));
 
     MOCK_METHOD0(disable, void());
@@ -52,6 +60,10 @@ struct MockProvider : public location::Provider
     MOCK_METHOD1(on_reference_velocity_updated,
                  void(const location::Update<location::Velocity>&));
 
+    // Enables tests to inject updates.
+    using location::Provider::mutable_updates;
+    // Enables tests to toggle availability.
+    using location::Provider::mutable_available;
 };
 
 struct MockSettings : public location::Settings
@@ -79,6 +91,290 @@ TEST(Engine, adding_a_null_provider_throws)
     EXPECT_ANY_THROW(engine.add_provider(location::Provider::Ptr {}););
 }
 
+TEST(Engine, adding_a_provider_while_enumerating_providers_does_not_alter_ongoing_enumeration)
+{
+    using namespace ::testing;
+
+    location::Engine engine {std::make_shared<NullProviderSelectionPolicy>(), mock_settings()};
+    engine.add_provider(std::make_shared<NiceMock<MockProvider>>());
+
+    std::size_t enumerated{0};
+    engine.for_each_provider([&engine, &enumerated](const location::Provider::Ptr&)
+    {
+        enumerated++;
+        engine.add_provider(std::make_shared<NiceMock<MockProvider>>());
+    });
+
+    EXPECT_EQ(1u, enumerated);
+
+    enumerated = 0;
+    engine.for_each_provider([&enumerated](const location::Provider::Ptr&)
+    {
+        enumerated++;
+    });
+
+    EXPECT_EQ(2u, enumerated);
+}
+
+TEST(Engine, provider_events_are_handled_on_the_dispatcher)
+{
+    using namespace ::testing;
+
+    std::vector<std::function<void()>> tasks;
+    location::Engine engine
+    {
+        std::make_shared<NullProviderSelectionPolicy>(),
+        mock_settings(),
+        [&tasks](std::function<void()> task) { tasks.push_back(task); }
+    };
+
+    auto provider = std::make_shared<NiceMock<MockProvider>>();
+    engine.add_provider(provider);
+
+    location::Update<location::Position> update
+    {
+        location::Position
+        {
+            location::wgs84::Latitude{9. * location::units::Degrees},
+            location::wgs84::Longitude{53. * location::units::Degrees}
+        }
+    };
+    // Sessions receive updates via the fusion stage, which must not see them on the provider's thread.
+    unsigned int delivered{0};
+    auto fusion = engine.shared_fusion_provider();
+    fusion->updates().position.connect([&delivered](const location::Update<location::Position>&)
+    {
+        delivered++;
+    });
+
+    provider->mutable_updates().position(update);
+
+    EXPECT_FALSE(engine.updates.last_known_location.get());
+    EXPECT_EQ(0u, delivered);
+    ASSERT_EQ(1u, tasks.size());
+
+    tasks.front()();
+    EXPECT_EQ(update, *engine.updates.last_known_location.get());
+    EXPECT_EQ(1u, delivered);
+}
+
+TEST(Engine, provider_events_pending_on_the_dispatcher_are_skipped_once_the_engine_is_gone)
+{
+    using namespace ::testing;
+
+    std::vector<std::function<void()>> tasks;
+    auto provider = std::make_shared<NiceMock<MockProvider>>();
+
+    {
+        location::Engine engine
+        {
+            std::make_shared<NullProviderSelectionPolicy>(),
+            mock_settings(),
+            [&tasks](std::function<void()> task) { tasks.push_back(task); }
+        };
+
+        engine.add_provider(provider);
+
+        provider->mutable_updates().position(location::Update<location::Position>{});
+        provider->mutable_updates().svs(location::Update<std::set<location::SpaceVehicle>>{});
+    }
+
+    ASSERT_EQ(2u, tasks.size());
+
+    // Would access the destroyed engine and its providers if not skipped.
+    for (const auto& task : tasks)
+        task();
+}
+
+TEST(Engine, providers_outliving_the_engine_do_not_dispatch_to_it)
+{
+    using namespace ::testing;
+
+    std::vector<std::function<void()>> tasks;
+    auto provider = std::make_shared<NiceMock<MockProvider>>();
+    location::Provider::Ptr tracked;
+
+    {
+        location::Engine engine
+        {
+            std::make_shared<NullProviderSelectionPolicy>(),
+            mock_settings(),
+            [&tasks](std::function<void()> task) { tasks.push_back(task); }
+        };
+
+        engine.add_provider(provider);
+
+        // Sessions keep the engine's providers alive beyond the engine's lifetime.
+        engine.for_each_provider([&tracked](const location::Provider::Ptr& p)
+        {
+            tracked = p;
+        });
+    }
+
+    // Would access the destroyed engine if the provider referred back to it.
+    provider->mutable_updates().position(location::Update<location::Position>{});
+
+    ASSERT_EQ(1u, tasks.size());
+    tasks.front()();
+}
+
+TEST(Engine, position_batches_update_the_last_known_location_once)
+{
+    using namespace ::testing;
+
+    location::Engine engine{std::make_shared<NullProviderSelectionPolicy>(), mock_settings()};
+
+    auto provider = std::make_shared<NiceMock<MockProvider>>();
+    engine.add_provider(provider);
+
+    unsigned int changes = 0;
+    engine.updates.last_known_location.changed().connect([&changes](const location::Optional<location::Update<location::Position>>&)
+    {
+        changes++;
+    });
+
+    auto t0 = location::Clock::now();
+    std::vector<location::Update<location::Position>> batch;
+    for (unsigned int i = 0; i < 5; i++)
+        batch.push_back(location::Update<location::Position>
+        {
+            location::Position
+            {
+                location::wgs84::Latitude{9. * location::units::Degrees},
+                location::wgs84::Longitude{(53. + i * 0.001) * location::units::Degrees}
+            },
+            t0 + std::chrono::seconds{i}
+        });
+
+    provider->mutable_updates().position_batch(batch);
+
+    EXPECT_EQ(1u, changes);
+    EXPECT_EQ(batch.back(), *engine.updates.last_known_location.get());
+}
+
+TEST(Engine, provider_statistics_cover_all_known_providers)
+{
+    using namespace ::testing;
+
+    location::Engine engine{std::make_shared<NullProviderSelectionPolicy>(), mock_settings()};
+
+    auto impl = std::make_shared<NiceMock<MockProvider>>();
+    engine.add_provider(impl);
+
+    location::Provider::Ptr provider;
+    engine.for_each_provider([&provider](const location::Provider::Ptr& p) { provider = p; });
+    ASSERT_TRUE(provider != nullptr);
+
+    provider->state_controller()->start_position_updates();
+    impl->mutable_updates().position(location::Update<location::Position>
+    {
+        location::Position
+        {
+            location::wgs84::Latitude{9. * location::units::Degrees},
+            location::wgs84::Longitude{53. * location::units::Degrees}
+        }
+    });
+    provider->state_controller()->stop_position_updates();
+
+    auto stats = engine.provider_statistics();
+    ASSERT_EQ(1u, stats.size());
+    EXPECT_EQ(1u, stats.at(provider).starts);
+    EXPECT_EQ(1u, stats.at(provider).first_fixes);
+}
+
+TEST(Engine, velocity_and_heading_updates_are_verified_by_the_update_policy)
+{
+    using namespace ::testing;
+
+    // The default update policy discards updates that are significantly older than the last one.
+    location::Engine engine{std::make_shared<NullProviderSelectionPolicy>(), mock_settings()};
+
+    auto provider = std::make_shared<NiceMock<MockProvider>>();
+    engine.add_provider(provider);
+
+    auto t0 = location::Clock::now();
+    location::Update<location::Velocity> velocity{5. * location::units::MetersPerSecond, t0};
+    location::Update<location::Heading> heading{90. * location::units::Degrees, t0};
+
+    provider->mutable_updates().velocity(velocity);
+    provider->mutable_updates().heading(heading);
+
+    ASSERT_TRUE(engine.updates.last_known_velocity.get().is_initialized());
+    ASSERT_TRUE(engine.updates.last_known_heading.get().is_initialized());
+    EXPECT_EQ(velocity, *engine.updates.last_known_velocity.get());
+    EXPECT_EQ(heading, *engine.updates.last_known_heading.get());
+
+    auto stale = t0 - std::chrono::minutes{10};
+    provider->mutable_updates().velocity(location::Update<location::Velocity>{1. * location::units::MetersPerSecond, stale});
+    provider->mutable_updates().heading(location::Update<location::Heading>{180. * location::units::Degrees, stale});
+
+    EXPECT_EQ(velocity, *engine.updates.last_known_velocity.get());
+    EXPECT_EQ(heading, *engine.updates.last_known_heading.get());
+}
+
+TEST(Engine, space_vehicles_not_reported_within_max_age_are_removed)
+{
+    using namespace ::testing;
+
+    location::Engine engine{std::make_shared<NullProviderSelectionPolicy>(), mock_settings()};
+    engine.configuration.space_vehicle_max_age = std::chrono::seconds{10};
+
+    auto provider = std::make_shared<NiceMock<MockProvider>>();
+    engine.add_provider(provider);
+
+    location::SpaceVehicle sv1; sv1.key.type = location::SpaceVehicle::Type::gps; sv1.key.id = 1;
+    location::SpaceVehicle sv2; sv2.key.type = location::SpaceVehicle::Type::gps; sv2.key.id = 2;
+
+    unsigned int changes = 0;
+    engine.updates.visible_space_vehicles.changed().connect([&changes](const std::map<location::SpaceVehicle::Key, location::SpaceVehicle>&)
+    {
+        changes++;
+    });
+
+    auto t0 = location::Clock::now();
+    provider->mutable_updates().svs(location::Update<std::set<location::SpaceVehicle>>{{sv1, sv2}, t0});
+    EXPECT_EQ(2u, engine.updates.visible_space_vehicles.get().size());
+    EXPECT_EQ(1u, changes);
+
+    // Reporting the very same space vehicles again does not result in a change.
+    provider->mutable_updates().svs(location::Update<std::set<location::SpaceVehicle>>{{sv1, sv2}, t0 + std::chrono::seconds{1}});
+    EXPECT_EQ(1u, changes);
+
+    provider->mutable_updates().svs(location::Update<std::set<location::SpaceVehicle>>{{sv1}, t0 + std::chrono::seconds{12}});
+    EXPECT_EQ(1u, engine.updates.visible_space_vehicles.get().size());
+    EXPECT_EQ(1u, engine.updates.visible_space_vehicles.get().count(sv1.key));
+    EXPECT_EQ(2u, changes);
+}
+
+TEST(Engine, space_vehicles_are_removed_once_stale_without_further_reports)
+{
+    using namespace ::testing;
+
+    location::Engine engine{std::make_shared<NullProviderSelectionPolicy>(), mock_settings()};
+    engine.configuration.space_vehicle_max_age = std::chrono::seconds{1};
+
+    auto provider = std::make_shared<NiceMock<MockProvider>>();
+    engine.add_provider(provider);
+
+    std::mutex guard;
+    std::condition_variable cv;
+    bool empty = false;
+
+    engine.updates.visible_space_vehicles.changed().connect([&](const std::map<location::SpaceVehicle::Key, location::SpaceVehicle>& svs)
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        empty = svs.empty();
+        cv.notify_all();
+    });
+
+    location::SpaceVehicle sv; sv.key.type = location::SpaceVehicle::Type::gps; sv.key.id = 1;
+    provider->mutable_updates().svs(location::Update<std::set<location::SpaceVehicle>>{{sv}, location::Clock::now()});
+    EXPECT_EQ(1u, engine.updates.visible_space_vehicles.get().size());
+
+    std::unique_lock<std::mutex> ul(guard);
+    EXPECT_TRUE(cv.wait_for(ul, std::chrono::seconds{5}, [&empty]() { return empty; }));
+}
+
 namespace
 {
 struct MockProviderSelectionPolicy : public location::ProviderSelectionPolicy
@@ -112,6 +408,7 @@ TEST(Engine, provider_selection_policy_is_invoked_when_matching_providers_to_cri
     EXPECT_CALL(policy, determine_provider_selection_for_criteria(_,_))
             .Times(1)
             .WillOnce(Return(location::ProviderSelection {
+                        location::Provider::Ptr{},
                         location::Provider::Ptr{},
                         location::Provider::Ptr{},
                         location::Provider::Ptr{}}));
@@ -119,10 +416,211 @@ TEST(Engine, provider_selection_policy_is_invoked_when_matching_providers_to_cri
     auto selection = engine.determine_provider_selection_for_criteria(location::Criteria {});
 }
 
+TEST(Engine, sessions_share_a_single_fusion_stage)
+{
+    using namespace ::testing;
+
+    location::Engine engine{std::make_shared<location::FusionProviderSelectionPolicy>(), mock_settings()};
+    engine.add_provider(std::make_shared<NiceMock<MockProvider>>());
+
+    location::Criteria coarse;
+    location::Criteria fine; fine.accuracy.horizontal = 10 * location::units::Meters;
+
+    auto s1 = engine.determine_provider_selection_for_criteria(coarse);
+    auto s2 = engine.determine_provider_selection_for_criteria(fine);
+
+    EXPECT_EQ(s1.position_updates_provider, s2.position_updates_provider);
+    EXPECT_EQ(engine.shared_fusion_provider(), s1.position_updates_provider);
+
+    // Sessions created after adding a provider get a new stage covering it.
+    engine.add_provider(std::make_shared<NiceMock<MockProvider>>());
+    auto s3 = engine.determine_provider_selection_for_criteria(coarse);
+    EXPECT_NE(s1.position_updates_provider, s3.position_updates_provider);
+
+    // The stage is released once no one refers to it anymore.
+    std::weak_ptr<location::Provider> stage{s3.position_updates_provider};
+    s3 = location::ProviderSelection{};
+    engine.add_provider(std::make_shared<NiceMock<MockProvider>>());
+    EXPECT_TRUE(stage.expired());
+}
+
+TEST(Engine, hedging_sessions_share_the_precise_and_coarse_fusion_stages)
+{
+    using namespace ::testing;
+
+    location::Engine engine{std::make_shared<location::FusionProviderSelectionPolicy>(true), mock_settings()};
+
+    auto precise = std::make_shared<NiceMock<MockProvider>>(location::Provider::Features::position);
+    ON_CALL(*precise, requires(location::Provider::Requirements::satellites)).WillByDefault(Return(true));
+    auto coarse = std::make_shared<NiceMock<MockProvider>>(location::Provider::Features::position);
+
+    engine.add_provider(precise);
+    engine.add_provider(coarse);
+
+    location::Criteria wide;
+    location::Criteria fine; fine.accuracy.horizontal = 10 * location::units::Meters;
+
+    auto s1 = engine.determine_provider_selection_for_criteria(wide);
+    auto s2 = engine.determine_provider_selection_for_criteria(fine);
+
+    ASSERT_TRUE(s1.coarse_position_updates_provider != nullptr);
+    EXPECT_NE(s1.position_updates_provider, s1.coarse_position_updates_provider);
+    EXPECT_EQ(s1.position_updates_provider, s2.position_updates_provider);
+    EXPECT_EQ(s1.coarse_position_updates_provider, s2.coarse_position_updates_provider);
+}
+
+TEST(Engine, cached_provider_selections_do_not_keep_the_fusion_stage_alive)
+{
+    using namespace ::testing;
+
+    location::Engine engine{std::make_shared<location::FusionProviderSelectionPolicy>(), mock_settings()};
+    engine.add_provider(std::make_shared<NiceMock<MockProvider>>());
+
+    location::Criteria criteria;
+
+    auto selection = engine.determine_provider_selection_for_criteria(criteria);
+    std::weak_ptr<location::Provider> stage{selection.position_updates_provider};
+
+    // The last session releasing its selection releases the stage, too.
+    selection = location::ProviderSelection{};
+    EXPECT_TRUE(stage.expired());
+
+    // Sessions created afterwards get a new stage instead of the cached one.
+    selection = engine.determine_provider_selection_for_criteria(criteria);
+    EXPECT_TRUE(selection.position_updates_provider != nullptr);
+    EXPECT_EQ(engine.shared_fusion_provider(), selection.position_updates_provider);
+}
+
+TEST(Engine, provider_selections_are_cached_until_invalidated)
+{
+    using namespace ::testing;
+
+    MockProviderSelectionPolicy policy;
+    location::Engine engine
+    {
+        location::ProviderSelectionPolicy::Ptr
+        {
+            &policy,
+            [](location::ProviderSelectionPolicy*) {}
+        },
+        mock_settings()
+    };
+
+    location::Criteria coarse;
+    location::Criteria fine; fine.accuracy.horizontal = 10 * location::units::Meters;
+
+    EXPECT_CALL(policy, determine_provider_selection_for_criteria(_,_))
+            .Times(4)
+            .WillRepeatedly(Return(location::ProviderSelection {
+                        location::Provider::Ptr{},
+                        location::Provider::Ptr{},
+                        location::Provider::Ptr{},
+                        location::Provider::Ptr{}}));
+
+    // One selection per distinct criteria.
+    for (unsigned int i = 0; i < 10; i++)
+    {
+        engine.determine_provider_selection_for_criteria(coarse);
+        engine.determine_provider_selection_for_criteria(fine);
+    }
+
+    // Adding a provider invalidates all cached selections.
+    engine.add_provider(std::make_shared<NiceMock<MockProvider>>());
+    engine.determine_provider_selection_for_criteria(coarse);
+    engine.determine_provider_selection_for_criteria(coarse);
+
+    // As does changing the engine's configuration.
+    engine.configuration.engine_state = location::Engine::Status::off;
+    engine.determine_provider_selection_for_criteria(coarse);
+}
+
+TEST(Engine, provider_selections_are_not_invalidated_by_providers_starting_and_stopping)
+{
+    using namespace ::testing;
+
+    MockProviderSelectionPolicy policy;
+    location::Engine engine
+    {
+        location::ProviderSelectionPolicy::Ptr
+        {
+            &policy,
+            [](location::ProviderSelectionPolicy*) {}
+        },
+        mock_settings()
+    };
+    engine.configuration.provider_linger_period = std::chrono::seconds{0};
+
+    auto provider = std::make_shared<NiceMock<MockProvider>>();
+    engine.add_provider(provider);
+
+    EXPECT_CALL(policy, determine_provider_selection_for_criteria(_,_))
+            .Times(2)
+            .WillRepeatedly(Return(location::ProviderSelection {
+                        location::Provider::Ptr{},
+                        location::Provider::Ptr{},
+                        location::Provider::Ptr{},
+                        location::Provider::Ptr{}}));
+
+    location::Criteria criteria;
+    engine.determine_provider_selection_for_criteria(criteria);
+
+    engine.for_each_provider([](const location::Provider::Ptr& p)
+    {
+        p->state_controller()->start_position_updates();
+        p->state_controller()->stop_position_updates();
+    });
+    engine.determine_provider_selection_for_criteria(criteria);
+
+    // Switching the engine off and back on does invalidate, though.
+    engine.configuration.engine_state = location::Engine::Status::off;
+    engine.configuration.engine_state = location::Engine::Status::on;
+    engine.determine_provider_selection_for_criteria(criteria);
+}
+
+TEST(Engine, provider_selections_are_invalidated_when_provider_availability_changes)
+{
+    using namespace ::testing;
+
+    MockProviderSelectionPolicy policy;
+    location::Engine engine
+    {
+        location::ProviderSelectionPolicy::Ptr
+        {
+            &policy,
+            [](location::ProviderSelectionPolicy*) {}
+        },
+        mock_settings()
+    };
+
+    auto provider = std::make_shared<NiceMock<MockProvider>>();
+    engine.add_provider(provider);
+
+    EXPECT_CALL(policy, determine_provider_selection_for_criteria(_,_))
+            .Times(3)
+            .WillRepeatedly(Return(location::ProviderSelection {
+                        location::Provider::Ptr{},
+                        location::Provider::Ptr{},
+                        location::Provider::Ptr{},
+                        location::Provider::Ptr{}}));
+
+    location::Criteria criteria;
+
+    engine.determine_provider_selection_for_criteria(criteria);
+    engine.determine_provider_selection_for_criteria(criteria);
+
+    provider->mutable_available().set(false);
+    engine.determine_provider_selection_for_criteria(criteria);
+    engine.determine_provider_selection_for_criteria(criteria);
+
+    provider->mutable_available().set(true);
+    engine.determine_provider_selection_for_criteria(criteria);
+}
+
 TEST(Engine, adding_a_provider_creates_connections_to_engine_configuration_properties)
 {
     using namespace ::testing;
     auto provider = std::make_shared<NiceMock<MockProvider>>();
+    ON_CALL(*provider, requires(location::Provider::Requirements::satellites)).WillByDefault(Return(true));
     auto selection_policy = std::make_shared<NiceMock<MockProviderSelectionPolicy>>();
     location::Engine engine{selection_policy, mock_settings()};
     engine.add_provider(provider);
@@ -139,6 +637,24 @@ TEST(Engine, adding_a_provider_creates_connections_to_engine_configuration_prope
     engine.updates.last_known_velocity = location::Update<location::Velocity>{};
 }
 
+TEST(Engine, reference_velocity_and_heading_are_not_handed_to_providers_not_requiring_satellites)
+{
+    using namespace ::testing;
+    auto provider = std::make_shared<NiceMock<MockProvider>>();
+    ON_CALL(*provider, requires(_)).WillByDefault(Return(false));
+    auto selection_policy = std::make_shared<NiceMock<MockProviderSelectionPolicy>>();
+    location::Engine engine{selection_policy, mock_settings()};
+    engine.add_provider(provider);
+
+    EXPECT_CALL(*provider, on_reference_location_updated(_)).Times(1);
+    EXPECT_CALL(*provider, on_reference_heading_updated(_)).Times(0);
+    EXPECT_CALL(*provider, on_reference_velocity_updated(_)).Times(0);
+
+    engine.updates.last_known_location = location::Update<location::Position>{};
+    engine.updates.last_known_heading = location::Update<location::Heading>{};
+    engine.updates.last_known_velocity = location::Update<location::Velocity>{};
+}
+
 /* TODO(tvoss): We have to disable these tests as the MP is being refactored to not break ABI.
  * We have to enable these tests once we enable the ABI-breaking interface adjustments again.
 TEST(Engine, switching_the_engine_off_results_in_providers_being_disabled_and_updates_being_stopped)
@@ -255,6 +771,12 @@ TEST(Engine, reads_state_from_settings_on_construction)
     EXPECT_CALL(*settings, has_value_for_key(_))
             .Times(2)
             .WillRepeatedly(Return(true));
+    EXPECT_CALL(*settings, has_value_for_key(location::Engine::Configuration::Keys::update_policy))
+            .Times(1)
+            .WillRepeatedly(Return(false));
+    EXPECT_CALL(*settings, has_value_for_key(location::Engine::Configuration::Keys::last_known_location))
+            .Times(1)
+            .WillRepeatedly(Return(false));
     EXPECT_CALL(*settings, get_string_for_key_or_throw(
                     location::Engine::Configuration::Keys::wifi_and_cell_id_reporting_state))
             .Times(1)
@@ -288,3 +810,130 @@ TEST(Engine, stores_state_from_settings_on_destruction)
     {location::Engine engine{selection_policy, settings};}
 }
 
+
+TEST(Engine, last_known_location_is_restored_from_settings_and_injected_into_providers)
+{
+    using namespace ::testing;
+
+    auto selection_policy = std::make_shared<NiceMock<MockProviderSelectionPolicy>>();
+
+    location::Position position
+    {
+        location::wgs84::Latitude{9. * location::units::Degrees},
+        location::wgs84::Longitude{53. * location::units::Degrees}
+    };
+    position.accuracy.horizontal = 25. * location::units::Meters;
+
+    std::string persisted;
+
+    {
+        auto settings = std::make_shared<NiceMock<MockSettings>>();
+        EXPECT_CALL(*settings, set_string_for_key(_, _))
+                .WillRepeatedly(Return(true));
+        EXPECT_CALL(*settings, set_string_for_key(location::Engine::Configuration::Keys::last_known_location, _))
+                .Times(AtLeast(1))
+                .WillRepeatedly(DoAll(SaveArg<1>(&persisted), Return(true)));
+
+        location::Engine engine{selection_policy, settings};
+        auto provider = std::make_shared<NiceMock<MockProvider>>();
+        engine.add_provider(provider);
+
+        provider->mutable_updates().position(
+                    location::Update<location::Position>{position, location::Clock::now() - std::chrono::seconds{5}});
+    }
+
+    auto settings = std::make_shared<NiceMock<MockSettings>>();
+    ON_CALL(*settings, has_value_for_key(location::Engine::Configuration::Keys::last_known_location))
+            .WillByDefault(Return(true));
+    ON_CALL(*settings, get_string_for_key_or_throw(location::Engine::Configuration::Keys::last_known_location))
+            .WillByDefault(Return(persisted));
+
+    location::Engine engine{selection_policy, settings};
+
+    ASSERT_TRUE(engine.updates.last_known_location.get().is_initialized());
+    auto restored = *engine.updates.last_known_location.get();
+    EXPECT_NEAR(9., restored.value.latitude.value.value(), 1E-9);
+    EXPECT_NEAR(53., restored.value.longitude.value.value(), 1E-9);
+    ASSERT_TRUE(restored.value.accuracy.horizontal.is_initialized());
+    EXPECT_NEAR(25., restored.value.accuracy.horizontal->value(), 1E-9);
+    // The restored fix keeps its age.
+    EXPECT_GE(location::Clock::now() - restored.when, std::chrono::seconds{5});
+
+    auto provider = std::make_shared<NiceMock<MockProvider>>();
+    EXPECT_CALL(*provider, on_reference_location_updated(restored)).Times(1);
+    engine.add_provider(provider);
+}
+
+TEST(Engine, persisting_the_last_known_location_is_throttled)
+{
+    using namespace ::testing;
+
+    auto settings = std::make_shared<NiceMock<MockSettings>>();
+    ON_CALL(*settings, set_string_for_key(_, _)).WillByDefault(Return(true));
+
+    location::Engine engine{std::make_shared<NullProviderSelectionPolicy>(), settings};
+    auto provider = std::make_shared<NiceMock<MockProvider>>();
+    engine.add_provider(provider);
+
+    auto fix = [](double lon, double accuracy, const location::Clock::Timestamp& when)
+    {
+        location::Position position
+        {
+            location::wgs84::Latitude{9. * location::units::Degrees},
+            location::wgs84::Longitude{lon * location::units::Degrees}
+        };
+        position.accuracy.horizontal = accuracy * location::units::Meters;
+        return location::Update<location::Position>{position, when};
+    };
+
+    auto t0 = location::Clock::now();
+
+    // A stationary 1 Hz receiver results in a single write.
+    EXPECT_CALL(*settings, set_string_for_key(location::Engine::Configuration::Keys::last_known_location, _))
+            .Times(1);
+    for (unsigned int i = 0; i < 20; i++)
+        provider->mutable_updates().position(fix(53. + i * 1E-5, 10., t0 + std::chrono::seconds{i}));
+    Mock::VerifyAndClearExpectations(settings.get());
+
+    // Neither moved nor more accurate, nor is the persisted fix stale.
+    EXPECT_CALL(*settings, set_string_for_key(location::Engine::Configuration::Keys::last_known_location, _))
+            .Times(0);
+    provider->mutable_updates().position(fix(53., 10., t0 + std::chrono::minutes{1}));
+    Mock::VerifyAndClearExpectations(settings.get());
+
+    // Moving by more than a kilometer is persisted once the minimum period has passed.
+    EXPECT_CALL(*settings, set_string_for_key(location::Engine::Configuration::Keys::last_known_location, _))
+            .Times(1);
+    provider->mutable_updates().position(fix(53.01, 10., t0 + std::chrono::minutes{2}));
+    provider->mutable_updates().position(fix(53.02, 10., t0 + std::chrono::minutes{2} + std::chrono::seconds{1}));
+    Mock::VerifyAndClearExpectations(settings.get());
+
+    // A stale persisted fix is replaced regardless.
+    EXPECT_CALL(*settings, set_string_for_key(location::Engine::Configuration::Keys::last_known_location, _))
+            .Times(1);
+    provider->mutable_updates().position(fix(53.01, 10., t0 + std::chrono::minutes{15}));
+    Mock::VerifyAndClearExpectations(settings.get());
+}
+
+TEST(Engine, stale_last_known_location_is_not_restored_from_settings)
+{
+    using namespace ::testing;
+
+    auto selection_policy = std::make_shared<NiceMock<MockProviderSelectionPolicy>>();
+    auto settings = std::make_shared<NiceMock<MockSettings>>();
+
+    auto when = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch() -
+                location::Engine::Configuration::Defaults::last_known_location_max_age -
+                std::chrono::minutes{1});
+
+    std::stringstream ss; ss << "9 53 25 " << when.count();
+    ON_CALL(*settings, has_value_for_key(location::Engine::Configuration::Keys::last_known_location))
+            .WillByDefault(Return(true));
+    ON_CALL(*settings, get_string_for_key_or_throw(location::Engine::Configuration::Keys::last_known_location))
+            .WillByDefault(Return(ss.str()));
+
+    location::Engine engine{selection_policy, settings};
+
+    EXPECT_FALSE(engine.updates.last_known_location.get().is_initialized());
+}
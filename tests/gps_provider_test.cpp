@@ -137,6 +137,7 @@ struct MockHardwareAbstractionLayer : public gps::HardwareAbstractionLayer
     MOCK_METHOD0(stop_positioning, bool());
     MOCK_METHOD1(set_assistance_mode, bool(gps::AssistanceMode));
     MOCK_METHOD1(set_position_mode, bool(gps::PositionMode));
+    MOCK_METHOD1(set_position_interval, bool(const std::chrono::milliseconds&));
     MOCK_METHOD1(inject_reference_position, bool(const location::Position&));
     MOCK_METHOD1(inject_reference_time, bool(const location::providers::gps::HardwareAbstractionLayer::ReferenceTimeSample&));
 
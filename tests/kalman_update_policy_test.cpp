@@ -0,0 +1,236 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <com/ubuntu/location/kalman_update_policy.h>
+#include <com/ubuntu/location/time_based_update_policy.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace cul = com::ubuntu::location;
+
+namespace
+{
+constexpr double radius_of_earth{6371000.};
+
+// A fix at the given offset in [m] east and north of a fixed reference point.
+cul::Update<cul::Position> fix_at(double east, double north, double accuracy, const cul::Clock::Timestamp& when)
+{
+    static constexpr double lat0{53.}, lon0{9.};
+
+    return cul::Update<cul::Position>
+    {
+        cul::Position
+        {
+            cul::wgs84::Latitude{(lat0 + north / radius_of_earth * 180. / M_PI) * cul::units::Degrees},
+            cul::wgs84::Longitude{(lon0 + east / (radius_of_earth * std::cos(lat0 * M_PI / 180.)) * 180. / M_PI) * cul::units::Degrees},
+            cul::wgs84::Altitude{0. * cul::units::Meters},
+            accuracy * cul::units::Meters
+        },
+        when
+    };
+}
+
+double distance(const cul::Update<cul::Position>& lhs, const cul::Update<cul::Position>& rhs)
+{
+    return cul::haversine_distance(lhs.value, rhs.value).value();
+}
+
+// A synthetic drive, sampled at 1 Hz: Straight segments at 15 m/s with a
+// right turn every minute. Fixes carry gaussian noise of 10m, and 2% of them
+// are off by several hundred meters, e.g., as seen with multipath effects.
+struct Replay
+{
+    std::vector<cul::Update<cul::Position>> truth;
+    std::vector<cul::Update<cul::Position>> fixes;
+};
+
+Replay drive(std::size_t n)
+{
+    Replay replay;
+
+    std::mt19937 rng{42};
+    std::normal_distribution<double> noise{0., 10.};
+    std::uniform_real_distribution<double> uniform{0., 1.};
+
+    auto t = cul::Clock::now();
+    double east{0.}, north{0.}, heading{0.}, speed{15.};
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        if (i > 0 && i % 60 == 0)
+            heading += M_PI / 2.;
+
+        east += speed * std::sin(heading);
+        north += speed * std::cos(heading);
+        t += std::chrono::seconds{1};
+
+        replay.truth.push_back(fix_at(east, north, 0., t));
+
+        auto e = east + noise(rng), n = north + noise(rng);
+        if (uniform(rng) < 0.02)
+        {
+            e += 400.;
+            n -= 300.;
+        }
+
+        replay.fixes.push_back(fix_at(e, n, 10., t));
+    }
+
+    return replay;
+}
+}
+
+TEST(KalmanUpdatePolicy, first_fix_is_passed_through)
+{
+    cul::KalmanUpdatePolicy policy;
+
+    auto fix = fix_at(0., 0., 10., cul::Clock::now());
+    EXPECT_EQ(fix, policy.verify_update(fix));
+}
+
+TEST(KalmanUpdatePolicy, estimate_of_stationary_device_converges)
+{
+    cul::KalmanUpdatePolicy policy;
+
+    std::mt19937 rng{42};
+    std::normal_distribution<double> noise{0., 10.};
+
+    auto t = cul::Clock::now();
+    auto truth = fix_at(0., 0., 0., t);
+
+    cul::Update<cul::Position> estimate;
+    for (std::size_t i = 0; i < 60; i++)
+        estimate = policy.verify_update(fix_at(noise(rng), noise(rng), 10., t + std::chrono::seconds{i}));
+
+    EXPECT_LT(distance(truth, estimate), 10.);
+    ASSERT_TRUE(estimate.value.accuracy.horizontal);
+    EXPECT_LT(estimate.value.accuracy.horizontal->value(), 10.);
+}
+
+TEST(KalmanUpdatePolicy, outliers_are_rejected)
+{
+    cul::KalmanUpdatePolicy policy;
+
+    auto t = cul::Clock::now();
+    for (std::size_t i = 0; i < 10; i++)
+        policy.verify_update(fix_at(0., 0., 10., t + std::chrono::seconds{i}));
+
+    auto before = policy.verify_update(fix_at(0., 0., 10., t + std::chrono::seconds{10}));
+    auto after = policy.verify_update(fix_at(5000., 0., 10., t + std::chrono::seconds{11}));
+
+    EXPECT_LT(distance(before, after), 10.);
+}
+
+TEST(KalmanUpdatePolicy, filter_resets_after_consecutive_outliers)
+{
+    cul::KalmanUpdatePolicy::Configuration configuration;
+    configuration.max_consecutive_outliers = 3;
+    cul::KalmanUpdatePolicy policy{configuration};
+
+    auto t = cul::Clock::now();
+    for (std::size_t i = 0; i < 10; i++)
+        policy.verify_update(fix_at(0., 0., 10., t + std::chrono::seconds{i}));
+
+    cul::Update<cul::Position> estimate;
+    for (std::size_t i = 10; i < 13; i++)
+        estimate = policy.verify_update(fix_at(5000., 0., 10., t + std::chrono::seconds{i}));
+
+    EXPECT_LT(distance(fix_at(5000., 0., 0., t), estimate), 1.);
+}
+
+TEST(KalmanUpdatePolicy, velocity_and_heading_are_fused)
+{
+    cul::KalmanUpdatePolicy policy;
+
+    auto t = cul::Clock::now();
+    policy.verify_update(fix_at(0., 0., 10., t));
+    policy.verify_update(cul::Update<cul::Heading>{90. * cul::units::Degrees, t});
+
+    cul::Update<cul::Velocity> velocity{10. * cul::units::MetersPerSecond, t};
+    auto estimate = policy.verify_update(velocity);
+
+    EXPECT_NEAR(10., estimate.value.value(), 1.);
+}
+
+TEST(KalmanUpdatePolicy, estimate_does_not_jump_when_recentering_the_local_frame)
+{
+    cul::KalmanUpdatePolicy policy;
+
+    // Heading north-east, the estimate leaves the 10km around the origin
+    // after about 10 minutes, at a different latitude than the origin.
+    auto t = cul::Clock::now();
+    for (std::size_t i = 0; i < 900; i++)
+    {
+        auto fix = fix_at(20. * i, 20. * i, 3., t + std::chrono::seconds{i});
+        auto estimate = policy.verify_update(fix);
+
+        if (i < 60)
+            continue;
+
+        ASSERT_LT(distance(fix, estimate), 5.) << "after " << i << " seconds";
+    }
+}
+
+// Replays a synthetic drive through the time-based and the Kalman policy,
+// reporting CPU time per fix and the error against ground truth.
+TEST(KalmanUpdatePolicy, benchmark_replay_against_time_based_policy)
+{
+    static constexpr std::size_t fixes{3600};
+    auto replay = drive(fixes);
+
+    cul::TimeBasedUpdatePolicy time_based;
+    cul::KalmanUpdatePolicy kalman;
+
+    struct Result
+    {
+        double rms;
+        double cpu;
+    };
+
+    auto run = [&replay](cul::UpdatePolicy& policy)
+    {
+        std::vector<cul::Update<cul::Position>> estimates;
+        estimates.reserve(replay.fixes.size());
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& fix : replay.fixes)
+            estimates.push_back(policy.verify_update(fix));
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        double squared_error{0.};
+        for (std::size_t i = 0; i < estimates.size(); i++)
+            squared_error += std::pow(distance(replay.truth[i], estimates[i]), 2);
+
+        return Result
+        {
+            std::sqrt(squared_error / estimates.size()),
+            std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(elapsed).count() / estimates.size()
+        };
+    };
+
+    auto tb = run(time_based);
+    auto kf = run(kalman);
+
+    std::cout << "TimeBasedUpdatePolicy: " << tb.rms << " [m] rms error, " << tb.cpu << " [ns/fix]" << std::endl;
+    std::cout << "KalmanUpdatePolicy:    " << kf.rms << " [m] rms error, " << kf.cpu << " [ns/fix]" << std::endl;
+
+    EXPECT_LT(kf.rms, tb.rms);
+}
@@ -30,6 +30,7 @@ struct NullProviderSelectionPolicy : public com::ubuntu::location::ProviderSelec
     {
         return com::ubuntu::location::ProviderSelection
         {
+            com::ubuntu::location::Provider::Ptr{},
             com::ubuntu::location::Provider::Ptr{},
             com::ubuntu::location::Provider::Ptr{},
             com::ubuntu::location::Provider::Ptr{}
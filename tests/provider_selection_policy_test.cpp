@@ -71,7 +71,7 @@ TEST(ProviderSelection, feature_flags_calculation_works_correctly)
 {
     cul::Provider::Ptr provider{new DummyProvider{}};
 
-    cul::ProviderSelection selection{provider, provider, provider};
+    cul::ProviderSelection selection{provider, provider, provider, cul::Provider::Ptr{}};
 
     EXPECT_EQ(all_features, selection.to_feature_flags());
 }
@@ -105,7 +105,8 @@ TEST(DefaultProviderSelectionPolicy, if_no_provider_matches_criteria_null_is_ret
     {
         cul::ProviderSelectionPolicy::null_provider(),
         cul::ProviderSelectionPolicy::null_provider(),
-        cul::ProviderSelectionPolicy::null_provider()
+        cul::ProviderSelectionPolicy::null_provider(),
+        cul::Provider::Ptr{}
     };
     EXPECT_EQ(empty_selection,
               policy.determine_provider_selection_for_criteria(cul::Criteria{}, enumerator));
@@ -137,11 +138,86 @@ TEST(DefaultProviderSelectionPolicy, an_already_running_provider_is_preferred)
               policy.determine_heading_updates_provider(cul::Criteria{}, enumerator));
     EXPECT_EQ(p1,
               policy.determine_velocity_updates_provider(cul::Criteria{}, enumerator));
-    cul::ProviderSelection ps{p1, p1, p1};
+    cul::ProviderSelection ps{p1, p1, p1, cul::Provider::Ptr{}};
     EXPECT_EQ(ps,
               policy.determine_provider_selection_for_criteria(cul::Criteria{}, enumerator));
 }
 
+TEST(DefaultProviderSelectionPolicy, hedging_selects_a_coarse_provider_alongside_a_satellite_based_one)
+{
+    using namespace testing;
+
+    NiceMock<DummyProvider> gps{cul::Provider::Features::position, cul::Provider::Requirements::satellites};
+    NiceMock<DummyProvider> network{cul::Provider::Features::position, cul::Provider::Requirements::data_network};
+    ON_CALL(gps, matches_criteria(_)).WillByDefault(Return(true));
+    ON_CALL(network, matches_criteria(_)).WillByDefault(Return(true));
+
+    // Make sure that the gps is selected as position provider.
+    gps.state_controller()->start_position_updates();
+
+    cul::Provider::Ptr p1{&gps, [](cul::Provider*){}};
+    cul::Provider::Ptr p2{&network, [](cul::Provider*){}};
+
+    std::set<cul::Provider::Ptr> providers{{p1, p2}};
+    ProviderSetEnumerator enumerator{providers};
+
+    cul::DefaultProviderSelectionPolicy hedging_policy{true};
+    auto selection = hedging_policy.determine_provider_selection_for_criteria(cul::Criteria{}, enumerator);
+    EXPECT_EQ(p1, selection.position_updates_provider);
+    EXPECT_EQ(p2, selection.coarse_position_updates_provider);
+
+    cul::DefaultProviderSelectionPolicy policy;
+    EXPECT_EQ(nullptr, policy.determine_provider_selection_for_criteria(cul::Criteria{}, enumerator).coarse_position_updates_provider);
+}
+
+#include <com/ubuntu/location/fusion_provider_selection_policy.h>
+
+TEST(FusionProviderSelectionPolicy, hedging_fuses_coarse_providers_separately_from_satellite_based_ones)
+{
+    using namespace testing;
+
+    NiceMock<DummyProvider> gps{cul::Provider::Features::position, cul::Provider::Requirements::satellites};
+    NiceMock<DummyProvider> network{cul::Provider::Features::position, cul::Provider::Requirements::data_network};
+
+    cul::Provider::Ptr p1{&gps, [](cul::Provider*){}};
+    cul::Provider::Ptr p2{&network, [](cul::Provider*){}};
+
+    std::set<cul::Provider::Ptr> providers{{p1, p2}};
+    ProviderSetEnumerator enumerator{providers};
+
+    cul::FusionProviderSelectionPolicy policy;
+    EXPECT_EQ(nullptr, policy.determine_provider_selection_for_criteria(cul::Criteria{}, enumerator).coarse_position_updates_provider);
+
+    cul::FusionProviderSelectionPolicy hedging_policy{true};
+    auto selection = hedging_policy.determine_provider_selection_for_criteria(cul::Criteria{}, enumerator);
+    ASSERT_NE(nullptr, selection.position_updates_provider);
+    ASSERT_NE(nullptr, selection.coarse_position_updates_provider);
+
+    selection.position_updates_provider->state_controller()->start_position_updates();
+    EXPECT_TRUE(gps.state_controller()->are_position_updates_running());
+    EXPECT_FALSE(network.state_controller()->are_position_updates_running());
+
+    selection.coarse_position_updates_provider->state_controller()->start_position_updates();
+    EXPECT_TRUE(network.state_controller()->are_position_updates_running());
+
+    selection.coarse_position_updates_provider->state_controller()->stop_position_updates();
+    selection.position_updates_provider->state_controller()->stop_position_updates();
+}
+
+TEST(FusionProviderSelectionPolicy, without_satellite_based_providers_hedging_selects_no_coarse_provider)
+{
+    using namespace testing;
+
+    NiceMock<DummyProvider> network{cul::Provider::Features::position, cul::Provider::Requirements::data_network};
+    cul::Provider::Ptr p1{&network, [](cul::Provider*){}};
+
+    std::set<cul::Provider::Ptr> providers{{p1}};
+    ProviderSetEnumerator enumerator{providers};
+
+    cul::FusionProviderSelectionPolicy hedging_policy{true};
+    EXPECT_EQ(nullptr, hedging_policy.determine_provider_selection_for_criteria(cul::Criteria{}, enumerator).coarse_position_updates_provider);
+}
+
 #include <com/ubuntu/location/non_selecting_provider_selection_policy.h>
 
 TEST(NonSelectingProviderSelectionPolicy, returns_a_selection_of_providers_that_dispatches_to_all_underlying_providers)
@@ -143,12 +143,25 @@ struct MockProvider : public com::ubuntu::location::Provider
         mutable_updates().heading(update);
     }
 
+    void inject_update(const std::vector<cul::Update<cul::Position>>& batch)
+    {
+        mutable_updates().position_batch(batch);
+    }
+
     MOCK_METHOD0(start_position_updates, void());
     MOCK_METHOD0(stop_position_updates, void());
     MOCK_METHOD0(start_heading_updates, void());
     MOCK_METHOD0(stop_heading_updates, void());
     MOCK_METHOD0(start_velocity_updates, void());
     MOCK_METHOD0(stop_velocity_updates, void());
+
+    // Optional<std::chrono::milliseconds> cannot be printed by gmock, we record instead.
+    void set_update_interval(const cul::Optional<std::chrono::milliseconds>& interval) override
+    {
+        update_intervals.push_back(interval);
+    }
+
+    std::vector<cul::Optional<std::chrono::milliseconds>> update_intervals;
 };
 }
 
@@ -218,6 +231,36 @@ TEST(Provider, disabling_a_provider_stops_all_updates)
     p.state_controller()->disable();
 }
 
+TEST(Provider, minimum_of_requested_update_intervals_is_handed_to_provider)
+{
+    using namespace ::testing;
+
+    typedef cul::Optional<std::chrono::milliseconds> Interval;
+
+    NiceMock<MockProvider> p;
+
+    p.state_controller()->request_update_interval(std::chrono::milliseconds{1000});
+    p.state_controller()->request_update_interval(std::chrono::milliseconds{5000});
+    p.state_controller()->request_update_interval(std::chrono::milliseconds{200});
+    EXPECT_TRUE(Interval{std::chrono::milliseconds{200}} == p.state_controller()->update_interval());
+
+    p.state_controller()->release_update_interval(std::chrono::milliseconds{200});
+    p.state_controller()->release_update_interval(std::chrono::milliseconds{5000});
+    // Releasing an interval that was never requested is a no-op.
+    p.state_controller()->release_update_interval(std::chrono::milliseconds{42});
+    p.state_controller()->release_update_interval(std::chrono::milliseconds{1000});
+    EXPECT_FALSE(p.state_controller()->update_interval());
+
+    std::vector<Interval> expected
+    {
+        Interval{std::chrono::milliseconds{1000}},
+        Interval{std::chrono::milliseconds{200}},
+        Interval{std::chrono::milliseconds{1000}},
+        Interval{}
+    };
+    EXPECT_TRUE(expected == p.update_intervals);
+}
+
 #include <com/ubuntu/location/proxy_provider.h>
 
 TEST(ProxyProvider, start_and_stop_of_updates_propagates_to_correct_providers)
@@ -236,7 +279,7 @@ TEST(ProxyProvider, start_and_stop_of_updates_propagates_to_correct_providers)
     cul::Provider::Ptr p2{std::addressof(mp2), [](cul::Provider*){}};
     cul::Provider::Ptr p3{std::addressof(mp3), [](cul::Provider*){}};
     
-    cul::ProviderSelection selection{p1, p2, p3};
+    cul::ProviderSelection selection{p1, p2, p3, cul::Provider::Ptr{}};
 
     cul::ProxyProvider pp{selection};
 
@@ -250,6 +293,103 @@ TEST(ProxyProvider, start_and_stop_of_updates_propagates_to_correct_providers)
     pp.stop_velocity_updates();
 }
 
+TEST(ProxyProvider, update_interval_is_relayed_once_to_each_selected_provider)
+{
+    using namespace ::testing;
+
+    typedef cul::Optional<std::chrono::milliseconds> Interval;
+
+    NiceMock<MockProvider> mp1, mp2;
+
+    cul::Provider::Ptr p1{std::addressof(mp1), [](cul::Provider*){}};
+    cul::Provider::Ptr p2{std::addressof(mp2), [](cul::Provider*){}};
+
+    // p1 is selected for both position and heading updates.
+    cul::ProviderSelection selection{p1, p1, p2, cul::Provider::Ptr{}};
+
+    {
+        cul::ProxyProvider pp{selection};
+        pp.state_controller()->request_update_interval(std::chrono::milliseconds{500});
+    }
+
+    std::vector<Interval> expected{Interval{std::chrono::milliseconds{500}}, Interval{}};
+    EXPECT_TRUE(expected == mp1.update_intervals);
+    EXPECT_TRUE(expected == mp2.update_intervals);
+}
+
+TEST(ProxyProvider, coarse_provider_bridges_until_position_provider_is_accurate_enough)
+{
+    using namespace ::testing;
+
+    NiceMock<MockProvider> precise, coarse;
+    EXPECT_CALL(precise, start_position_updates()).Times(Exactly(1));
+    EXPECT_CALL(precise, stop_position_updates()).Times(Exactly(1));
+    EXPECT_CALL(coarse, start_position_updates()).Times(Exactly(1));
+    EXPECT_CALL(coarse, stop_position_updates()).Times(Exactly(1));
+
+    cul::Provider::Ptr p1{std::addressof(precise), [](cul::Provider*){}};
+    cul::Provider::Ptr p2{std::addressof(coarse), [](cul::Provider*){}};
+
+    cul::Criteria criteria;
+    criteria.accuracy.horizontal = 50. * cul::units::Meters;
+
+    cul::ProviderSelection selection{p1, p1, p1, p2};
+    cul::ProxyProvider pp{selection, criteria};
+
+    std::vector<cul::Update<cul::Position>> delivered;
+    pp.updates().position.connect([&delivered](const cul::Update<cul::Position>& u)
+    {
+        delivered.push_back(u);
+    });
+
+    cul::Update<cul::Position> coarse_fix
+    {
+        {
+            cul::wgs84::Latitude{9. * cul::units::Degrees},
+            cul::wgs84::Longitude{53. * cul::units::Degrees},
+            cul::wgs84::Altitude{-2. * cul::units::Meters},
+            1000. * cul::units::Meters
+        }
+    };
+
+    cul::Update<cul::Position> inaccurate_fix = coarse_fix;
+    inaccurate_fix.value.accuracy.horizontal = 100. * cul::units::Meters;
+
+    cul::Update<cul::Position> accurate_fix = coarse_fix;
+    accurate_fix.value.accuracy.horizontal = 5. * cul::units::Meters;
+
+    pp.start_position_updates();
+
+    coarse.inject_update(coarse_fix);
+    precise.inject_update(inaccurate_fix);
+    coarse.inject_update(coarse_fix);
+    precise.inject_update(accurate_fix);
+    // Hedging is over, coarse fixes are not delivered anymore.
+    coarse.inject_update(coarse_fix);
+
+    pp.stop_position_updates();
+
+    std::vector<cul::Update<cul::Position>> expected{coarse_fix, inaccurate_fix, coarse_fix, accurate_fix};
+    EXPECT_EQ(expected, delivered);
+}
+
+TEST(ProxyProvider, coarse_provider_is_not_started_without_criteria)
+{
+    using namespace ::testing;
+
+    NiceMock<MockProvider> precise, coarse;
+    EXPECT_CALL(precise, start_position_updates()).Times(Exactly(1));
+    EXPECT_CALL(coarse, start_position_updates()).Times(Exactly(0));
+
+    cul::Provider::Ptr p1{std::addressof(precise), [](cul::Provider*){}};
+    cul::Provider::Ptr p2{std::addressof(coarse), [](cul::Provider*){}};
+
+    cul::ProviderSelection selection{p1, p1, p1, p2};
+    cul::ProxyProvider pp{selection};
+
+    pp.start_position_updates();
+}
+
 struct MockEventConsumer
 {
     MOCK_METHOD1(on_new_position, void(const cul::Update<cul::Position>&));
@@ -267,7 +407,7 @@ TEST(ProxyProvider, update_signals_are_routed_from_correct_providers)
     cul::Provider::Ptr p2{std::addressof(mp2), [](cul::Provider*){}};
     cul::Provider::Ptr p3{std::addressof(mp3), [](cul::Provider*){}};
     
-    cul::ProviderSelection selection{p1, p2, p3};
+    cul::ProviderSelection selection{p1, p2, p3, cul::Provider::Ptr{}};
 
     cul::ProxyProvider pp{selection};
 
@@ -285,6 +425,31 @@ TEST(ProxyProvider, update_signals_are_routed_from_correct_providers)
     mp3.inject_update(cul::Update<cul::Velocity>());
 }
 
+TEST(ProxyProvider, position_batches_are_routed_from_position_provider)
+{
+    using namespace ::testing;
+
+    NiceMock<MockProvider> mp1, mp2, mp3;
+
+    cul::Provider::Ptr p1{std::addressof(mp1), [](cul::Provider*){}};
+    cul::Provider::Ptr p2{std::addressof(mp2), [](cul::Provider*){}};
+    cul::Provider::Ptr p3{std::addressof(mp3), [](cul::Provider*){}};
+
+    cul::ProviderSelection selection{p1, p2, p3, cul::Provider::Ptr{}};
+
+    cul::ProxyProvider pp{selection};
+
+    std::vector<cul::Update<cul::Position>> batch{update_as_of_now<cul::Position>(), update_as_of_now<cul::Position>()};
+    std::vector<std::vector<cul::Update<cul::Position>>> received;
+    pp.updates().position_batch.connect([&received](const std::vector<cul::Update<cul::Position>>& b){received.push_back(b);});
+
+    mp2.inject_update(batch);
+    mp1.inject_update(batch);
+
+    ASSERT_EQ(1u, received.size());
+    EXPECT_EQ(batch, received.front());
+}
+
 #include <com/ubuntu/location/fusion_provider.h>
 #include <com/ubuntu/location/newer_or_more_accurate_update_selector.h>
 
@@ -304,7 +469,7 @@ TEST(FusionProvider, start_and_stop_of_updates_propagates_to_correct_providers)
     cul::Provider::Ptr p2{std::addressof(mp2), [](cul::Provider*){}};
     cul::Provider::Ptr p3{std::addressof(mp3), [](cul::Provider*){}};
 
-    cul::ProviderSelection selection{p1, p2, p3};
+    cul::ProviderSelection selection{p1, p2, p3, cul::Provider::Ptr{}};
     std::set<cul::Provider::Ptr> providers{p1, p2, p3};
 
     //cul::FusionProvider pp{selection};
@@ -439,3 +604,68 @@ TEST(FusionProvider, update_from_same_provider_is_chosen)
     mp1.inject_update(before);
     mp1.inject_update(after);
 }
+
+TEST(FusionProvider, position_batch_losing_against_a_more_accurate_update_is_not_handed_on)
+{
+    using namespace ::testing;
+
+    NiceMock<MockProvider> mp1, mp2;
+
+    cul::Provider::Ptr p1{std::addressof(mp1), [](cul::Provider*){}};
+    cul::Provider::Ptr p2{std::addressof(mp2), [](cul::Provider*){}};
+
+    std::set<cul::Provider::Ptr> providers{p1, p2};
+
+    cul::FusionProvider fp{providers, std::make_shared<cul::NewerOrMoreAccurateUpdateSelector>()};
+
+    cul::Update<cul::Position> before, after;
+    before.when = cul::Clock::now() - std::chrono::seconds(5);
+    before.value = cul::Position(cul::wgs84::Latitude(), cul::wgs84::Longitude(), cul::wgs84::Altitude(), cul::Position::Accuracy::Horizontal{50*cul::units::Meters});
+    after.when = cul::Clock::now();
+    after.value = cul::Position(cul::wgs84::Latitude(), cul::wgs84::Longitude(), cul::wgs84::Altitude(), cul::Position::Accuracy::Horizontal{500*cul::units::Meters});
+
+    NiceMock<MockEventConsumer> mec;
+    // The more accurate position wins over the batch and is reported again.
+    EXPECT_CALL(mec, on_new_position(before)).Times(2);
+
+    std::vector<std::vector<cul::Update<cul::Position>>> batches;
+
+    fp.updates().position.connect([&mec](const cul::Update<cul::Position>& p){mec.on_new_position(p);});
+    fp.updates().position_batch.connect([&batches](const std::vector<cul::Update<cul::Position>>& b){batches.push_back(b);});
+
+    mp1.inject_update(before);
+    mp2.inject_update(std::vector<cul::Update<cul::Position>>{after, after});
+
+    EXPECT_TRUE(batches.empty());
+}
+
+TEST(FusionProvider, position_batch_chosen_by_the_selector_is_handed_on)
+{
+    using namespace ::testing;
+
+    NiceMock<MockProvider> mp1, mp2;
+
+    cul::Provider::Ptr p1{std::addressof(mp1), [](cul::Provider*){}};
+    cul::Provider::Ptr p2{std::addressof(mp2), [](cul::Provider*){}};
+
+    std::set<cul::Provider::Ptr> providers{p1, p2};
+
+    cul::FusionProvider fp{providers, std::make_shared<cul::NewerOrMoreAccurateUpdateSelector>()};
+
+    cul::Update<cul::Position> before, after;
+    before.when = cul::Clock::now() - std::chrono::seconds(12);
+    before.value = cul::Position(cul::wgs84::Latitude(), cul::wgs84::Longitude(), cul::wgs84::Altitude(), cul::Position::Accuracy::Horizontal{50*cul::units::Meters});
+    after.when = cul::Clock::now();
+    after.value = cul::Position(cul::wgs84::Latitude(), cul::wgs84::Longitude(), cul::wgs84::Altitude(), cul::Position::Accuracy::Horizontal{500*cul::units::Meters});
+
+    std::vector<cul::Update<cul::Position>> batch{before, after};
+    std::vector<std::vector<cul::Update<cul::Position>>> batches;
+
+    fp.updates().position_batch.connect([&batches](const std::vector<cul::Update<cul::Position>>& b){batches.push_back(b);});
+
+    mp1.inject_update(before);
+    mp2.inject_update(batch);
+
+    ASSERT_EQ(1u, batches.size());
+    EXPECT_EQ(batch, batches.front());
+}
@@ -18,6 +18,7 @@
 
 #include <com/ubuntu/location/logging.h>
 #include <com/ubuntu/location/provider.h>
+#include <com/ubuntu/location/provider_factory.h>
 
 #include <com/ubuntu/location/providers/remote/interface.h>
 #include <com/ubuntu/location/providers/remote/skeleton.h>
@@ -35,12 +36,16 @@
 #include <core/posix/fork.h>
 #include <core/posix/signal.h>
 
+#include <core/testing/cross_process_sync.h>
 #include <core/testing/fork_and_run.h>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace cul = com::ubuntu::location;
 namespace dbus = core::dbus;
@@ -78,6 +83,21 @@ namespace
     return ::testing::AssertionSuccess();
 }
 
+// Records the update interval requested by the remote end, as gmock cannot print optionals.
+struct IntervalRecordingProvider : public MockProvider
+{
+    void set_update_interval(const cul::Optional<std::chrono::milliseconds>& interval) override
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        update_interval = interval;
+        changed.notify_all();
+    }
+
+    std::mutex guard;
+    std::condition_variable changed;
+    cul::Optional<std::chrono::milliseconds> update_interval;
+};
+
 struct RemoteProvider : public core::dbus::testing::Fixture
 {
     static constexpr const char* stub_remote_provider_service_name
@@ -164,7 +184,8 @@ TEST_F(RemoteProvider, DISABLED_updates_are_fwd)
         {
             object,
             bus,
-            mock_provider
+            mock_provider,
+            remote::skeleton::Configuration::Batching{}
         });
 
         std::thread position_updates_injector{[mock_provider, &running]()
@@ -231,7 +252,8 @@ TEST_F(RemoteProvider, DISABLED_updates_are_fwd)
             core::dbus::Service::use_service(
                 bus,
                 RemoteProvider::stub_remote_provider_service_name)->object_for_path(
-                    core::dbus::types::ObjectPath{RemoteProvider::stub_remote_provider_path})
+                    core::dbus::types::ObjectPath{RemoteProvider::stub_remote_provider_path}),
+            remote::stub::Configuration::SharedMemory{}
         };
 
         auto provider = remote::stub::create_with_configuration(conf);
@@ -311,3 +333,715 @@ TEST_F(RemoteProvider, DISABLED_updates_are_fwd)
     skeleton.send_signal_or_throw(core::posix::Signal::sig_term);
     EXPECT_TRUE(did_finish_successfully(skeleton.wait_for(core::posix::wait::Flags::untraced)));
 }
+
+TEST_F(RemoteProvider, capabilities_are_cached_until_the_remote_end_announces_a_change)
+{
+    using namespace ::testing;
+
+    core::testing::CrossProcessSync sync_skeleton_ready;
+    core::testing::CrossProcessSync sync_capabilities_queried;
+
+    auto skeleton = [this, &sync_skeleton_ready, &sync_capabilities_queried]()
+    {
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+
+        std::thread worker([bus]()
+        {
+            bus->run();
+        });
+
+        auto object = dbus::Service::add_service(
+                    bus,
+                    RemoteProvider::stub_remote_provider_service_name)
+                        ->add_object_for_path(
+                            dbus::types::ObjectPath{RemoteProvider::stub_remote_provider_path});
+
+        // Queried for announcing its capabilities on creation, and once more by the stub.
+        // Any further query by the stub must be answered from its cache.
+        auto positioning = std::make_shared<NiceMock<MockProvider>>();
+        EXPECT_CALL(*positioning, supports(_)).Times(AtMost(6)).WillRepeatedly(Invoke([](const cul::Provider::Features& f)
+        {
+            return f == cul::Provider::Features::position;
+        }));
+
+        auto provider = remote::skeleton::create_with_configuration(remote::skeleton::Configuration
+        {
+            object,
+            bus,
+            positioning,
+            remote::skeleton::Configuration::Batching{}
+        });
+
+        sync_skeleton_ready.try_signal_ready_for(std::chrono::milliseconds{500});
+        EXPECT_EQ(1, sync_capabilities_queried.wait_for_signal_ready_for(std::chrono::milliseconds{15000}));
+
+        provider.reset();
+        EXPECT_TRUE(Mock::VerifyAndClearExpectations(positioning.get()));
+
+        // The remote end comes back with different capabilities, and announces them.
+        auto heading = std::make_shared<NiceMock<MockProvider>>();
+        ON_CALL(*heading, supports(_)).WillByDefault(Invoke([](const cul::Provider::Features& f)
+        {
+            return f == cul::Provider::Features::heading;
+        }));
+
+        provider = remote::skeleton::create_with_configuration(remote::skeleton::Configuration
+        {
+            object,
+            bus,
+            heading,
+            remote::skeleton::Configuration::Batching{}
+        });
+
+        trap->run();
+
+        bus->stop();
+
+        if (worker.joinable())
+            worker.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure :
+                                               core::posix::exit::Status::success;
+    };
+
+    auto stub = [this, &sync_skeleton_ready, &sync_capabilities_queried]()
+    {
+        EXPECT_EQ(1, sync_skeleton_ready.wait_for_signal_ready_for(std::chrono::milliseconds{15000}));
+
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+
+        std::thread worker([bus]()
+        {
+            bus->run();
+        });
+
+        remote::stub::Configuration conf
+        {
+            core::dbus::Service::use_service(
+                bus,
+                RemoteProvider::stub_remote_provider_service_name)->object_for_path(
+                    core::dbus::types::ObjectPath{RemoteProvider::stub_remote_provider_path}),
+            remote::stub::Configuration::SharedMemory{}
+        };
+
+        auto provider = remote::stub::create_with_configuration(conf);
+
+        for (unsigned int i = 0; i < 100; i++)
+        {
+            EXPECT_TRUE(provider->supports(cul::Provider::Features::position));
+            EXPECT_FALSE(provider->supports(cul::Provider::Features::heading));
+        }
+
+        sync_capabilities_queried.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        // The cache is refreshed by the CapabilitiesChanged signal, without us asking.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+        while (not provider->supports(cul::Provider::Features::heading) && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+        EXPECT_TRUE(provider->supports(cul::Provider::Features::heading));
+        EXPECT_FALSE(provider->supports(cul::Provider::Features::position));
+
+        bus->stop();
+
+        if (worker.joinable())
+            worker.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure :
+                                               core::posix::exit::Status::success;
+    };
+
+    EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(skeleton, stub));
+}
+
+TEST_F(RemoteProvider, batches_are_flushed_once_full)
+{
+    using namespace ::testing;
+
+    core::testing::CrossProcessSync sync_skeleton_ready;
+    core::testing::CrossProcessSync sync_stub_ready;
+
+    static const cul::Position position
+    {
+        cul::wgs84::Latitude{2* cul::units::Degrees},
+        cul::wgs84::Longitude{3* cul::units::Degrees}
+    };
+
+    auto skeleton = [this, &sync_skeleton_ready, &sync_stub_ready]()
+    {
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+
+        std::thread worker([bus]()
+        {
+            bus->run();
+        });
+
+        auto object = dbus::Service::add_service(
+                    bus,
+                    RemoteProvider::stub_remote_provider_service_name)
+                        ->add_object_for_path(
+                            dbus::types::ObjectPath{RemoteProvider::stub_remote_provider_path});
+
+        auto mock_provider = std::make_shared<NiceMock<MockProvider>>();
+
+        remote::skeleton::Configuration::Batching batching;
+        // Only a full batch is flushed within the lifetime of the test.
+        batching.flush_interval = std::chrono::seconds{60};
+        batching.max_size = 4;
+
+        auto provider = remote::skeleton::create_with_configuration(remote::skeleton::Configuration
+        {
+            object,
+            bus,
+            mock_provider,
+            batching
+        });
+
+        sync_skeleton_ready.try_signal_ready_for(std::chrono::milliseconds{500});
+        EXPECT_EQ(1, sync_stub_ready.wait_for_signal_ready_for(std::chrono::milliseconds{15000}));
+
+        for (unsigned int i = 0; i < 4; i++)
+            mock_provider->inject_update(cul::Update<cul::Position>{position});
+
+        trap->run();
+
+        bus->stop();
+
+        if (worker.joinable())
+            worker.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure :
+                                               core::posix::exit::Status::success;
+    };
+
+    auto stub = [this, &sync_skeleton_ready, &sync_stub_ready]()
+    {
+        EXPECT_EQ(1, sync_skeleton_ready.wait_for_signal_ready_for(std::chrono::milliseconds{15000}));
+
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+
+        std::thread worker([bus]()
+        {
+            bus->run();
+        });
+
+        remote::stub::Configuration conf
+        {
+            core::dbus::Service::use_service(
+                bus,
+                RemoteProvider::stub_remote_provider_service_name)->object_for_path(
+                    core::dbus::types::ObjectPath{RemoteProvider::stub_remote_provider_path}),
+            remote::stub::Configuration::SharedMemory{}
+        };
+
+        auto provider = remote::stub::create_with_configuration(conf);
+
+        std::mutex guard;
+        std::condition_variable cv;
+        std::vector<std::size_t> batches;
+
+        core::ScopedConnection sc
+        {
+            provider->updates().position_batch.connect([&](const std::vector<cul::Update<cul::Position>>& batch)
+            {
+                std::lock_guard<std::mutex> lg(guard);
+                batches.push_back(batch.size());
+                cv.notify_all();
+            })
+        };
+
+        provider->state_controller()->start_position_updates();
+
+        sync_stub_ready.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        {
+            std::unique_lock<std::mutex> ul(guard);
+            EXPECT_TRUE(cv.wait_for(ul, std::chrono::seconds{5}, [&batches]() { return not batches.empty(); }));
+        }
+
+        // We waited far shorter than the flush interval, the batch left as it ran full.
+        {
+            std::lock_guard<std::mutex> lg(guard);
+            EXPECT_EQ(std::vector<std::size_t>{4}, batches);
+        }
+
+        provider->state_controller()->stop_position_updates();
+
+        bus->stop();
+
+        if (worker.joinable())
+            worker.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure :
+                                               core::posix::exit::Status::success;
+    };
+
+    EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(skeleton, stub));
+}
+
+TEST_F(RemoteProvider, batches_are_flushed_once_the_flush_interval_elapses)
+{
+    using namespace ::testing;
+
+    core::testing::CrossProcessSync sync_skeleton_ready;
+    core::testing::CrossProcessSync sync_stub_ready;
+
+    static const cul::Position position
+    {
+        cul::wgs84::Latitude{2* cul::units::Degrees},
+        cul::wgs84::Longitude{3* cul::units::Degrees}
+    };
+
+    auto skeleton = [this, &sync_skeleton_ready, &sync_stub_ready]()
+    {
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+
+        std::thread worker([bus]()
+        {
+            bus->run();
+        });
+
+        auto object = dbus::Service::add_service(
+                    bus,
+                    RemoteProvider::stub_remote_provider_service_name)
+                        ->add_object_for_path(
+                            dbus::types::ObjectPath{RemoteProvider::stub_remote_provider_path});
+
+        auto mock_provider = std::make_shared<NiceMock<MockProvider>>();
+
+        remote::skeleton::Configuration::Batching batching;
+        // The batch never runs full.
+        batching.flush_interval = std::chrono::milliseconds{200};
+        batching.max_size = 100;
+
+        auto provider = remote::skeleton::create_with_configuration(remote::skeleton::Configuration
+        {
+            object,
+            bus,
+            mock_provider,
+            batching
+        });
+
+        sync_skeleton_ready.try_signal_ready_for(std::chrono::milliseconds{500});
+        EXPECT_EQ(1, sync_stub_ready.wait_for_signal_ready_for(std::chrono::milliseconds{15000}));
+
+        for (unsigned int i = 0; i < 2; i++)
+            mock_provider->inject_update(cul::Update<cul::Position>{position});
+
+        trap->run();
+
+        bus->stop();
+
+        if (worker.joinable())
+            worker.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure :
+                                               core::posix::exit::Status::success;
+    };
+
+    auto stub = [this, &sync_skeleton_ready, &sync_stub_ready]()
+    {
+        EXPECT_EQ(1, sync_skeleton_ready.wait_for_signal_ready_for(std::chrono::milliseconds{15000}));
+
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+
+        std::thread worker([bus]()
+        {
+            bus->run();
+        });
+
+        remote::stub::Configuration conf
+        {
+            core::dbus::Service::use_service(
+                bus,
+                RemoteProvider::stub_remote_provider_service_name)->object_for_path(
+                    core::dbus::types::ObjectPath{RemoteProvider::stub_remote_provider_path}),
+            remote::stub::Configuration::SharedMemory{}
+        };
+
+        auto provider = remote::stub::create_with_configuration(conf);
+
+        std::mutex guard;
+        std::condition_variable cv;
+        std::vector<std::size_t> batches;
+
+        core::ScopedConnection sc
+        {
+            provider->updates().position_batch.connect([&](const std::vector<cul::Update<cul::Position>>& batch)
+            {
+                std::lock_guard<std::mutex> lg(guard);
+                batches.push_back(batch.size());
+                cv.notify_all();
+            })
+        };
+
+        provider->state_controller()->start_position_updates();
+
+        auto then = std::chrono::steady_clock::now();
+        sync_stub_ready.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        {
+            std::unique_lock<std::mutex> ul(guard);
+            EXPECT_TRUE(cv.wait_for(ul, std::chrono::seconds{5}, [&batches]() { return not batches.empty(); }));
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - then;
+
+        // The batch was held back for its flush interval.
+        EXPECT_GE(elapsed, std::chrono::milliseconds{200});
+
+        {
+            std::lock_guard<std::mutex> lg(guard);
+            EXPECT_EQ(std::vector<std::size_t>{2}, batches);
+        }
+
+        provider->state_controller()->stop_position_updates();
+
+        bus->stop();
+
+        if (worker.joinable())
+            worker.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure :
+                                               core::posix::exit::Status::success;
+    };
+
+    EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(skeleton, stub));
+}
+
+TEST_F(RemoteProvider, superseded_reference_values_are_dropped_while_calls_are_in_flight)
+{
+    using namespace ::testing;
+
+    core::testing::CrossProcessSync sync_skeleton_ready;
+    core::testing::CrossProcessSync sync_skeleton_done;
+
+    static const unsigned int update_count{50};
+
+    auto skeleton = [this, &sync_skeleton_ready, &sync_skeleton_done]()
+    {
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+
+        std::thread worker([bus]()
+        {
+            bus->run();
+        });
+
+        auto object = dbus::Service::add_service(
+                    bus,
+                    RemoteProvider::stub_remote_provider_service_name)
+                        ->add_object_for_path(
+                            dbus::types::ObjectPath{RemoteProvider::stub_remote_provider_path});
+
+        auto mock_provider = std::make_shared<NiceMock<MockProvider>>();
+
+        std::mutex guard;
+        std::condition_variable cv;
+        std::vector<double> received;
+
+        // Every reference update takes a while to be handled, such that
+        // further updates pile up on the stub side.
+        EXPECT_CALL(*mock_provider, on_reference_location_updated(_))
+                .WillRepeatedly(Invoke([&](const cul::Update<cul::Position>& update)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+
+                    std::lock_guard<std::mutex> lg(guard);
+                    received.push_back(update.value.latitude.value.value());
+                    cv.notify_all();
+                }));
+
+        auto provider = remote::skeleton::create_with_configuration(remote::skeleton::Configuration
+        {
+            object,
+            bus,
+            mock_provider,
+            remote::skeleton::Configuration::Batching{}
+        });
+
+        sync_skeleton_ready.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        {
+            std::unique_lock<std::mutex> ul(guard);
+            EXPECT_TRUE(cv.wait_for(ul, std::chrono::seconds{10}, [&received]()
+            {
+                return not received.empty() && received.back() == update_count;
+            }));
+
+            // Intermediate values have been dropped, the most recent one made it
+            // and values never arrive out of order.
+            EXPECT_LT(received.size(), update_count);
+            EXPECT_TRUE(std::is_sorted(received.begin(), received.end()));
+        }
+
+        sync_skeleton_done.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        trap->run();
+
+        bus->stop();
+
+        if (worker.joinable())
+            worker.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure :
+                                               core::posix::exit::Status::success;
+    };
+
+    auto stub = [this, &sync_skeleton_ready, &sync_skeleton_done]()
+    {
+        EXPECT_EQ(1, sync_skeleton_ready.wait_for_signal_ready_for(std::chrono::milliseconds{15000}));
+
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+
+        std::thread worker([bus]()
+        {
+            bus->run();
+        });
+
+        remote::stub::Configuration conf
+        {
+            core::dbus::Service::use_service(
+                bus,
+                RemoteProvider::stub_remote_provider_service_name)->object_for_path(
+                    core::dbus::types::ObjectPath{RemoteProvider::stub_remote_provider_path}),
+            remote::stub::Configuration::SharedMemory{}
+        };
+
+        auto provider = remote::stub::create_with_configuration(conf);
+
+        for (unsigned int i = 1; i <= update_count; i++)
+        {
+            provider->on_reference_location_updated(cul::Update<cul::Position>
+            {
+                cul::Position
+                {
+                    cul::wgs84::Latitude{static_cast<double>(i) * cul::units::Degrees},
+                    cul::wgs84::Longitude{3* cul::units::Degrees}
+                }
+            });
+        }
+
+        // Keep the stub around until the skeleton has seen the final value.
+        EXPECT_EQ(1, sync_skeleton_done.wait_for_signal_ready_for(std::chrono::milliseconds{15000}));
+
+        bus->stop();
+
+        if (worker.joinable())
+            worker.join();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure :
+                                               core::posix::exit::Status::success;
+    };
+
+    EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(skeleton, stub));
+}
+
+TEST_F(RemoteProvider, stub_restores_its_state_once_a_killed_remote_end_restarts)
+{
+    using namespace ::testing;
+
+    core::testing::CrossProcessSync sync_first_skeleton_ready;
+    core::testing::CrossProcessSync sync_stub_configured;
+    core::testing::CrossProcessSync sync_stub_saw_remote_end_vanish;
+    core::testing::CrossProcessSync sync_state_restored;
+
+    static const std::chrono::milliseconds update_interval{1000};
+
+    static const cul::Update<cul::Position> reference
+    {
+        cul::Position
+        {
+            cul::wgs84::Latitude{9* cul::units::Degrees},
+            cul::wgs84::Longitude{3* cul::units::Degrees}
+        }
+    };
+
+    // Exposes provider on the bus until the process is killed or done returns true.
+    auto serve = [this](const cul::Provider::Ptr& provider, const std::function<bool()>& done)
+    {
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+
+        std::thread worker([bus]()
+        {
+            bus->run();
+        });
+
+        auto object = dbus::Service::add_service(
+                    bus,
+                    RemoteProvider::stub_remote_provider_service_name)
+                        ->add_object_for_path(
+                            dbus::types::ObjectPath{RemoteProvider::stub_remote_provider_path});
+
+        auto skeleton = remote::skeleton::create_with_configuration(remote::skeleton::Configuration
+        {
+            object,
+            bus,
+            provider,
+            remote::skeleton::Configuration::Batching{}
+        });
+
+        auto result = done();
+
+        skeleton.reset();
+        bus->stop();
+
+        if (worker.joinable())
+            worker.join();
+
+        return result;
+    };
+
+    auto skeletons = [&]()
+    {
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        // The first instance runs until it is killed.
+        auto first = core::posix::fork([&]()
+        {
+            serve(std::make_shared<NiceMock<MockProvider>>(), [&]()
+            {
+                sync_first_skeleton_ready.try_signal_ready_for(std::chrono::milliseconds{500});
+
+                while (true)
+                    std::this_thread::sleep_for(std::chrono::seconds{1});
+
+                return false;
+            });
+
+            return core::posix::exit::Status::failure;
+        }, core::posix::StandardStream::empty);
+
+        EXPECT_EQ(1, sync_stub_configured.wait_for_signal_ready_for(std::chrono::milliseconds{15000}));
+
+        first.send_signal_or_throw(core::posix::Signal::sig_kill);
+        first.wait_for(core::posix::wait::Flags::untraced);
+
+        EXPECT_EQ(1, sync_stub_saw_remote_end_vanish.wait_for_signal_ready_for(std::chrono::milliseconds{15000}));
+
+        // The second instance expects the stub to restore what it had asked the first one for.
+        auto second = core::posix::fork([&]()
+        {
+            auto provider = std::make_shared<NiceMock<IntervalRecordingProvider>>();
+
+            bool started{false};
+            bool referenced{false};
+
+            EXPECT_CALL(*provider, start_position_updates()).Times(1).WillOnce(Invoke([&]()
+            {
+                std::lock_guard<std::mutex> lg(provider->guard);
+                started = true;
+                provider->changed.notify_all();
+            }));
+
+            EXPECT_CALL(*provider, on_reference_location_updated(PositionUpdatesAreEqualExceptForTiming(reference.value)))
+                    .Times(1).WillOnce(Invoke([&](const cul::Update<cul::Position>&)
+            {
+                std::lock_guard<std::mutex> lg(provider->guard);
+                referenced = true;
+                provider->changed.notify_all();
+            }));
+
+            auto restored = serve(provider, [&]()
+            {
+                std::unique_lock<std::mutex> ul(provider->guard);
+                return provider->changed.wait_for(ul, std::chrono::seconds{15}, [&]()
+                {
+                    return started && referenced && provider->update_interval == cul::Optional<std::chrono::milliseconds>{update_interval};
+                });
+            });
+
+            EXPECT_TRUE(restored);
+            sync_state_restored.try_signal_ready_for(std::chrono::milliseconds{500});
+
+            return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure :
+                                                   core::posix::exit::Status::success;
+        }, core::posix::StandardStream::empty);
+
+        EXPECT_TRUE(did_finish_successfully(second.wait_for(core::posix::wait::Flags::untraced)));
+
+        trap->run();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure :
+                                               core::posix::exit::Status::success;
+    };
+
+    auto stub = [&]()
+    {
+        EXPECT_EQ(1, sync_first_skeleton_ready.wait_for_signal_ready_for(std::chrono::milliseconds{15000}));
+
+        cul::ProviderFactory::Configuration config;
+        config.put(remote::Provider::Stub::key_bus, "session");
+        config.put(remote::Provider::Stub::key_name, RemoteProvider::stub_remote_provider_service_name);
+        config.put(remote::Provider::Stub::key_path, RemoteProvider::stub_remote_provider_path);
+
+        auto provider = remote::Provider::Stub::create_instance(config);
+
+        provider->state_controller()->start_position_updates();
+        provider->state_controller()->request_update_interval(update_interval);
+
+        sync_stub_configured.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        auto becomes = [&provider](bool available)
+        {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+            while (provider->available().get() != available && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+            return provider->available().get() == available;
+        };
+
+        EXPECT_TRUE(becomes(false));
+
+        // Reference state arriving in the meantime is forwarded once the remote end is back.
+        provider->on_reference_location_updated(reference);
+
+        sync_stub_saw_remote_end_vanish.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        EXPECT_TRUE(becomes(true));
+        EXPECT_EQ(1, sync_state_restored.wait_for_signal_ready_for(std::chrono::milliseconds{15000}));
+
+        provider->state_controller()->stop_position_updates();
+
+        return ::testing::Test::HasFailure() ? core::posix::exit::Status::failure :
+                                               core::posix::exit::Status::success;
+    };
+
+    EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(skeletons, stub));
+}
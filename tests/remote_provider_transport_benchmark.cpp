@@ -0,0 +1,251 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <com/ubuntu/location/provider.h>
+
+#include <com/ubuntu/location/providers/remote/skeleton.h>
+#include <com/ubuntu/location/providers/remote/stub.h>
+
+#include "mock_provider.h"
+
+#include <core/dbus/fixture.h>
+#include <core/dbus/service.h>
+#include <core/dbus/asio/executor.h>
+
+#include <boost/accumulators/accumulators.hpp>
+#include <boost/accumulators/statistics/max.hpp>
+#include <boost/accumulators/statistics/mean.hpp>
+#include <boost/accumulators/statistics/stats.hpp>
+#include <boost/accumulators/statistics/variance.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <thread>
+
+#include <sys/resource.h>
+
+namespace cul = com::ubuntu::location;
+namespace dbus = core::dbus;
+namespace remote = com::ubuntu::location::providers::remote;
+
+namespace
+{
+typedef boost::accumulators::accumulator_set<
+    double,
+    boost::accumulators::stats<
+        boost::accumulators::tag::mean,
+        boost::accumulators::tag::variance,
+        boost::accumulators::tag::max
+    >
+> Statistics;
+
+// Consumed CPU time of the calling process, in user and kernel space.
+std::chrono::microseconds cpu_time()
+{
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+
+    return std::chrono::seconds{usage.ru_utime.tv_sec + usage.ru_stime.tv_sec} +
+           std::chrono::microseconds{usage.ru_utime.tv_usec + usage.ru_stime.tv_usec};
+}
+
+// Encodes a sequence number into a valid position, such that samples can be matched up on receipt.
+cul::Position position_for_sequence_number(std::size_t i)
+{
+    return cul::Position
+    {
+        cul::wgs84::Latitude{static_cast<double>((i / 180) % 90) * cul::units::Degrees},
+        cul::wgs84::Longitude{static_cast<double>(i % 180) * cul::units::Degrees}
+    };
+}
+
+std::size_t sequence_number_for_position(const cul::Position& position)
+{
+    return static_cast<std::size_t>(position.latitude.value.value()) * 180 +
+           static_cast<std::size_t>(position.longitude.value.value());
+}
+
+struct RemoteProviderTransport : public core::dbus::testing::Fixture
+{
+    static constexpr const char* service_name
+    {
+        "does.not.exist.remote.TransportBenchmark"
+    };
+
+    static constexpr const char* path
+    {
+        "/com/ubuntu/remote/TransportBenchmark"
+    };
+
+    dbus::Bus::Ptr make_bus()
+    {
+        auto bus = session_bus();
+        bus->install_executor(dbus::asio::make_executor(bus));
+        workers.emplace_back([bus]() { bus->run(); });
+        buses.push_back(bus);
+        return bus;
+    }
+
+    void TearDown()
+    {
+        for (auto bus : buses)
+            bus->stop();
+
+        for (auto& worker : workers)
+            if (worker.joinable())
+                worker.join();
+    }
+
+    // Runs provider and stub within this process, each with its own connection to the bus,
+    // and measures the latency between injecting a sample into the provider and receiving it
+    // via the stub, together with the CPU time consumed in this process for doing so. The
+    // bus daemon's share of the CPU time is not accounted for.
+    void run(std::size_t shared_memory_capacity, unsigned int frequency, std::size_t samples)
+    {
+        auto skeleton_bus = make_bus();
+        auto object = dbus::Service::add_service(skeleton_bus, service_name)->add_object_for_path(dbus::types::ObjectPath{path});
+
+        auto mock_provider = std::make_shared<::testing::NiceMock<MockProvider>>();
+
+        auto skeleton = remote::skeleton::create_with_configuration(remote::skeleton::Configuration
+        {
+            object,
+            skeleton_bus,
+            mock_provider,
+            remote::skeleton::Configuration::Batching{}
+        });
+
+        auto stub_bus = make_bus();
+
+        remote::stub::Configuration config
+        {
+            dbus::Service::use_service(stub_bus, service_name)->object_for_path(dbus::types::ObjectPath{path}),
+            remote::stub::Configuration::SharedMemory{}
+        };
+        config.shared_memory.capacity = shared_memory_capacity;
+
+        auto stub = remote::stub::create_with_configuration(config);
+
+        std::vector<cul::Clock::Timestamp> sent_at(samples);
+
+        std::mutex guard;
+        std::condition_variable cv;
+        std::size_t received{0};
+        Statistics latencies;
+
+        auto on_position = [&](const cul::Update<cul::Position>& update)
+        {
+            auto now = cul::Clock::now();
+            auto i = sequence_number_for_position(update.value);
+
+            std::lock_guard<std::mutex> lg(guard);
+
+            if (i < samples)
+                latencies(std::chrono::duration_cast<std::chrono::microseconds>(now - sent_at[i]).count());
+
+            received++;
+            cv.notify_all();
+        };
+
+        // Samples that queued up in the shared memory ring are delivered as a batch.
+        core::ScopedConnection sc1
+        {
+            stub->updates().position.connect(on_position)
+        };
+
+        core::ScopedConnection sc2
+        {
+            stub->updates().position_batch.connect([&](const std::vector<cul::Update<cul::Position>>& batch)
+            {
+                for (const auto& update : batch)
+                    on_position(update);
+            })
+        };
+
+        auto period = std::chrono::microseconds{1000 * 1000 / frequency};
+        auto cpu_before = cpu_time();
+
+        for (std::size_t i = 0; i < samples; i++)
+        {
+            {
+                std::lock_guard<std::mutex> lg(guard);
+                sent_at[i] = cul::Clock::now();
+            }
+
+            mock_provider->inject_update(cul::Update<cul::Position>{position_for_sequence_number(i)});
+            std::this_thread::sleep_for(period);
+        }
+
+        {
+            std::unique_lock<std::mutex> ul(guard);
+            EXPECT_TRUE(cv.wait_for(ul, std::chrono::seconds{5}, [&]() { return received >= samples; }));
+        }
+
+        auto cpu = cpu_time() - cpu_before;
+
+        using boost::accumulators::mean;
+        using boost::accumulators::variance;
+        using boost::accumulators::max;
+
+        std::cout << (shared_memory_capacity > 0 ? "shared memory" : "bus") << " @ " << frequency << " Hz: "
+                  << "received " << received << "/" << samples << ", "
+                  << "mean latency [us]: " << mean(latencies) << ", "
+                  << "latency variance [us^2]: " << variance(latencies) << ", "
+                  << "max latency [us]: " << max(latencies) << ", "
+                  << "CPU time per sample [us]: " << cpu.count() / static_cast<double>(samples)
+                  << std::endl;
+    }
+
+    std::vector<dbus::Bus::Ptr> buses;
+    std::vector<std::thread> workers;
+};
+
+constexpr const char* RemoteProviderTransport::service_name;
+constexpr const char* RemoteProviderTransport::path;
+}
+
+// The benchmarks take a while and are thus excluded from the default test run.
+TEST_F(RemoteProviderTransport, bus_at_1_hz_benchmark_requires_manual_run)
+{
+    run(0, 1, 10);
+}
+
+TEST_F(RemoteProviderTransport, shared_memory_at_1_hz_benchmark_requires_manual_run)
+{
+    run(256, 1, 10);
+}
+
+TEST_F(RemoteProviderTransport, bus_at_10_hz_benchmark_requires_manual_run)
+{
+    run(0, 10, 100);
+}
+
+TEST_F(RemoteProviderTransport, shared_memory_at_10_hz_benchmark_requires_manual_run)
+{
+    run(256, 10, 100);
+}
+
+TEST_F(RemoteProviderTransport, bus_at_100_hz_benchmark_requires_manual_run)
+{
+    run(0, 100, 1000);
+}
+
+TEST_F(RemoteProviderTransport, shared_memory_at_100_hz_benchmark_requires_manual_run)
+{
+    run(256, 100, 1000);
+}
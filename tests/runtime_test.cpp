@@ -19,8 +19,10 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <condition_variable>
 #include <thread>
+#include <vector>
 
 namespace culs = com::ubuntu::location::service;
 
@@ -116,3 +118,99 @@ TEST(Runtime, sets_up_pool_of_threads)
     auto result = state->wc.wait_for(ul, std::chrono::seconds{1}, [state]() { return state->signaled; });
     EXPECT_TRUE(result);
 }
+
+TEST(Runtime, shared_instance_is_started_and_unique)
+{
+    std::mutex m;
+    std::unique_lock<std::mutex> ul{m};
+    std::condition_variable wc;
+
+    bool signaled = false;
+
+    auto rt = culs::Runtime::shared();
+    EXPECT_EQ(rt, culs::Runtime::shared());
+
+    boost::asio::steady_timer timer{rt->service(), std::chrono::milliseconds{100}};
+    timer.async_wait([&m, &wc, &signaled](const boost::system::error_code&)
+    {
+        std::lock_guard<std::mutex> lg{m};
+        signaled = true;
+        wc.notify_all();
+    });
+
+    auto result = wc.wait_for(ul, std::chrono::seconds{1}, [&signaled]() { return signaled; });
+    EXPECT_TRUE(result);
+}
+
+TEST(Timer, executes_task_once_due)
+{
+    std::mutex m;
+    std::condition_variable wc;
+    unsigned int executed = 0;
+
+    culs::Timer timer;
+    auto then = std::chrono::steady_clock::now();
+    timer.schedule(std::chrono::milliseconds{100}, [&m, &wc, &executed]()
+    {
+        std::lock_guard<std::mutex> lg{m};
+        executed++;
+        wc.notify_all();
+    });
+
+    std::unique_lock<std::mutex> ul{m};
+    EXPECT_TRUE(wc.wait_for(ul, std::chrono::seconds{1}, [&executed]() { return executed > 0; }));
+    EXPECT_GE(std::chrono::steady_clock::now() - then, std::chrono::milliseconds{100});
+    EXPECT_EQ(1u, executed);
+}
+
+TEST(Timer, scheduling_replaces_the_pending_task)
+{
+    std::mutex m;
+    std::condition_variable wc;
+    std::vector<int> executed;
+
+    culs::Timer timer;
+    timer.schedule(std::chrono::milliseconds{50}, [&m, &wc, &executed]()
+    {
+        std::lock_guard<std::mutex> lg{m};
+        executed.push_back(1);
+        wc.notify_all();
+    });
+    timer.schedule(std::chrono::milliseconds{100}, [&m, &wc, &executed]()
+    {
+        std::lock_guard<std::mutex> lg{m};
+        executed.push_back(2);
+        wc.notify_all();
+    });
+
+    std::unique_lock<std::mutex> ul{m};
+    EXPECT_TRUE(wc.wait_for(ul, std::chrono::seconds{1}, [&executed]() { return not executed.empty(); }));
+    // Gives a task that should not run the chance to run anyway.
+    wc.wait_for(ul, std::chrono::milliseconds{200});
+    EXPECT_EQ(std::vector<int>{2}, executed);
+}
+
+TEST(Timer, stopping_waits_for_the_running_task_and_drops_further_tasks)
+{
+    std::atomic<bool> running{false};
+    std::atomic<bool> finished{false};
+    std::atomic<bool> rescheduled{false};
+
+    culs::Timer timer;
+    timer.schedule(std::chrono::milliseconds{0}, [&running, &finished]()
+    {
+        running = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds{200});
+        finished = true;
+    });
+
+    while (not running)
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+    timer.stop();
+    EXPECT_TRUE(finished.load());
+
+    timer.schedule(std::chrono::milliseconds{0}, [&rescheduled]() { rescheduled = true; });
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    EXPECT_FALSE(rescheduled.load());
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <com/ubuntu/location/providers/remote/shared_memory_ring.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <unistd.h>
+
+namespace location = com::ubuntu::location;
+namespace remote = com::ubuntu::location::providers::remote;
+
+namespace
+{
+location::Update<location::Position> position_at(double lat, double lon)
+{
+    return location::Update<location::Position>
+    {
+        location::Position
+        {
+            location::wgs84::Latitude{lat * location::units::Degrees},
+            location::wgs84::Longitude{lon * location::units::Degrees},
+            location::wgs84::Altitude{42. * location::units::Meters},
+            location::Position::Accuracy::Horizontal{10. * location::units::Meters}
+        },
+        location::Clock::now()
+    };
+}
+}
+
+TEST(SharedMemoryRing, capacity_is_rounded_up_to_power_of_two)
+{
+    EXPECT_EQ(8u, remote::SharedMemoryRing::create(5)->capacity());
+    EXPECT_EQ(1u, remote::SharedMemoryRing::create(0)->capacity());
+}
+
+TEST(SharedMemoryRing, updates_survive_encoding_round_trip)
+{
+    auto position = position_at(51., 7.);
+    auto decoded = remote::SharedMemoryRing::decode_position(remote::SharedMemoryRing::encode(position));
+
+    EXPECT_EQ(position, decoded);
+    EXPECT_FALSE(decoded.value.accuracy.vertical);
+
+    location::Update<location::Heading> heading{120. * location::units::Degrees};
+    EXPECT_EQ(heading, remote::SharedMemoryRing::decode_heading(remote::SharedMemoryRing::encode(heading)));
+
+    location::Update<location::Velocity> velocity{5. * location::units::MetersPerSecond};
+    EXPECT_EQ(velocity, remote::SharedMemoryRing::decode_velocity(remote::SharedMemoryRing::encode(velocity)));
+}
+
+TEST(SharedMemoryRing, full_ring_drops_and_counts_new_records)
+{
+    auto ring = remote::SharedMemoryRing::create(2);
+
+    EXPECT_TRUE(ring->push(remote::SharedMemoryRing::encode(position_at(1., 1.))));
+    EXPECT_TRUE(ring->push(remote::SharedMemoryRing::encode(position_at(2., 2.))));
+    EXPECT_FALSE(ring->push(remote::SharedMemoryRing::encode(position_at(3., 3.))));
+    EXPECT_EQ(1u, ring->dropped());
+
+    remote::SharedMemoryRing::Record record;
+    EXPECT_TRUE(ring->pop(record));
+    EXPECT_DOUBLE_EQ(1., remote::SharedMemoryRing::decode_position(record).value.latitude.value.value());
+    EXPECT_TRUE(ring->pop(record));
+    EXPECT_DOUBLE_EQ(2., remote::SharedMemoryRing::decode_position(record).value.latitude.value.value());
+    EXPECT_FALSE(ring->pop(record));
+}
+
+TEST(SharedMemoryRing, attached_ring_sees_records_in_order)
+{
+    static const unsigned int count{10000};
+
+    auto producer = remote::SharedMemoryRing::create(16);
+    auto consumer = remote::SharedMemoryRing::attach(::dup(producer->fd()));
+
+    EXPECT_EQ(producer->capacity(), consumer->capacity());
+
+    std::thread worker{[producer]()
+    {
+        for (unsigned int i = 0; i < count; i++)
+            while (not producer->push(remote::SharedMemoryRing::encode(position_at(0., i % 180))))
+                std::this_thread::yield();
+    }};
+
+    remote::SharedMemoryRing::Record record;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        while (not consumer->pop(record))
+            std::this_thread::yield();
+
+        EXPECT_DOUBLE_EQ(i % 180, remote::SharedMemoryRing::decode_position(record).value.longitude.value.value());
+    }
+
+    worker.join();
+}
+
+TEST(SharedMemoryRing, attaching_to_arbitrary_fd_throws)
+{
+    int fds[2];
+    ASSERT_EQ(0, ::pipe(fds));
+    ::close(fds[1]);
+
+    EXPECT_ANY_THROW(remote::SharedMemoryRing::attach(fds[0]));
+}
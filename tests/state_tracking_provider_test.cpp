@@ -117,3 +117,100 @@ TEST(StateTrackingProviderTest, stop_switches_to_enabled)
     stp.stop_position_updates();
     EXPECT_EQ(cul::StateTrackingProvider::State::enabled, stp.state());
 }
+
+TEST(StateTrackingProviderTest, stays_active_while_other_updates_are_running)
+{
+    using namespace ::testing;
+    cul::StateTrackingProvider stp{std::make_shared<NiceMock<MockProvider>>()};
+    stp.start_position_updates();
+    stp.start_heading_updates();
+    stp.stop_position_updates();
+    EXPECT_EQ(cul::StateTrackingProvider::State::active, stp.state());
+    stp.stop_heading_updates();
+    EXPECT_EQ(cul::StateTrackingProvider::State::enabled, stp.state());
+}
+
+TEST(StateTrackingProviderTest, stop_within_linger_period_is_cancelled_by_start)
+{
+    using namespace ::testing;
+
+    auto impl = std::make_shared<NiceMock<MockProvider>>();
+    EXPECT_CALL(*impl, start_position_updates()).Times(1);
+    EXPECT_CALL(*impl, stop_position_updates()).Times(0);
+
+    cul::StateTrackingProvider stp{impl};
+    stp.set_linger_period(std::chrono::seconds{10});
+
+    stp.state_controller()->start_position_updates();
+    stp.state_controller()->stop_position_updates();
+    EXPECT_EQ(cul::StateTrackingProvider::State::active, stp.state());
+    stp.state_controller()->start_position_updates();
+
+    auto stats = stp.statistics();
+    EXPECT_EQ(1u, stats.starts);
+    EXPECT_EQ(0u, stats.stops);
+    EXPECT_EQ(1u, stats.cancelled_stops);
+}
+
+TEST(StateTrackingProviderTest, stop_is_carried_out_after_linger_period)
+{
+    using namespace ::testing;
+
+    auto impl = std::make_shared<NiceMock<MockProvider>>();
+    EXPECT_CALL(*impl, stop_position_updates()).Times(1);
+
+    cul::StateTrackingProvider stp{impl};
+    stp.set_linger_period(std::chrono::milliseconds{50});
+
+    stp.state_controller()->start_position_updates();
+    stp.state_controller()->stop_position_updates();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{500});
+
+    EXPECT_TRUE(Mock::VerifyAndClearExpectations(impl.get()));
+    EXPECT_EQ(cul::StateTrackingProvider::State::enabled, stp.state());
+    EXPECT_EQ(1u, stp.statistics().stops);
+}
+
+TEST(StateTrackingProviderTest, disabling_stops_immediately_despite_linger_period)
+{
+    using namespace ::testing;
+
+    auto impl = std::make_shared<NiceMock<MockProvider>>();
+    EXPECT_CALL(*impl, stop_position_updates()).Times(1);
+    EXPECT_CALL(*impl, stop_heading_updates()).Times(1);
+
+    cul::StateTrackingProvider stp{impl};
+    stp.set_linger_period(std::chrono::seconds{10});
+
+    stp.state_controller()->start_position_updates();
+    stp.state_controller()->start_heading_updates();
+    // Heading updates linger, and are taken down when disabling.
+    stp.state_controller()->stop_heading_updates();
+    stp.state_controller()->disable();
+
+    EXPECT_TRUE(Mock::VerifyAndClearExpectations(impl.get()));
+}
+
+TEST(StateTrackingProviderTest, time_to_first_fix_is_measured_from_start_to_first_position_update)
+{
+    using namespace ::testing;
+
+    auto impl = std::make_shared<NiceMock<MockProvider>>();
+
+    cul::StateTrackingProvider stp{impl};
+    stp.state_controller()->start_position_updates();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    impl->inject_update(reference_position_update);
+    // Only the first update counts.
+    impl->inject_update(reference_position_update);
+
+    auto stats = stp.statistics();
+    EXPECT_EQ(1u, stats.first_fixes);
+    EXPECT_GE(stats.last_time_to_first_fix, std::chrono::milliseconds{20});
+    EXPECT_EQ(stats.last_time_to_first_fix, stats.total_time_to_first_fix);
+    // With a single sample, all percentiles are equal to it.
+    EXPECT_EQ(stats.last_time_to_first_fix, stats.time_to_first_fix_p50);
+    EXPECT_EQ(stats.last_time_to_first_fix, stats.time_to_first_fix_p99);
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <com/ubuntu/location/service/session/update_encoder.h>
+
+#include <com/ubuntu/location/service/session/interface_p.h>
+
+#include <dbus/dbus.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace location = com::ubuntu::location;
+namespace culss = com::ubuntu::location::service::session;
+
+namespace
+{
+location::Update<location::Position> position_at(double lat, double lon)
+{
+    return location::Update<location::Position>
+    {
+        location::Position
+        {
+            location::wgs84::Latitude{lat * location::units::Degrees},
+            location::wgs84::Longitude{lon * location::units::Degrees},
+            location::wgs84::Altitude{42. * location::units::Meters},
+            10. * location::units::Meters
+        }
+    };
+}
+
+struct Session
+{
+    std::string name;
+    core::dbus::types::ObjectPath path;
+};
+
+std::vector<Session> sessions(std::size_t n)
+{
+    std::vector<Session> result;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        std::stringstream name; name << ":1." << i;
+        std::stringstream path; path << "/sessions/" << i;
+        result.push_back(Session{name.str(), core::dbus::types::ObjectPath{path.str()}});
+    }
+    return result;
+}
+}
+
+TEST(UpdateEncoder, encodes_an_update_only_once_for_all_sessions)
+{
+    culss::UpdateEncoder encoder;
+
+    auto update = position_at(9., 53.);
+    for (const auto& session : sessions(10))
+        encoder.message_for(update, session.name, session.path);
+
+    EXPECT_EQ(1u, encoder.statistics().encoded);
+    EXPECT_EQ(9u, encoder.statistics().reused);
+
+    encoder.message_for(position_at(10., 53.), ":1.0", core::dbus::types::ObjectPath{"/sessions/0"});
+    EXPECT_EQ(2u, encoder.statistics().encoded);
+}
+
+TEST(UpdateEncoder, messages_are_addressed_to_sessions_and_do_not_expect_a_reply)
+{
+    culss::UpdateEncoder encoder;
+
+    auto update = position_at(9., 53.);
+    for (const auto& session : sessions(3))
+    {
+        auto msg = encoder.message_for(update, session.name, session.path);
+
+        EXPECT_EQ(session.name, msg->destination());
+        EXPECT_EQ(session.path, msg->path());
+        EXPECT_EQ(culss::Interface::UpdatePosition::name(), msg->member());
+        EXPECT_TRUE(dbus_message_get_no_reply(msg->get()));
+
+        location::Update<location::Position> decoded; msg->reader() >> decoded;
+        EXPECT_EQ(update, decoded);
+    }
+}
+
+// Compares encoding an update per session, i.e., the way updates have been sent out
+// before, with encoding it once and copying the payload for 1, 10 and 100 sessions.
+TEST(UpdateEncoder, encoding_per_session_vs_encoding_once_benchmark_requires_manual_run)
+{
+    static constexpr std::size_t fixes{1000};
+
+    for (std::size_t n : {1, 10, 100})
+    {
+        auto s = sessions(n);
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t fix = 0; fix < fixes; fix++)
+        {
+            auto update = position_at(9., fix * 1e-5);
+            for (const auto& session : s)
+            {
+                auto msg = core::dbus::Message::make_method_call(
+                            session.name,
+                            session.path,
+                            core::dbus::traits::Service<culss::Interface>::interface_name(),
+                            culss::Interface::UpdatePosition::name());
+                msg->writer() << update;
+            }
+        }
+        auto per_session = std::chrono::steady_clock::now() - start;
+
+        culss::UpdateEncoder encoder;
+
+        start = std::chrono::steady_clock::now();
+        for (std::size_t fix = 0; fix < fixes; fix++)
+        {
+            auto update = position_at(9., fix * 1e-5);
+            for (const auto& session : s)
+                encoder.message_for(update, session.name, session.path);
+        }
+        auto once = std::chrono::steady_clock::now() - start;
+
+        EXPECT_EQ(fixes, encoder.statistics().encoded);
+
+        std::cout << n << " session(s), " << fixes << " fixes: "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(per_session).count() / fixes << " [us/fix] encoding per session vs. "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(once).count() / fixes << " [us/fix] encoding once" << std::endl;
+    }
+}
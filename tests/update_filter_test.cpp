@@ -0,0 +1,210 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <com/ubuntu/location/service/session/update_filter.h>
+
+#include <gtest/gtest.h>
+
+namespace location = com::ubuntu::location;
+
+namespace
+{
+location::Update<location::Position> position_at(double lat, double lon)
+{
+    return location::Update<location::Position>
+    {
+        location::Position
+        {
+            location::wgs84::Latitude{lat * location::units::Degrees},
+            location::wgs84::Longitude{lon * location::units::Degrees}
+        }
+    };
+}
+}
+
+TEST(UpdateFilter, unconfigured_filter_accepts_all_updates)
+{
+    location::service::session::UpdateFilter filter;
+    auto now = location::Clock::now();
+
+    EXPECT_TRUE(filter.accept(position_at(9., 53.), now));
+    EXPECT_TRUE(filter.accept(position_at(9., 53.), now));
+    EXPECT_TRUE(filter.accept(location::Update<location::Heading>{}, now));
+    EXPECT_TRUE(filter.accept(location::Update<location::Heading>{}, now));
+    EXPECT_TRUE(filter.accept(location::Update<location::Velocity>{}, now));
+    EXPECT_TRUE(filter.accept(location::Update<location::Velocity>{}, now));
+}
+
+TEST(UpdateFilter, updates_within_interval_are_dropped)
+{
+    location::Criteria::Updates criteria;
+    criteria.interval = std::chrono::milliseconds{1000};
+
+    location::service::session::UpdateFilter filter;
+    filter.configure(criteria);
+
+    auto now = location::Clock::now();
+
+    EXPECT_TRUE(filter.accept(position_at(9., 53.), now));
+    EXPECT_FALSE(filter.accept(position_at(9., 53.), now + std::chrono::milliseconds{500}));
+    EXPECT_FALSE(filter.accept(position_at(9., 53.), now + std::chrono::milliseconds{999}));
+    EXPECT_TRUE(filter.accept(position_at(9., 53.), now + std::chrono::milliseconds{1000}));
+
+    EXPECT_TRUE(filter.accept(location::Update<location::Heading>{}, now));
+    EXPECT_FALSE(filter.accept(location::Update<location::Heading>{}, now + std::chrono::milliseconds{500}));
+    EXPECT_TRUE(filter.accept(location::Update<location::Heading>{}, now + std::chrono::milliseconds{1500}));
+}
+
+TEST(UpdateFilter, position_updates_below_displacement_are_dropped)
+{
+    location::Criteria::Updates criteria;
+    criteria.displacement = 100. * location::units::Meters;
+
+    location::service::session::UpdateFilter filter;
+    filter.configure(criteria);
+
+    auto now = location::Clock::now();
+
+    EXPECT_TRUE(filter.accept(position_at(9., 53.), now));
+    // Roughly 11m to the north.
+    EXPECT_FALSE(filter.accept(position_at(9.0001, 53.), now));
+    // Roughly 1.1km to the north.
+    EXPECT_TRUE(filter.accept(position_at(9.01, 53.), now));
+    // Velocity updates are not subject to the displacement filter.
+    EXPECT_TRUE(filter.accept(location::Update<location::Velocity>{}, now));
+}
+
+TEST(UpdateFilter, reconfiguring_the_filter_takes_effect_immediately)
+{
+    location::Criteria::Updates criteria;
+    criteria.interval = std::chrono::milliseconds{1000};
+
+    location::service::session::UpdateFilter filter;
+    filter.configure(criteria);
+
+    auto now = location::Clock::now();
+
+    EXPECT_TRUE(filter.accept(position_at(9., 53.), now));
+    EXPECT_FALSE(filter.accept(position_at(9., 53.), now));
+
+    filter.configure(location::Criteria::Updates{});
+    EXPECT_TRUE(filter.accept(position_at(9., 53.), now));
+}
+
+TEST(UpdateFilter, latest_update_of_a_burst_is_flushed_once_the_interval_elapsed)
+{
+    location::Criteria::Updates criteria;
+    criteria.interval = std::chrono::milliseconds{1000};
+
+    location::service::session::UpdateFilter filter;
+    filter.configure(criteria);
+
+    auto now = location::Clock::now();
+
+    EXPECT_TRUE(filter.accept(position_at(9., 53.), now));
+    EXPECT_FALSE(filter.next_flush());
+
+    // A burst within the interval, followed by silence.
+    EXPECT_FALSE(filter.accept(position_at(9.1, 53.), now + std::chrono::milliseconds{100}));
+    EXPECT_FALSE(filter.accept(position_at(9.2, 53.), now + std::chrono::milliseconds{200}));
+    EXPECT_FALSE(filter.accept(position_at(9.3, 53.), now + std::chrono::milliseconds{300}));
+
+    ASSERT_TRUE(filter.next_flush().is_initialized());
+    EXPECT_EQ(now + std::chrono::milliseconds{1000}, *filter.next_flush());
+
+    // Nothing is due before the interval elapsed.
+    EXPECT_FALSE(filter.flush(now + std::chrono::milliseconds{999}).position);
+
+    auto pending = filter.flush(now + std::chrono::milliseconds{1000});
+    ASSERT_TRUE(pending.position.is_initialized());
+    EXPECT_EQ(position_at(9.3, 53.).value, pending.position->value);
+    EXPECT_FALSE(filter.next_flush());
+
+    // The flushed update starts a new interval.
+    EXPECT_FALSE(filter.accept(position_at(9.4, 53.), now + std::chrono::milliseconds{1500}));
+    EXPECT_TRUE(filter.accept(position_at(9.5, 53.), now + std::chrono::milliseconds{2000}));
+    // The update delivered right away supersedes the one held back.
+    EXPECT_FALSE(filter.next_flush());
+}
+
+TEST(UpdateFilter, held_back_heading_and_velocity_updates_are_flushed_once_the_interval_elapsed)
+{
+    location::Criteria::Updates criteria;
+    criteria.interval = std::chrono::milliseconds{1000};
+
+    location::service::session::UpdateFilter filter;
+    filter.configure(criteria);
+
+    auto now = location::Clock::now();
+
+    location::Update<location::Heading> heading{90. * location::units::Degrees, now};
+    location::Update<location::Velocity> velocity{5. * location::units::MetersPerSecond, now};
+
+    EXPECT_TRUE(filter.accept(location::Update<location::Heading>{}, now));
+    EXPECT_TRUE(filter.accept(location::Update<location::Velocity>{}, now + std::chrono::milliseconds{500}));
+    EXPECT_FALSE(filter.accept(heading, now + std::chrono::milliseconds{600}));
+    EXPECT_FALSE(filter.accept(velocity, now + std::chrono::milliseconds{700}));
+
+    ASSERT_TRUE(filter.next_flush().is_initialized());
+    EXPECT_EQ(now + std::chrono::milliseconds{1000}, *filter.next_flush());
+
+    auto pending = filter.flush(now + std::chrono::milliseconds{1000});
+    ASSERT_TRUE(pending.heading.is_initialized());
+    EXPECT_EQ(heading, *pending.heading);
+    EXPECT_FALSE(pending.velocity);
+
+    pending = filter.flush(now + std::chrono::milliseconds{1500});
+    ASSERT_TRUE(pending.velocity.is_initialized());
+    EXPECT_EQ(velocity, *pending.velocity);
+}
+
+TEST(UpdateFilter, held_back_position_update_below_displacement_is_not_flushed)
+{
+    location::Criteria::Updates criteria;
+    criteria.interval = std::chrono::milliseconds{1000};
+    criteria.displacement = 100. * location::units::Meters;
+
+    location::service::session::UpdateFilter filter;
+    filter.configure(criteria);
+
+    auto now = location::Clock::now();
+
+    EXPECT_TRUE(filter.accept(position_at(9., 53.), now));
+    // Roughly 11m to the north.
+    EXPECT_FALSE(filter.accept(position_at(9.0001, 53.), now + std::chrono::milliseconds{500}));
+
+    EXPECT_FALSE(filter.flush(now + std::chrono::milliseconds{1000}).position);
+    EXPECT_FALSE(filter.next_flush());
+}
+
+TEST(UpdateFilter, held_back_updates_are_due_right_away_once_the_interval_is_lifted)
+{
+    location::Criteria::Updates criteria;
+    criteria.interval = std::chrono::milliseconds{1000};
+
+    location::service::session::UpdateFilter filter;
+    filter.configure(criteria);
+
+    auto now = location::Clock::now();
+
+    EXPECT_TRUE(filter.accept(position_at(9., 53.), now));
+    EXPECT_FALSE(filter.accept(position_at(9.1, 53.), now));
+
+    filter.configure(location::Criteria::Updates{});
+
+    ASSERT_TRUE(filter.next_flush().is_initialized());
+    EXPECT_LE(*filter.next_flush(), now);
+    EXPECT_TRUE(filter.flush(now).position);
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <com/ubuntu/location/write_behind_settings.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <map>
+#include <thread>
+
+namespace location = com::ubuntu::location;
+
+namespace
+{
+// Keeps values in memory and counts the syncs it has seen.
+struct CountingSettings : public location::Settings
+{
+    void sync() override
+    {
+        syncs++;
+    }
+
+    bool has_value_for_key(const std::string& key) const override
+    {
+        return values.count(key) > 0;
+    }
+
+    std::string get_string_for_key_or_throw(const std::string& key) override
+    {
+        if (values.count(key) == 0)
+            throw location::Settings::Error::NoValueForKey{key};
+        return values.at(key);
+    }
+
+    bool set_string_for_key(const std::string& key, const std::string& value) override
+    {
+        values[key] = value;
+        return true;
+    }
+
+    std::map<std::string, std::string> values;
+    std::atomic<unsigned int> syncs{0};
+};
+
+// Blocks in the first sync until released.
+struct BlockingSettings : public CountingSettings
+{
+    void sync() override
+    {
+        if (syncs == 0)
+        {
+            entered.set_value();
+            released.get_future().wait();
+        }
+
+        CountingSettings::sync();
+    }
+
+    std::promise<void> entered;
+    std::promise<void> released;
+};
+
+// Long enough for the background worker to never kick in during a test.
+const std::chrono::milliseconds debounce{60 * 1000};
+}
+
+TEST(WriteBehindSettings, changes_within_debounce_window_are_coalesced_into_one_sync)
+{
+    auto impl = std::make_shared<CountingSettings>();
+    location::WriteBehindSettings settings{impl, debounce};
+
+    auto now = std::chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < 10; i++)
+        settings.set_string_for_key("Engine::State", i % 2 == 0 ? "on" : "off");
+
+    EXPECT_EQ(0u, impl->syncs);
+    EXPECT_EQ("off", settings.get_string_for_key_or_throw("Engine::State"));
+
+    settings.sync_if_due(now);
+    EXPECT_EQ(0u, impl->syncs);
+
+    settings.sync_if_due(now + 2 * debounce);
+
+    EXPECT_EQ(1u, impl->syncs);
+    EXPECT_EQ("off", impl->values["Engine::State"]);
+    EXPECT_EQ(10u, settings.statistics().changes);
+    EXPECT_EQ(1u, settings.statistics().syncs);
+    EXPECT_EQ(9u, settings.statistics().saved_syncs);
+}
+
+TEST(WriteBehindSettings, setting_an_unchanged_value_does_not_sync)
+{
+    auto impl = std::make_shared<CountingSettings>();
+    impl->values["Engine::State"] = "on";
+
+    {
+        location::WriteBehindSettings settings{impl, debounce};
+        settings.set_string_for_key("Engine::State", "on");
+        EXPECT_EQ(0u, settings.statistics().changes);
+        EXPECT_EQ(1u, settings.statistics().saved_syncs);
+    }
+
+    EXPECT_EQ(0u, impl->syncs);
+}
+
+TEST(WriteBehindSettings, pending_changes_are_synced_on_destruction)
+{
+    auto impl = std::make_shared<CountingSettings>();
+
+    {
+        location::WriteBehindSettings settings{impl, debounce};
+        settings.set_string_for_key("Engine::State", "off");
+        EXPECT_EQ(0u, impl->syncs);
+    }
+
+    EXPECT_EQ(1u, impl->syncs);
+    EXPECT_EQ("off", impl->values["Engine::State"]);
+}
+
+TEST(WriteBehindSettings, explicit_sync_writes_pending_changes_right_away)
+{
+    auto impl = std::make_shared<CountingSettings>();
+    location::WriteBehindSettings settings{impl, debounce};
+
+    settings.set_string_for_key("Engine::State", "off");
+    settings.sync();
+    EXPECT_EQ(1u, impl->syncs);
+
+    // Nothing is pending anymore.
+    settings.sync();
+    EXPECT_EQ(1u, impl->syncs);
+}
+
+TEST(WriteBehindSettings, changes_do_not_wait_for_a_sync_in_progress)
+{
+    auto impl = std::make_shared<BlockingSettings>();
+    location::WriteBehindSettings settings{impl, debounce};
+
+    settings.set_string_for_key("Engine::State", "off");
+
+    auto syncing = std::async(std::launch::async, [&settings]() { settings.sync(); });
+    impl->entered.get_future().wait();
+
+    // The sync is blocked on the disk, changes and reads of known values still go through.
+    auto changing = std::async(std::launch::async, [&settings]()
+    {
+        settings.set_string_for_key("Engine::State", "on");
+        return settings.get_string_for_key_or_throw("Engine::State");
+    });
+
+    ASSERT_EQ(std::future_status::ready, changing.wait_for(std::chrono::seconds{5}));
+    EXPECT_EQ("on", changing.get());
+
+    impl->released.set_value();
+    syncing.get();
+
+    EXPECT_EQ(1u, impl->syncs);
+    EXPECT_EQ("off", impl->values["Engine::State"]);
+
+    settings.sync();
+    EXPECT_EQ(2u, impl->syncs);
+    EXPECT_EQ("on", impl->values["Engine::State"]);
+}